@@ -0,0 +1,173 @@
+// Compares the nlohmann DOM path against the on-demand response parsers, with
+// and without a detected field layout, on realistic quote and candle payloads:
+// time per parse and heap allocations per parse (the DOM path allocates a map
+// node and strings for every field).
+//
+// Usage: bench_parse_responses [iterations=20000] [candles=1000]
+
+#include "market_data/pumpfun_client.h"
+#include "market_data/response_parser.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+
+using Clock = std::chrono::steady_clock;
+
+// The path fetchTokenQuote used before: full DOM, unwrapped by value.
+market_data::TokenQuote domQuote(const std::string& payload) {
+  nlohmann::json json = nlohmann::json::parse(payload);
+  if (json.contains("result")) {
+    json = json["result"];
+  }
+  if (json.contains("data") && json["data"].is_object()) {
+    json = json["data"];
+  }
+  if (json.is_array() && !json.empty()) {
+    json = json.front();
+  }
+  return market_data::PumpFunClient::parseTokenQuote(json);
+}
+
+std::vector<market_data::HistoricalCandle> domCandles(const std::string& payload) {
+  nlohmann::json json = nlohmann::json::parse(payload);
+  for (const char* wrapper : {"result", "data", "candles"}) {
+    if (json.contains(wrapper)) {
+      json = json[wrapper];
+    }
+  }
+  std::vector<market_data::HistoricalCandle> candles;
+  candles.reserve(json.size());
+  for (const auto& entry : json) {
+    market_data::HistoricalCandle candle;
+    candle.mint = "MINT";
+    candle.timeframe = "1m";
+    candle.open_time_ns =
+        market_data::PumpFunClient::timestampFromJson(entry, {"open_time", "startTime", "time"});
+    candle.close_time_ns =
+        market_data::PumpFunClient::timestampFromJson(entry, {"close_time", "closeTime", "endTime"});
+    candle.open = entry.value("open", 0.0);
+    candle.high = entry.value("high", 0.0);
+    candle.low = entry.value("low", 0.0);
+    candle.close = entry.value("close", 0.0);
+    candle.volume = entry.value("volume", entry.value("volumeUsd", 0.0));
+    candle.quote_volume = entry.value("quote_volume", entry.value("quoteVolume", 0.0));
+    candles.push_back(std::move(candle));
+  }
+  return candles;
+}
+
+// A provider quote: the fields we read plus the token details real APIs send along.
+std::string quotePayload() {
+  return R"({"result":{"data":{"mint":"7GCihgDB8fe6KNjn2MYtkzZcRjQy3t9GHdC8uHYmW2hr",)"
+         R"("name":"Launch Spike","symbol":"SPIKE","decimals":6,"priceUsd":0.00004213,)"
+         R"("priceNative":0.00000031,"priceChange24h":-12.5,"priceChange1h":3.25,)"
+         R"("volume24h":1284533.12,"volume1h":20411.5,"liquidity":84211.9,"fdv":42130.2,)"
+         R"("marketCap":42130.2,"holders":1842,"txns24h":{"buys":5231,"sells":4410},)"
+         R"("bondingCurve":{"progress":0.7312,"virtualSolReserves":41.2,"virtualTokenReserves":)"
+         R"(812341234.5,"complete":false},"creator":"9xQeWvG816bUx9EPjHmaT23yvVM2ZWbrrpZb9PusVFin",)"
+         R"("image":"https://ipfs.io/ipfs/QmYwAPJzv5CZsnA625s3Xf2nemtYgPpHdWEz79ojWnPbdG",)"
+         R"("socials":["https://x.com/spike","https://t.me/spike"],"timestamp":"2026-10-18T12:00:00Z"}}})";
+}
+
+std::string candlePayload(int count) {
+  std::string payload = R"({"result":{"candles":[)";
+  for (int i = 0; i < count; ++i) {
+    if (i > 0) {
+      payload += ',';
+    }
+    const std::string hour = (i % 24 < 10 ? "0" : "") + std::to_string(i % 24);
+    payload += R"({"startTime":"2026-10-18T)" + hour + R"(:00:00Z","closeTime":")"
+               R"(2026-10-18T)" + hour + R"(:01:00Z","open":0.0000421)" +
+               std::to_string(i % 10) + R"(,"high":0.0000433,"low":0.0000419,"close":0.0000428,)"
+               R"("volumeUsd":12841.5,"quoteVolume":301.25,"trades":)" + std::to_string(i) + "}";
+  }
+  payload += "]}}";
+  return payload;
+}
+
+template <typename Parse>
+void run(const char* label, int iterations, std::size_t payload_bytes, Parse&& parse) {
+  // Warm up caches and the allocator before measuring.
+  for (int i = 0; i < iterations / 10 + 1; ++i) {
+    parse();
+  }
+  const std::uint64_t allocations_before = allocations.load();
+  const auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    parse();
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  const double per_parse_us = seconds * 1e6 / iterations;
+  std::cout << std::left << std::setw(24) << label << std::right << std::setw(10) << per_parse_us
+            << " us/parse" << std::setw(10)
+            << static_cast<double>(payload_bytes) * iterations / seconds / (1 << 20) << " MiB/s"
+            << std::setw(10) << (allocations.load() - allocations_before) / iterations
+            << " allocs/parse\n";
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+int main(int argc, char** argv) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const int candle_count = argc > 2 ? std::atoi(argv[2]) : 1000;
+  const int candle_iterations = std::max(1, iterations / std::max(1, candle_count / 10));
+
+  const std::string quote = quotePayload();
+  const std::string candles = candlePayload(candle_count);
+
+  if (domQuote(quote).price != market_data::parseQuoteResponse(quote).price ||
+      domCandles(candles).size() !=
+          market_data::parseCandlesResponse(candles, "MINT", "1m").size()) {
+    std::cerr << "Parsers disagree on the benchmark payloads" << std::endl;
+    return 1;
+  }
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "quote payload: " << quote.size() << " bytes, " << iterations << " iterations\n";
+  run("  dom", iterations, quote.size(), [&]() { return domQuote(quote); });
+  run("  on-demand", iterations, quote.size(),
+      [&]() { return market_data::parseQuoteResponse(quote); });
+  market_data::FieldLayoutCache quote_layout;
+  run("  on-demand + layout", iterations, quote.size(),
+      [&]() { return market_data::parseQuoteResponse(quote, &quote_layout); });
+
+  std::cout << "candle payload: " << candle_count << " candles, " << candles.size() << " bytes, "
+            << candle_iterations << " iterations\n";
+  run("  dom", candle_iterations, candles.size(), [&]() { return domCandles(candles); });
+  run("  on-demand", candle_iterations, candles.size(),
+      [&]() { return market_data::parseCandlesResponse(candles, "MINT", "1m"); });
+  market_data::FieldLayoutCache candle_layout;
+  run("  on-demand + layout", candle_iterations, candles.size(), [&]() {
+    return market_data::parseCandlesResponse(candles, "MINT", "1m", &candle_layout);
+  });
+  return 0;
+}
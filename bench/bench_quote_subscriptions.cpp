@@ -0,0 +1,141 @@
+// Measures the cost of polling many Pump.fun quote subscriptions through
+// PumpFunClient's curl_multi event loop. A mock quote server runs in a forked
+// child so the reported CPU time and thread count belong to the client alone.
+//
+// Usage: bench_quote_subscriptions [subscriptions=1000] [interval_ms=1000] [seconds=10]
+
+#include "market_data/pumpfun_client.h"
+#include "testing/mock_http_server.h"
+
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int threadCount() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("Threads:", 0) == 0) {
+      return std::stoi(line.substr(8));
+    }
+  }
+  return -1;
+}
+
+double cpuSeconds() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  const auto seconds = [](const timeval& tv) { return tv.tv_sec + tv.tv_usec / 1e6; };
+  return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+[[noreturn]] void runServer(int port_pipe) {
+  testing::MockHttpServer server([](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    response.body = R"({"mint":")" + mint +
+                    R"(","price":0.0042,"priceChange24h":1.5,"volume24h":125000,"liquidity":50000})";
+    return response;
+  });
+  server.start();
+  const std::uint16_t port = server.port();
+  if (write(port_pipe, &port, sizeof(port)) != sizeof(port)) {
+    _exit(1);
+  }
+  close(port_pipe);
+  while (true) {
+    pause();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int subscriptions = argc > 1 ? std::atoi(argv[1]) : 1000;
+  const int interval_ms = argc > 2 ? std::atoi(argv[2]) : 1000;
+  const int seconds = argc > 3 ? std::atoi(argv[3]) : 10;
+
+  int fds[2];
+  if (pipe(fds) != 0) {
+    std::cerr << "pipe failed" << std::endl;
+    return 1;
+  }
+  const pid_t server_pid = fork();
+  if (server_pid == 0) {
+    close(fds[0]);
+    runServer(fds[1]);
+  }
+  close(fds[1]);
+  std::uint16_t port = 0;
+  if (server_pid < 0 || read(fds[0], &port, sizeof(port)) != sizeof(port)) {
+    std::cerr << "Failed to start mock server" << std::endl;
+    return 1;
+  }
+  close(fds[0]);
+
+  int exit_code = 0;
+  {
+    market_data::PumpFunClient client("http://127.0.0.1:" + std::to_string(port));
+    std::atomic<std::uint64_t> quotes{0};
+
+    const int threads_before = threadCount();
+    for (int i = 0; i < subscriptions; ++i) {
+      client.subscribeToQuotes(
+          "MINT" + std::to_string(i),
+          [&quotes](const market_data::TokenQuote&) { quotes.fetch_add(1, std::memory_order_relaxed); },
+          std::chrono::milliseconds(interval_ms));
+    }
+
+    // Skip the initial burst where every subscription fires at once.
+    std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    const std::uint64_t quotes_start = quotes.load();
+    const double cpu_start = cpuSeconds();
+    const auto wall_start = Clock::now();
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+    const double wall = std::chrono::duration<double>(Clock::now() - wall_start).count();
+    const double cpu = cpuSeconds() - cpu_start;
+    const std::uint64_t delivered = quotes.load() - quotes_start;
+    const int threads_during = threadCount();
+    const auto stats = client.connectionStats();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "subscriptions:          " << subscriptions << " @ " << interval_ms << " ms\n"
+              << "measured window:        " << wall << " s\n"
+              << "client threads:         " << threads_during << " (" << threads_before
+              << " before subscribing)\n"
+              << "quotes delivered:       " << delivered << " (" << delivered / wall << "/s, expected "
+              << subscriptions * 1000.0 / interval_ms << "/s)\n"
+              << "client CPU:             " << 100.0 * cpu / wall << " % of one core\n"
+              << "CPU per quote:          " << (delivered > 0 ? 1e6 * cpu / delivered : 0.0) << " us\n"
+              << "connections opened:     " << stats.new_connections << "\n"
+              << "connection reuse rate:  " << 100.0 * stats.reuseRate() << " %\n";
+
+    if (delivered == 0) {
+      exit_code = 1;
+    }
+    client.stopAll();
+  }
+
+  kill(server_pid, SIGTERM);
+  waitpid(server_pid, nullptr, 0);
+  return exit_code;
+}
@@ -0,0 +1,132 @@
+// Measures PumpFunStreamClient throughput and delivery latency against a local
+// WebSocket server that pushes quote updates for many mints as fast as it can.
+// A non-zero consumer delay simulates a slow callback to show conflation; a
+// non-zero rate paces the server so latency is measured below saturation.
+//
+// Usage: bench_stream_quotes [mints=1000] [messages=200000] [consumer_delay_us=0] [rate_per_s=0]
+
+#include "market_data/mint_key.h"
+#include "market_data/pumpfun_stream_client.h"
+#include "testing/mock_websocket_server.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double cpuSeconds() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  const auto seconds = [](const timeval& tv) { return tv.tv_sec + tv.tv_usec / 1e6; };
+  return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+// Wall clock, since quote timestamps are epoch nanoseconds.
+std::int64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// A distinct, valid mint address per index.
+std::string mintAddress(int index) {
+  market_data::MintKey::Bytes bytes{};
+  for (std::size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<std::uint8_t>((index >> (8 * (i % 4))) * 31 + i * 7 + 1);
+  }
+  return market_data::MintKey(bytes).toBase58();
+}
+
+double percentile(std::vector<std::int64_t>& samples, double fraction) {
+  if (samples.empty()) {
+    return 0.0;
+  }
+  const auto index = static_cast<std::size_t>(fraction * (samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index] / 1e3;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int mints = argc > 1 ? std::atoi(argv[1]) : 1000;
+  const int messages = argc > 2 ? std::atoi(argv[2]) : 200000;
+  const int consumer_delay_us = argc > 3 ? std::atoi(argv[3]) : 0;
+  const int rate = argc > 4 ? std::atoi(argv[4]) : 0;
+
+  testing::MockWebSocketServer server;
+  server.start();
+
+  market_data::PumpFunStreamClient client(server.url("/stream"));
+  // Written only from the dispatch thread; read after stop().
+  std::vector<std::int64_t> latencies;
+  latencies.reserve(static_cast<std::size_t>(messages));
+  std::vector<std::string> addresses;
+  addresses.reserve(static_cast<std::size_t>(mints));
+  for (int i = 0; i < mints; ++i) {
+    addresses.push_back(mintAddress(i));
+    client.subscribeToQuotes(addresses.back(), [&](const market_data::TokenQuote& quote) {
+      latencies.push_back(nowNanos() - quote.timestamp_ns);
+      if (consumer_delay_us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(consumer_delay_us));
+      }
+    });
+  }
+  client.start();
+
+  const auto ready_deadline = Clock::now() + std::chrono::seconds(5);
+  while (server.receivedMessages().size() * 100 < static_cast<std::size_t>(mints) &&
+         Clock::now() < ready_deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  const double cpu_start = cpuSeconds();
+  const auto wall_start = Clock::now();
+  for (int i = 0; i < messages; ++i) {
+    if (rate > 0) {
+      std::this_thread::sleep_until(wall_start + std::chrono::microseconds(1000000LL * i / rate));
+    }
+    server.broadcast(R"({"channel":"quotes","data":{"mint":")" + addresses[i % mints] +
+                     R"(","price":0.0042,"volume24h":125000,"liquidity":50000,"timestamp":)" +
+                     std::to_string(nowNanos()) + "}}");
+  }
+  const double send_seconds = std::chrono::duration<double>(Clock::now() - wall_start).count();
+
+  const auto drain_deadline = Clock::now() + std::chrono::seconds(30);
+  while (client.stats().messages_received < static_cast<std::uint64_t>(messages) &&
+         Clock::now() < drain_deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  const double wall = std::chrono::duration<double>(Clock::now() - wall_start).count();
+  const double cpu = cpuSeconds() - cpu_start;
+  // Let the dispatcher finish the last conflated batch before reading stats.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  const auto stats = client.stats();
+  client.stop();
+  server.stop();
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "mints:                  " << mints << "\n"
+            << "messages sent:          " << messages << " in " << send_seconds << " s\n"
+            << "messages received:      " << stats.messages_received << " ("
+            << stats.messages_received / wall << "/s)\n"
+            << "bytes received:         " << stats.bytes_received << "\n"
+            << "quotes delivered:       " << stats.quotes_delivered << "\n"
+            << "quotes conflated:       " << stats.quotes_conflated << "\n"
+            << "latency p50:            " << percentile(latencies, 0.50) << " us\n"
+            << "latency p99:            " << percentile(latencies, 0.99) << " us\n"
+            << "process CPU:            " << 100.0 * cpu / wall << " % of one core (server included)\n";
+
+  return stats.messages_received == static_cast<std::uint64_t>(messages) ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+#include "common/timer_wheel.h"
+
+#include "common/logging.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace common {
+namespace {
+constexpr std::uint64_t kMaxHorizonTicks = (std::uint64_t{1} << 32) - 1;
+}  // namespace
+
+TimerWheel::TimerWheel(std::chrono::milliseconds resolution)
+    : resolution_(resolution), origin_(Clock::now()) {
+    if (resolution_.count() <= 0) {
+        throw std::invalid_argument("TimerWheel resolution must be positive");
+    }
+}
+
+TimerWheel::~TimerWheel() {
+    stop();
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay, Callback callback) {
+    if (!callback) {
+        throw std::invalid_argument("Timer callback must be valid");
+    }
+
+    const auto due = Clock::now() + std::max(delay, std::chrono::milliseconds(0));
+    TimerId id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = addLocked(tickAt(due + resolution_ - Clock::duration(1)), 0, std::move(callback));
+        wakeRequested_ = true;
+    }
+    wakeCondition_.notify_one();
+    return id;
+}
+
+TimerWheel::TimerId TimerWheel::scheduleEvery(std::chrono::milliseconds interval,
+                                              Callback callback,
+                                              std::chrono::milliseconds initialDelay) {
+    if (!callback) {
+        throw std::invalid_argument("Timer callback must be valid");
+    }
+    if (interval.count() <= 0) {
+        throw std::invalid_argument("Timer interval must be positive");
+    }
+
+    const auto firstDelay = initialDelay.count() < 0 ? interval : initialDelay;
+    const auto due = Clock::now() + firstDelay;
+    TimerId id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = addLocked(tickAt(due + resolution_ - Clock::duration(1)), ticksFor(interval),
+                       std::move(callback));
+        wakeRequested_ = true;
+    }
+    wakeCondition_.notify_one();
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool removed = false;
+    auto it = index_.find(id);
+    if (it != index_.end()) {
+        it->second.slot->erase(it->second.it);
+        --levelCounts_[it->second.level];
+        index_.erase(it);
+        removed = true;
+    }
+
+    if (executingThread_ != std::this_thread::get_id()) {
+        executionDone_.wait(lock, [this, id]() { return executingId_ != id; });
+    }
+    return removed;
+}
+
+std::size_t TimerWheel::advance(Clock::time_point now) {
+    std::lock_guard<std::mutex> advanceLock(advanceMutex_);
+
+    const std::uint64_t target = tickAt(now);
+    std::size_t fired = 0;
+
+    while (true) {
+        Slot due;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (currentTick_ >= target) {
+                break;
+            }
+
+            // Skip empty stretches: the next occupied tick (or cascade
+            // boundary) is the only one that needs processing.
+            const auto next = nextExpiryTickLocked();
+            if (!next || *next > target) {
+                currentTick_ = target;
+                break;
+            }
+
+            const std::uint64_t tick = *next;
+            currentTick_ = tick;
+            for (std::size_t level = kLevels - 1; level > 0; --level) {
+                const std::uint64_t lowerMask = (std::uint64_t{1} << (kSlotBits * level)) - 1;
+                if ((tick & lowerMask) == 0) {
+                    cascadeLocked(level, static_cast<std::size_t>((tick >> (kSlotBits * level)) & kSlotMask));
+                }
+            }
+
+            due.splice(due.end(), wheel_[0][tick & kSlotMask]);
+            levelCounts_[0] -= due.size();
+            for (auto& node : due) {
+                index_.erase(node.id);
+                if (node.intervalTicks > 0) {
+                    // Re-arm periodic timers before running them so the callback
+                    // can cancel its own id.
+                    Slot fresh;
+                    // A lagging caller gets one catch-up run, not a burst.
+                    fresh.push_back(TimerNode{node.id, std::max(tick + node.intervalTicks, target),
+                                              node.intervalTicks, node.callback});
+                    placeLocked(fresh, fresh.begin());
+                }
+            }
+        }
+
+        for (const auto& node : due) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                executingId_ = node.id;
+                executingThread_ = std::this_thread::get_id();
+            }
+            try {
+                (*node.callback)();
+            } catch (const std::exception& ex) {
+                LOG_ERROR(std::string("TimerWheel callback error (timer ") + std::to_string(node.id) +
+                          "): " + ex.what());
+            } catch (...) {
+                LOG_ERROR("TimerWheel callback error (timer " + std::to_string(node.id) +
+                          "): unknown exception");
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                executingId_ = 0;
+                executingThread_ = std::thread::id{};
+            }
+            executionDone_.notify_all();
+            ++fired;
+        }
+    }
+
+    return fired;
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::nextExpiry() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto tick = nextExpiryTickLocked();
+    if (!tick) {
+        return std::nullopt;
+    }
+    return timeOfTick(*tick);
+}
+
+std::size_t TimerWheel::pendingTimers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+std::chrono::milliseconds TimerWheel::resolution() const {
+    return resolution_;
+}
+
+void TimerWheel::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) {
+        return;
+    }
+
+    driver_ = std::thread(&TimerWheel::driverLoop, this);
+}
+
+void TimerWheel::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeRequested_ = true;
+    }
+    wakeCondition_.notify_all();
+
+    if (driver_.joinable()) {
+        if (driver_.get_id() == std::this_thread::get_id()) {
+            // Stopped from inside a callback; joining ourselves would deadlock.
+            driver_.detach();
+        } else {
+            driver_.join();
+        }
+    }
+}
+
+bool TimerWheel::isRunning() const {
+    return running_.load();
+}
+
+TimerWheel::TimerId TimerWheel::addLocked(std::uint64_t expiryTick,
+                                          std::uint64_t intervalTicks,
+                                          Callback callback) {
+    const TimerId id = nextId_++;
+    Slot fresh;
+    fresh.push_back(TimerNode{id, std::max(expiryTick, currentTick_ + 1), intervalTicks,
+                              std::make_shared<Callback>(std::move(callback))});
+    placeLocked(fresh, fresh.begin());
+    return id;
+}
+
+void TimerWheel::placeLocked(Slot& source, Slot::iterator it) {
+    const std::uint64_t expiry = std::max(it->expiryTick, currentTick_);
+    const std::uint64_t delta = std::min(expiry - currentTick_, kMaxHorizonTicks);
+    const std::uint64_t slotTick = currentTick_ + delta;
+
+    std::size_t level = 0;
+    while (level + 1 < kLevels && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+
+    Slot& target = wheel_[level][(slotTick >> (kSlotBits * level)) & kSlotMask];
+    target.splice(target.end(), source, it);
+    index_[it->id] = Location{&target, it, level};
+    ++levelCounts_[level];
+}
+
+void TimerWheel::cascadeLocked(std::size_t level, std::size_t index) {
+    Slot pending;
+    pending.splice(pending.end(), wheel_[level][index]);
+    levelCounts_[level] -= pending.size();
+    while (!pending.empty()) {
+        placeLocked(pending, pending.begin());
+    }
+}
+
+std::uint64_t TimerWheel::ticksFor(std::chrono::milliseconds duration) const {
+    const auto ticks = (duration.count() + resolution_.count() - 1) / resolution_.count();
+    return static_cast<std::uint64_t>(std::max<long long>(1, ticks));
+}
+
+std::uint64_t TimerWheel::tickAt(Clock::time_point when) const {
+    if (when <= origin_) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>((when - origin_) / resolution_);
+}
+
+TimerWheel::Clock::time_point TimerWheel::timeOfTick(std::uint64_t tick) const {
+    return origin_ + resolution_ * static_cast<long long>(tick);
+}
+
+std::optional<std::uint64_t> TimerWheel::nextExpiryTickLocked() const {
+    if (index_.empty()) {
+        return std::nullopt;
+    }
+
+    // Timers on higher levels must be cascaded at the next boundary before
+    // their exact slot is known.
+    std::uint64_t limit = currentTick_ + kSlots;
+    if (levelCounts_[0] < index_.size()) {
+        limit = ((currentTick_ >> kSlotBits) + 1) << kSlotBits;
+    }
+
+    if (levelCounts_[0] > 0) {
+        for (std::uint64_t tick = currentTick_ + 1; tick <= limit; ++tick) {
+            if (!wheel_[0][tick & kSlotMask].empty()) {
+                return tick;
+            }
+        }
+    }
+    return limit;
+}
+
+void TimerWheel::driverLoop() {
+    while (running_.load()) {
+        advance(Clock::now());
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_.load()) {
+            break;
+        }
+        if (wakeRequested_) {
+            wakeRequested_ = false;
+            continue;
+        }
+
+        const auto next = nextExpiryTickLocked();
+        const auto wakePredicate = [this]() { return !running_.load() || wakeRequested_; };
+        if (next) {
+            wakeCondition_.wait_until(lock, timeOfTick(*next), wakePredicate);
+        } else {
+            wakeCondition_.wait(lock, wakePredicate);
+        }
+        wakeRequested_ = false;
+    }
+}
+
+}  // namespace common
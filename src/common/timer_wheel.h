@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+namespace common {
+
+// TimerWheel is a hierarchical hashed timer wheel (four levels of 256 slots)
+// with O(1) schedule and cancel. It can be driven either by its own thread via
+// start()/stop() or by an existing event loop that calls advance() and sleeps
+// until nextExpiry(). Callbacks run on whichever thread advances the wheel and
+// may freely schedule or cancel timers.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = std::uint64_t;
+    using Callback = std::function<void()>;
+
+    explicit TimerWheel(std::chrono::milliseconds resolution = std::chrono::milliseconds(10));
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Runs callback once after delay (rounded up to the wheel resolution).
+    TimerId schedule(std::chrono::milliseconds delay, Callback callback);
+
+    // Runs callback every interval; the first run happens after initialDelay.
+    TimerId scheduleEvery(std::chrono::milliseconds interval,
+                          Callback callback,
+                          std::chrono::milliseconds initialDelay = std::chrono::milliseconds(-1));
+
+    // Cancels a pending timer. Returns false if it already fired or is unknown.
+    // If the callback is running on another thread, waits for it to finish so
+    // owners can safely tear down state the callback touches.
+    bool cancel(TimerId id);
+
+    // Fires every timer that is due at now. Returns the number of callbacks run.
+    std::size_t advance(Clock::time_point now = Clock::now());
+
+    // Earliest time the wheel needs servicing, or nullopt when idle. Far-away
+    // timers report the next cascade boundary rather than their exact expiry.
+    std::optional<Clock::time_point> nextExpiry() const;
+
+    std::size_t pendingTimers() const;
+    std::chrono::milliseconds resolution() const;
+
+    // Drives the wheel from a dedicated thread.
+    void start();
+    void stop();
+    bool isRunning() const;
+
+private:
+    static constexpr std::size_t kLevels = 4;
+    static constexpr std::size_t kSlotBits = 8;
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+
+    struct TimerNode {
+        TimerId id{0};
+        std::uint64_t expiryTick{0};
+        std::uint64_t intervalTicks{0};
+        std::shared_ptr<Callback> callback;
+    };
+
+    using Slot = std::list<TimerNode>;
+
+    struct Location {
+        Slot* slot{nullptr};
+        Slot::iterator it;
+        std::size_t level{0};
+    };
+
+    TimerId addLocked(std::uint64_t expiryTick, std::uint64_t intervalTicks, Callback callback);
+    void placeLocked(Slot& source, Slot::iterator it);
+    void cascadeLocked(std::size_t level, std::size_t index);
+    std::uint64_t ticksFor(std::chrono::milliseconds duration) const;
+    std::uint64_t tickAt(Clock::time_point when) const;
+    Clock::time_point timeOfTick(std::uint64_t tick) const;
+    std::optional<std::uint64_t> nextExpiryTickLocked() const;
+    void driverLoop();
+
+    const std::chrono::milliseconds resolution_;
+    const Clock::time_point origin_;
+
+    mutable std::mutex mutex_;
+    std::array<std::array<Slot, kSlots>, kLevels> wheel_;
+    std::unordered_map<TimerId, Location> index_;
+    std::array<std::size_t, kLevels> levelCounts_{};
+    std::uint64_t currentTick_{0};
+    TimerId nextId_{1};
+
+    // Serialises advance() so callbacks for one tick never interleave.
+    std::mutex advanceMutex_;
+    TimerId executingId_{0};
+    std::thread::id executingThread_{};
+    std::condition_variable executionDone_;
+
+    std::atomic<bool> running_{false};
+    std::thread driver_;
+    std::condition_variable wakeCondition_;
+    bool wakeRequested_{false};
+};
+
+}  // namespace common
@@ -0,0 +1,109 @@
+#include "market_data/circuit_breaker.h"
+
+#include "common/logging.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace market_data {
+
+const char* circuitStateName(CircuitState state) {
+  switch (state) {
+    case CircuitState::Closed:
+      return "closed";
+    case CircuitState::Open:
+      return "open";
+    case CircuitState::HalfOpen:
+      return "half-open";
+  }
+  return "unknown";
+}
+
+CircuitBreaker::CircuitBreaker(std::string name, Options options)
+    : name_(std::move(name)), options_(options), open_duration_(options.open_duration) {
+  validate(options_);
+}
+
+void CircuitBreaker::validate(const Options& options) {
+  if (options.failure_threshold == 0 || options.open_duration.count() <= 0 ||
+      options.max_open_duration < options.open_duration) {
+    throw std::invalid_argument(
+        "Circuit breaker needs failure_threshold > 0 and 0 < open_duration <= max_open_duration");
+  }
+}
+
+bool CircuitBreaker::allowRequest() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state_ == CircuitState::Closed) {
+    return true;
+  }
+
+  const auto now = Clock::now();
+  if (now < retry_at_) {
+    ++stats_.rejected_requests;
+    return false;
+  }
+  // Open period over, or the last probe went missing: this request probes.
+  state_ = CircuitState::HalfOpen;
+  retry_at_ = now + open_duration_;
+  return true;
+}
+
+bool CircuitBreaker::admits() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state_ == CircuitState::Closed || Clock::now() >= retry_at_) {
+    return true;
+  }
+  ++stats_.rejected_requests;
+  return false;
+}
+
+void CircuitBreaker::onSuccess() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.consecutive_failures = 0;
+  if (state_ == CircuitState::HalfOpen) {
+    state_ = CircuitState::Closed;
+    open_duration_ = options_.open_duration;
+    LOG_INFO("Circuit breaker for " + name_ + " closed after a successful probe");
+  }
+}
+
+void CircuitBreaker::onFailure() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.consecutive_failures;
+  const auto now = Clock::now();
+  if (state_ == CircuitState::HalfOpen) {
+    open_duration_ = std::min(open_duration_ * 2, options_.max_open_duration);
+    openLocked(now);
+  } else if (state_ == CircuitState::Closed &&
+             stats_.consecutive_failures >= options_.failure_threshold) {
+    openLocked(now);
+  }
+}
+
+CircuitState CircuitBreaker::state() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return state_;
+}
+
+CircuitBreakerStats CircuitBreaker::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CircuitBreakerStats stats = stats_;
+  stats.state = state_;
+  const auto now = Clock::now();
+  if (state_ == CircuitState::Open && retry_at_ > now) {
+    stats.retry_in = std::chrono::ceil<std::chrono::milliseconds>(retry_at_ - now);
+  }
+  return stats;
+}
+
+void CircuitBreaker::openLocked(Clock::time_point now) {
+  state_ = CircuitState::Open;
+  retry_at_ = now + open_duration_;
+  ++stats_.times_opened;
+  LOG_WARN("Circuit breaker for " + name_ + " opened after " +
+           std::to_string(stats_.consecutive_failures) + " consecutive failures; probing in " +
+           std::to_string(open_duration_.count()) + " ms");
+}
+
+}  // namespace market_data
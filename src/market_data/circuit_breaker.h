@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace market_data {
+
+enum class CircuitState : std::uint8_t {
+  // Requests flow; consecutive failures are counted.
+  Closed = 0,
+  // Requests fail fast until the open period ends.
+  Open,
+  // One probe request at a time decides whether to close or reopen.
+  HalfOpen,
+};
+
+const char* circuitStateName(CircuitState state);
+
+// Thrown instead of issuing a request while its endpoint's breaker is open.
+class CircuitOpenError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+struct CircuitBreakerStats {
+  CircuitState state = CircuitState::Closed;
+  std::uint64_t consecutive_failures = 0;
+  // Times the breaker tripped, including failed probes.
+  std::uint64_t times_opened = 0;
+  // Requests failed fast while open or while a probe was in flight.
+  std::uint64_t rejected_requests = 0;
+  // Until the next probe is let through; zero unless open.
+  std::chrono::milliseconds retry_in{0};
+};
+
+// CircuitBreaker guards one upstream endpoint. After failure_threshold
+// consecutive failures it opens and rejects requests for open_duration, then
+// half-opens and lets a single probe through: a success closes it, a failure
+// reopens it for twice as long (up to max_open_duration). A probe that never
+// reports back is replaced by a new one after the current open duration.
+class CircuitBreaker {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    std::size_t failure_threshold = 5;
+    std::chrono::milliseconds open_duration{std::chrono::seconds(5)};
+    std::chrono::milliseconds max_open_duration{std::chrono::seconds(60)};
+  };
+
+  // name identifies the endpoint in log lines. Throws std::invalid_argument
+  // unless validate(options) passes.
+  CircuitBreaker(std::string name, Options options);
+
+  // Throws std::invalid_argument for a zero threshold, a non-positive
+  // open_duration or max_open_duration < open_duration.
+  static void validate(const Options& options);
+
+  // Returns false if the request must fail fast. A true result in the
+  // half-open state makes the caller the probe, which should report back.
+  bool allowRequest();
+  // Returns false, counting a rejected request, if a request must fail fast
+  // now. Unlike allowRequest it never claims the half-open probe, so callers
+  // check it before other admission steps (rate limiting) and call
+  // allowRequest only once the request will be sent.
+  bool admits();
+
+  // An upstream response that shows the endpoint is up (anything but a
+  // transport error or a 5xx).
+  void onSuccess();
+  // A transport error or a 5xx.
+  void onFailure();
+
+  CircuitState state() const;
+  CircuitBreakerStats stats() const;
+
+ private:
+  // Requires mutex_.
+  void openLocked(Clock::time_point now);
+
+  const std::string name_;
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  CircuitState state_ = CircuitState::Closed;
+  std::chrono::milliseconds open_duration_;
+  // End of the open period, or while half-open, when a lost probe is replaced.
+  Clock::time_point retry_at_;
+  CircuitBreakerStats stats_;
+};
+
+}  // namespace market_data
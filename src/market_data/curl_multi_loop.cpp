@@ -0,0 +1,443 @@
+#include "market_data/curl_multi_loop.h"
+
+#include "common/logging.h"
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace market_data {
+namespace {
+constexpr int kMaxEvents = 64;
+constexpr std::size_t kMaxIdleHandles = 64;
+constexpr long kTcpKeepIdleSeconds = 30;
+
+int millisUntil(std::chrono::steady_clock::time_point deadline) {
+  const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+  return static_cast<int>(std::max<long long>(0, remaining.count()));
+}
+}  // namespace
+
+CurlMultiLoop::CurlMultiLoop(std::shared_ptr<common::TimerWheel> timers,
+                             TransferObserver observer,
+                             std::size_t max_connections_per_host)
+    : timers_(std::move(timers)),
+      observer_(std::move(observer)),
+      max_connections_per_host_(static_cast<long>(std::max<std::size_t>(1, max_connections_per_host))) {
+  multi_ = curl_multi_init();
+  if (multi_ == nullptr) {
+    throw std::runtime_error("Failed to initialize CURL multi handle");
+  }
+
+#if defined(__linux__)
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ < 0 || wake_fd_ < 0) {
+    if (epoll_fd_ >= 0) {
+      close(epoll_fd_);
+    }
+    if (wake_fd_ >= 0) {
+      close(wake_fd_);
+    }
+    curl_multi_cleanup(multi_);
+    throw std::runtime_error("Failed to create epoll/eventfd for CurlMultiLoop");
+  }
+  epoll_event wake_event{};
+  wake_event.events = EPOLLIN;
+  wake_event.data.fd = wake_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event);
+
+  curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, &CurlMultiLoop::onSocket);
+  curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+  curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, &CurlMultiLoop::onTimer);
+  curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+#endif
+}
+
+CurlMultiLoop::~CurlMultiLoop() {
+  stop();
+
+  for (const PooledHandle& idle : idle_handles_) {
+    curl_easy_cleanup(idle.handle);
+  }
+  idle_handles_.clear();
+  curl_multi_cleanup(multi_);
+
+#if defined(__linux__)
+  close(wake_fd_);
+  close(epoll_fd_);
+#endif
+}
+
+void CurlMultiLoop::start() {
+  bool expected = false;
+  if (!running_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  thread_ = std::thread(&CurlMultiLoop::run, this);
+}
+
+void CurlMultiLoop::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  wakeup();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  std::deque<std::unique_ptr<Transfer>> dropped;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    dropped.swap(pending_);
+  }
+  in_flight_.fetch_sub(dropped.size());
+}
+
+bool CurlMultiLoop::isRunning() const {
+  return running_.load();
+}
+
+CurlMultiLoop::TransferId CurlMultiLoop::submit(Request request, Completion completion) {
+  if (!running_.load()) {
+    return 0;
+  }
+
+  auto transfer = std::make_unique<Transfer>();
+  const TransferId id = next_transfer_id_.fetch_add(1);
+  transfer->id = id;
+  transfer->request = std::move(request);
+  transfer->completion = std::move(completion);
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_.push_back(std::move(transfer));
+  }
+  ++in_flight_;
+  wakeup();
+  return id;
+}
+
+void CurlMultiLoop::cancel(TransferId id) {
+  std::unique_ptr<Transfer> dropped;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    const auto it = std::find_if(pending_.begin(), pending_.end(),
+                                 [id](const auto& transfer) { return transfer->id == id; });
+    if (it == pending_.end()) {
+      cancelled_.push_back(id);
+    } else {
+      dropped = std::move(*it);
+      pending_.erase(it);
+    }
+  }
+  if (dropped) {
+    --in_flight_;
+    return;
+  }
+  wakeup();
+}
+
+void CurlMultiLoop::wakeup() {
+#if defined(__linux__)
+  const std::uint64_t one = 1;
+  // A full counter already guarantees a wakeup, so a failed write is harmless.
+  [[maybe_unused]] const auto written = write(wake_fd_, &one, sizeof(one));
+#else
+  curl_multi_wakeup(multi_);
+#endif
+}
+
+void CurlMultiLoop::setMaxConnectionsPerHost(std::size_t limit) {
+  max_connections_per_host_.store(static_cast<long>(std::max<std::size_t>(1, limit)));
+  wakeup();
+}
+
+std::size_t CurlMultiLoop::inFlight() const {
+  return in_flight_.load();
+}
+
+int CurlMultiLoop::onSocket(CURL*, curl_socket_t socket, int what, void* userp, void* socketp) {
+#if defined(__linux__)
+  auto* loop = static_cast<CurlMultiLoop*>(userp);
+  if (what == CURL_POLL_REMOVE) {
+    epoll_ctl(loop->epoll_fd_, EPOLL_CTL_DEL, socket, nullptr);
+    curl_multi_assign(loop->multi_, socket, nullptr);
+    return 0;
+  }
+
+  epoll_event event{};
+  event.data.fd = socket;
+  if (what & CURL_POLL_IN) {
+    event.events |= EPOLLIN;
+  }
+  if (what & CURL_POLL_OUT) {
+    event.events |= EPOLLOUT;
+  }
+
+  if (socketp != nullptr) {
+    epoll_ctl(loop->epoll_fd_, EPOLL_CTL_MOD, socket, &event);
+  } else {
+    epoll_ctl(loop->epoll_fd_, EPOLL_CTL_ADD, socket, &event);
+    // Any non-null marker records that the socket is registered with epoll.
+    curl_multi_assign(loop->multi_, socket, loop);
+  }
+#else
+  (void)socket;
+  (void)what;
+  (void)userp;
+  (void)socketp;
+#endif
+  return 0;
+}
+
+int CurlMultiLoop::onTimer(CURLM*, long timeout_ms, void* userp) {
+  auto* loop = static_cast<CurlMultiLoop*>(userp);
+  if (timeout_ms < 0) {
+    loop->curl_deadline_.reset();
+  } else {
+    loop->curl_deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  }
+  return 0;
+}
+
+void CurlMultiLoop::run() {
+  while (running_.load()) {
+    const long host_limit = max_connections_per_host_.load();
+    if (host_limit != applied_connections_per_host_) {
+      curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, host_limit);
+      applied_connections_per_host_ = host_limit;
+    }
+
+    addPendingTransfers();
+    if (timers_) {
+      timers_->advance();
+    }
+    // Timer callbacks may have queued transfers; start them before sleeping.
+    addPendingTransfers();
+    cancelTransfers();
+
+    waitForEvents(waitMillis());
+    processCompletions();
+  }
+
+  abortTransfers();
+}
+
+void CurlMultiLoop::addPendingTransfers() {
+  std::deque<std::unique_ptr<Transfer>> pending;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending.swap(pending_);
+  }
+
+  for (auto& transfer : pending) {
+    PooledHandle pooled = takeHandle();
+    CURL* handle = pooled.handle;
+    if (handle == nullptr) {
+      Result result;
+      result.code = CURLE_FAILED_INIT;
+      result.error = "Failed to initialize CURL easy handle";
+      --in_flight_;
+      transfer->completion(std::move(result));
+      continue;
+    }
+
+    curl_easy_setopt(handle, CURLOPT_URL, transfer->request.url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer->request.headers.get());
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(transfer->request.timeout.count()));
+    transfer->buffer = std::move(pooled.buffer);
+    transfer->buffer.attach(handle);
+    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, transfer->error_buffer);
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, transfer.get());
+
+    const CURLMcode added = curl_multi_add_handle(multi_, handle);
+    if (added != CURLM_OK) {
+      Result result;
+      result.code = CURLE_FAILED_INIT;
+      result.error = curl_multi_strerror(added);
+      releaseHandle(handle, std::move(transfer->buffer));
+      --in_flight_;
+      transfer->completion(std::move(result));
+      continue;
+    }
+    active_.emplace(handle, std::move(transfer));
+  }
+}
+
+int CurlMultiLoop::waitMillis() const {
+  std::optional<int> wait;
+  if (curl_deadline_) {
+    wait = millisUntil(*curl_deadline_);
+  }
+  if (timers_) {
+    if (const auto next = timers_->nextExpiry()) {
+      const int timer_wait = millisUntil(*next);
+      wait = wait ? std::min(*wait, timer_wait) : timer_wait;
+    }
+  }
+  return wait.value_or(-1);
+}
+
+void CurlMultiLoop::waitForEvents(int timeout_ms) {
+  int running_handles = 0;
+#if defined(__linux__)
+  epoll_event events[kMaxEvents];
+  const int ready = epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+  for (int i = 0; i < ready; ++i) {
+    const int fd = events[i].data.fd;
+    if (fd == wake_fd_) {
+      std::uint64_t drained = 0;
+      [[maybe_unused]] const auto read_bytes = read(wake_fd_, &drained, sizeof(drained));
+      continue;
+    }
+
+    int flags = 0;
+    if (events[i].events & EPOLLIN) {
+      flags |= CURL_CSELECT_IN;
+    }
+    if (events[i].events & EPOLLOUT) {
+      flags |= CURL_CSELECT_OUT;
+    }
+    if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+      flags |= CURL_CSELECT_ERR;
+    }
+    curl_multi_socket_action(multi_, fd, flags, &running_handles);
+  }
+
+  if (curl_deadline_ && std::chrono::steady_clock::now() >= *curl_deadline_) {
+    curl_deadline_.reset();
+    curl_multi_socket_action(multi_, CURL_SOCKET_TIMEOUT, 0, &running_handles);
+  }
+#else
+  // Without epoll, curl_multi_poll waits on curl's own sockets and is woken by
+  // curl_multi_wakeup(); its timeout is capped by libcurl's internal timers.
+  int descriptors = 0;
+  curl_multi_poll(multi_, nullptr, 0, timeout_ms < 0 ? 1000 : timeout_ms, &descriptors);
+  curl_multi_perform(multi_, &running_handles);
+#endif
+}
+
+void CurlMultiLoop::processCompletions() {
+  int remaining = 0;
+  while (CURLMsg* message = curl_multi_info_read(multi_, &remaining)) {
+    if (message->msg != CURLMSG_DONE) {
+      continue;
+    }
+
+    CURL* handle = message->easy_handle;
+    const CURLcode code = message->data.result;
+    curl_multi_remove_handle(multi_, handle);
+
+    auto it = active_.find(handle);
+    if (it == active_.end()) {
+      curl_easy_cleanup(handle);
+      continue;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    active_.erase(it);
+
+    Result result;
+    result.code = code;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &result.status_code);
+    curl_off_t retry_after = 0;
+    if (curl_easy_getinfo(handle, CURLINFO_RETRY_AFTER, &retry_after) == CURLE_OK &&
+        retry_after > 0) {
+      result.retry_after = std::chrono::seconds(retry_after);
+    }
+    result.timing = HttpTiming::fromHandle(handle);
+    result.body = transfer->buffer.take();
+    if (code != CURLE_OK) {
+      result.error = transfer->error_buffer[0] != '\0' ? std::string(transfer->error_buffer)
+                                                       : std::string(curl_easy_strerror(code));
+    } else if (observer_) {
+      observer_(handle);
+    }
+
+    --in_flight_;
+    try {
+      transfer->completion(result);
+    } catch (const std::exception& ex) {
+      LOG_ERROR(std::string("CurlMultiLoop completion error for ") + transfer->request.url + ": " +
+                ex.what());
+    } catch (...) {
+      LOG_ERROR("CurlMultiLoop completion error for " + transfer->request.url +
+                ": unknown exception");
+    }
+    // Completions read the body in place, so its storage serves the handle's
+    // next transfer.
+    transfer->buffer.recycle(std::move(result.body));
+    releaseHandle(handle, std::move(transfer->buffer));
+  }
+}
+
+void CurlMultiLoop::cancelTransfers() {
+  std::vector<TransferId> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    cancelled.swap(cancelled_);
+  }
+
+  // Cancellations are rare (hedged requests), so a scan beats another index.
+  for (const TransferId id : cancelled) {
+    const auto it = std::find_if(active_.begin(), active_.end(),
+                                 [id](const auto& entry) { return entry.second->id == id; });
+    if (it == active_.end()) {
+      continue;
+    }
+    CURL* handle = it->first;
+    curl_multi_remove_handle(multi_, handle);
+    ReceiveBuffer buffer = std::move(it->second->buffer);
+    active_.erase(it);
+    releaseHandle(handle, std::move(buffer));
+    --in_flight_;
+  }
+}
+
+void CurlMultiLoop::abortTransfers() {
+  for (auto& [handle, transfer] : active_) {
+    curl_multi_remove_handle(multi_, handle);
+    curl_easy_cleanup(handle);
+  }
+  in_flight_.fetch_sub(active_.size());
+  active_.clear();
+}
+
+CurlMultiLoop::PooledHandle CurlMultiLoop::takeHandle() {
+  if (!idle_handles_.empty()) {
+    PooledHandle pooled = std::move(idle_handles_.back());
+    idle_handles_.pop_back();
+    return pooled;
+  }
+
+  PooledHandle pooled;
+  pooled.handle = curl_easy_init();
+  CURL* handle = pooled.handle;
+  if (handle == nullptr) {
+    return pooled;
+  }
+  curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, kTcpKeepIdleSeconds);
+  curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+  return pooled;
+}
+
+void CurlMultiLoop::releaseHandle(CURL* handle, ReceiveBuffer buffer) {
+  if (idle_handles_.size() < kMaxIdleHandles) {
+    idle_handles_.push_back(PooledHandle{handle, std::move(buffer)});
+  } else {
+    curl_easy_cleanup(handle);
+  }
+}
+
+}  // namespace market_data
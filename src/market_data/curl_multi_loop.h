@@ -0,0 +1,146 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/timer_wheel.h"
+#include "market_data/http_metrics.h"
+#include "market_data/receive_buffer.h"
+
+namespace market_data {
+
+// CurlMultiLoop runs many HTTP GETs concurrently from a single thread using
+// the curl_multi socket interface on top of epoll (curl_multi_poll on platforms
+// without epoll). It can also drive a common::TimerWheel between I/O waits, so
+// periodic work and the transfers it starts share one thread.
+class CurlMultiLoop {
+ public:
+  // Identifies a submitted transfer; never zero.
+  using TransferId = std::uint64_t;
+
+  struct Request {
+    std::string url;
+    // Kept alive for the duration of the transfer; may be shared.
+    std::shared_ptr<curl_slist> headers;
+    std::chrono::milliseconds timeout{std::chrono::seconds(10)};
+  };
+
+  struct Result {
+    CURLcode code = CURLE_OK;
+    long status_code = 0;
+    // Retry-After of a 429/503 response; zero when absent.
+    std::chrono::seconds retry_after{0};
+    // The handle's receive buffer, reused once the completion returns; copy
+    // out anything that must outlive it.
+    std::string body;
+    // Transport error description; empty when the transfer completed.
+    std::string error;
+    HttpTiming timing;
+  };
+
+  // Completions run on the loop thread and must not block.
+  using Completion = std::function<void(const Result&)>;
+  // Invoked on the loop thread for every completed transfer before its
+  // completion, e.g. to collect connection statistics.
+  using TransferObserver = std::function<void(CURL*)>;
+
+  // timers, when set, is advanced by the loop thread; callers that schedule on
+  // it from other threads should call wakeup() so the loop re-arms its wait.
+  explicit CurlMultiLoop(std::shared_ptr<common::TimerWheel> timers = nullptr,
+                         TransferObserver observer = {},
+                         std::size_t max_connections_per_host = 4);
+  ~CurlMultiLoop();
+
+  CurlMultiLoop(const CurlMultiLoop&) = delete;
+  CurlMultiLoop& operator=(const CurlMultiLoop&) = delete;
+
+  void start();
+  // Aborts in-flight transfers; their completions are dropped.
+  void stop();
+  bool isRunning() const;
+
+  // Queues a transfer. Thread-safe. Returns zero if the loop is not running.
+  TransferId submit(Request request, Completion completion);
+
+  // Aborts a queued or running transfer and drops its completion. Thread-safe;
+  // a no-op once the transfer completed.
+  void cancel(TransferId id);
+
+  // Interrupts the current wait so timers and submissions are re-examined.
+  void wakeup();
+
+  void setMaxConnectionsPerHost(std::size_t limit);
+
+  // Transfers submitted but not yet completed.
+  std::size_t inFlight() const;
+
+ private:
+  struct Transfer {
+    TransferId id = 0;
+    Request request;
+    Completion completion;
+    ReceiveBuffer buffer;
+    char error_buffer[CURL_ERROR_SIZE] = {};
+  };
+
+  // An easy handle and the receive buffer that stays with it between transfers.
+  struct PooledHandle {
+    CURL* handle = nullptr;
+    ReceiveBuffer buffer;
+  };
+
+  static int onSocket(CURL* easy, curl_socket_t socket, int what, void* userp, void* socketp);
+  static int onTimer(CURLM* multi, long timeout_ms, void* userp);
+
+  void run();
+  void addPendingTransfers();
+  int waitMillis() const;
+  void waitForEvents(int timeout_ms);
+  void processCompletions();
+  void cancelTransfers();
+  void abortTransfers();
+  // handle is null when a new one cannot be created.
+  PooledHandle takeHandle();
+  // Keeps the handle for reuse, or cleans it up when enough are idle.
+  void releaseHandle(CURL* handle, ReceiveBuffer buffer);
+
+  std::shared_ptr<common::TimerWheel> timers_;
+  TransferObserver observer_;
+
+  CURLM* multi_ = nullptr;
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+  // Deadline requested by libcurl's timer callback; loop thread only.
+  std::optional<std::chrono::steady_clock::time_point> curl_deadline_;
+
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+
+  mutable std::mutex pending_mutex_;
+  std::deque<std::unique_ptr<Transfer>> pending_;
+  // Cancelled transfers that had already left pending_.
+  std::vector<TransferId> cancelled_;
+  std::atomic<TransferId> next_transfer_id_{1};
+  std::atomic<std::size_t> in_flight_{0};
+  std::atomic<long> max_connections_per_host_;
+  long applied_connections_per_host_ = 0;
+
+  // Loop thread only.
+  std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_;
+  std::vector<PooledHandle> idle_handles_;
+};
+
+}  // namespace market_data
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace market_data {
+
+// FieldLayoutCache remembers which alias each field arrived under in one
+// endpoint's responses (say "priceUsd" rather than "price"), detected from the
+// first record parsed. Later records then match each key against that single
+// alias instead of every alias chain. A record where an expected key is
+// missing or mistyped, or where a previously absent field shows up, is
+// re-parsed with full detection and replaces the layout. Thread-safe.
+class FieldLayoutCache {
+ public:
+  // Bit set once a layout has been detected; the low bits hold two bits per
+  // field with the alias index, or kAbsent.
+  static constexpr std::uint32_t kDetected = 1U << 31;
+  static constexpr std::uint32_t kAbsent = 3;
+
+  std::uint32_t layout() const { return layout_.load(std::memory_order_relaxed); }
+  void update(std::uint32_t layout) {
+    layout_.store(layout | kDetected, std::memory_order_relaxed);
+    detections_.fetch_add(1, std::memory_order_relaxed);
+  }
+  // Number of records that went through full detection.
+  std::uint64_t detections() const { return detections_.load(std::memory_order_relaxed); }
+  void reset() { layout_.store(0, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<std::uint32_t> layout_{0};
+  std::atomic<std::uint64_t> detections_{0};
+};
+
+}  // namespace market_data
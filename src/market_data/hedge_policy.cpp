@@ -0,0 +1,92 @@
+#include "market_data/hedge_policy.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace market_data {
+
+HedgePolicy::HedgePolicy(Options options) : options_(options) {
+  validate(options_);
+  samples_.reserve(options_.window);
+}
+
+void HedgePolicy::validate(const Options& options) {
+  if (!(options.percentile > 0.0 && options.percentile < 1.0)) {
+    throw std::invalid_argument("Hedge percentile must be between 0 and 1");
+  }
+  if (options.window == 0 || options.min_samples > options.window) {
+    throw std::invalid_argument("Hedge window must be positive and hold min_samples");
+  }
+  if (options.min_delay.count() <= 0 || options.max_delay < options.min_delay) {
+    throw std::invalid_argument("Hedge delays need 0 < min_delay <= max_delay");
+  }
+  if (!(options.budget_ratio > 0.0 && options.budget_ratio <= 1.0) || options.max_budget < 1.0) {
+    throw std::invalid_argument("Hedge budget needs 0 < budget_ratio <= 1 and max_budget >= 1");
+  }
+}
+
+void HedgePolicy::recordLatency(Clock::duration latency) {
+  const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (samples_.size() < options_.window) {
+    samples_.push_back(micros);
+  } else {
+    samples_[next_sample_] = micros;
+    next_sample_ = (next_sample_ + 1) % options_.window;
+  }
+  delay_stale_ = true;
+}
+
+std::optional<std::chrono::milliseconds> HedgePolicy::onRequest() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.eligible_requests;
+  budget_ = std::min(options_.max_budget, budget_ + options_.budget_ratio);
+  if (samples_.empty() || samples_.size() < options_.min_samples) {
+    return std::nullopt;
+  }
+  return delayLocked();
+}
+
+bool HedgePolicy::allowHedge() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (budget_ < 1.0) {
+    ++stats_.over_budget;
+    return false;
+  }
+  return true;
+}
+
+void HedgePolicy::onHedgeSent() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budget_ -= 1.0;
+  ++stats_.hedges_sent;
+}
+
+void HedgePolicy::onHedgeWon() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.hedges_won;
+}
+
+HedgingStats HedgePolicy::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  HedgingStats stats = stats_;
+  if (!samples_.empty() && samples_.size() >= options_.min_samples) {
+    stats.delay = delayLocked();
+  }
+  return stats;
+}
+
+std::chrono::milliseconds HedgePolicy::delayLocked() const {
+  if (delay_stale_) {
+    std::vector<std::int64_t> sorted = samples_;
+    const auto rank = static_cast<std::size_t>(options_.percentile * (sorted.size() - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    const auto percentile = std::chrono::ceil<std::chrono::milliseconds>(
+        std::chrono::microseconds(sorted[rank]));
+    delay_ = std::clamp(percentile, options_.min_delay, options_.max_delay);
+    delay_stale_ = false;
+  }
+  return delay_;
+}
+
+}  // namespace market_data
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace market_data {
+
+struct HedgingStats {
+  // Requests that could have been hedged.
+  std::uint64_t eligible_requests = 0;
+  std::uint64_t hedges_sent = 0;
+  // Hedges that answered before the request they duplicated.
+  std::uint64_t hedges_won = 0;
+  // Hedges skipped because the budget was spent.
+  std::uint64_t over_budget = 0;
+  // Current hedge delay; zero until enough latencies were observed.
+  std::chrono::milliseconds delay{0};
+};
+
+// HedgePolicy decides when a slow request gets a duplicate. It tracks the
+// latency of recent successful responses and reports the configured
+// percentile of them as the hedge delay. Hedges are paid from a budget that
+// each eligible request tops up by budget_ratio, so hedging adds at most that
+// fraction of extra load however slow the upstream gets.
+class HedgePolicy {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    // Latency percentile after which an unanswered request is hedged.
+    double percentile = 0.95;
+    // The percentile is taken over this many of the latest latencies, and
+    // hedging starts once min_samples of them were observed.
+    std::size_t window = 256;
+    std::size_t min_samples = 20;
+    // Bounds on the hedge delay.
+    std::chrono::milliseconds min_delay{std::chrono::milliseconds(10)};
+    std::chrono::milliseconds max_delay{std::chrono::seconds(2)};
+    // Hedges earned per eligible request, i.e. the most extra load hedging adds.
+    double budget_ratio = 0.05;
+    // Unspent budget is capped at this many hedges.
+    double max_budget = 10.0;
+  };
+
+  // Throws std::invalid_argument unless validate(options) passes.
+  explicit HedgePolicy(Options options);
+
+  // Throws std::invalid_argument for a percentile outside (0, 1), an empty
+  // window, min_samples above window, non-positive or inverted delay bounds,
+  // or a budget_ratio outside (0, 1] or max_budget below one hedge.
+  static void validate(const Options& options);
+
+  // Latency of a request that got a usable response, hedged or not.
+  void recordLatency(Clock::duration latency);
+
+  // Called once per request that may be hedged; adds its share to the budget.
+  // Returns how long to wait for a response before hedging, or std::nullopt
+  // while too few latencies were observed.
+  std::optional<std::chrono::milliseconds> onRequest();
+
+  // True when the budget covers a hedge; counts it as over budget otherwise.
+  bool allowHedge();
+  // A hedge went out; spends it from the budget.
+  void onHedgeSent();
+  void onHedgeWon();
+
+  HedgingStats stats() const;
+
+ private:
+  // Requires mutex_.
+  std::chrono::milliseconds delayLocked() const;
+
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  // Ring buffer of the latest latencies in microseconds.
+  std::vector<std::int64_t> samples_;
+  std::size_t next_sample_ = 0;
+  // Percentile of samples_, recomputed when new samples arrived.
+  mutable std::chrono::milliseconds delay_{0};
+  mutable bool delay_stale_ = false;
+  double budget_ = 0.0;
+  HedgingStats stats_;
+};
+
+}  // namespace market_data
@@ -0,0 +1,211 @@
+#include "market_data/http_connection_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace market_data {
+namespace {
+constexpr long kTcpKeepIdleSeconds = 30;
+constexpr long kTcpKeepIntervalSeconds = 15;
+}  // namespace
+
+double HttpConnectionStats::reuseRate() const {
+  if (requests == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(reused_connections) / static_cast<double>(requests);
+}
+
+std::chrono::microseconds HttpConnectionStats::averageConnectTime() const {
+  if (new_connections == 0) {
+    return std::chrono::microseconds(0);
+  }
+  return connect_time / static_cast<long long>(new_connections);
+}
+
+std::chrono::microseconds HttpConnectionStats::averageTlsHandshakeTime() const {
+  if (tls_handshakes == 0) {
+    return std::chrono::microseconds(0);
+  }
+  return tls_handshake_time / static_cast<long long>(tls_handshakes);
+}
+
+HttpConnectionPool::Lease::Lease(HttpConnectionPool* pool, CURL* handle, std::string host)
+    : pool_(pool), handle_(handle), host_(std::move(host)) {}
+
+HttpConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), handle_(other.handle_), host_(std::move(other.host_)) {
+  other.pool_ = nullptr;
+  other.handle_ = nullptr;
+}
+
+HttpConnectionPool::Lease::~Lease() {
+  if (pool_ != nullptr && handle_ != nullptr) {
+    pool_->release(handle_, host_);
+  }
+}
+
+HttpConnectionPool::HttpConnectionPool(std::size_t max_connections_per_host,
+                                       std::size_t max_idle_handles)
+    : max_connections_per_host_(std::max<std::size_t>(1, max_connections_per_host)),
+      max_idle_handles_(max_idle_handles) {
+  share_ = curl_share_init();
+  if (share_ == nullptr) {
+    throw std::runtime_error("Failed to initialize CURL share handle");
+  }
+  curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HttpConnectionPool::lockShared);
+  curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HttpConnectionPool::unlockShared);
+  curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+  std::vector<CURL*> handles;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    handles.swap(idle_handles_);
+  }
+  for (CURL* handle : handles) {
+    curl_easy_cleanup(handle);
+  }
+  // Every lease must have been returned; the share outlives its handles.
+  curl_share_cleanup(share_);
+}
+
+HttpConnectionPool::Lease HttpConnectionPool::acquire(const std::string& host) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  host_available_.wait(lock, [this, &host]() { return hostAvailableLocked(host); });
+  return leaseLocked(lock, host);
+}
+
+std::optional<HttpConnectionPool::Lease> HttpConnectionPool::tryAcquire(const std::string& host) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!hostAvailableLocked(host)) {
+    return std::nullopt;
+  }
+  return leaseLocked(lock, host);
+}
+
+bool HttpConnectionPool::hostAvailableLocked(const std::string& host) const {
+  auto it = in_flight_.find(host);
+  return it == in_flight_.end() || it->second < max_connections_per_host_;
+}
+
+HttpConnectionPool::Lease HttpConnectionPool::leaseLocked(std::unique_lock<std::mutex>& lock,
+                                                          const std::string& host) {
+  ++in_flight_[host];
+  CURL* handle = nullptr;
+  if (!idle_handles_.empty()) {
+    handle = idle_handles_.back();
+    idle_handles_.pop_back();
+  }
+  lock.unlock();
+
+  if (handle == nullptr) {
+    try {
+      handle = createHandle();
+    } catch (...) {
+      release(nullptr, host);
+      throw;
+    }
+  }
+  return Lease(this, handle, host);
+}
+
+void HttpConnectionPool::recordTransfer(CURL* handle) {
+  long connects = 0;
+  curl_off_t connect_us = 0;
+  curl_off_t app_connect_us = 0;
+  curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+  curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect_us);
+  curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME_T, &app_connect_us);
+
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  ++stats_.requests;
+  if (connects == 0) {
+    ++stats_.reused_connections;
+    return;
+  }
+
+  stats_.new_connections += static_cast<std::uint64_t>(connects);
+  stats_.connect_time += std::chrono::microseconds(connect_us);
+  if (app_connect_us > connect_us) {
+    ++stats_.tls_handshakes;
+    stats_.tls_handshake_time += std::chrono::microseconds(app_connect_us - connect_us);
+  }
+}
+
+void HttpConnectionPool::setMaxConnectionsPerHost(std::size_t limit) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_connections_per_host_ = std::max<std::size_t>(1, limit);
+  }
+  host_available_.notify_all();
+}
+
+HttpConnectionStats HttpConnectionPool::stats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+std::string HttpConnectionPool::hostKey(const std::string& url) {
+  const auto scheme_end = url.find("://");
+  const std::size_t authority_start = scheme_end == std::string::npos ? 0 : scheme_end + 3;
+  const auto authority_end = url.find_first_of("/?#", authority_start);
+  return url.substr(0, authority_end);
+}
+
+void HttpConnectionPool::lockShared(CURL*, curl_lock_data data, curl_lock_access, void* userp) {
+  auto* pool = static_cast<HttpConnectionPool*>(userp);
+  pool->share_locks_[static_cast<std::size_t>(data)].lock();
+}
+
+void HttpConnectionPool::unlockShared(CURL*, curl_lock_data data, void* userp) {
+  auto* pool = static_cast<HttpConnectionPool*>(userp);
+  pool->share_locks_[static_cast<std::size_t>(data)].unlock();
+}
+
+CURL* HttpConnectionPool::createHandle() {
+  CURL* handle = curl_easy_init();
+  if (!handle) {
+    throw std::runtime_error("Failed to initialize CURL easy handle");
+  }
+  curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+  // Worker threads must not receive SIGALRM from DNS timeouts.
+  curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, kTcpKeepIdleSeconds);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, kTcpKeepIntervalSeconds);
+  // Offer every encoding libcurl was built with (gzip, br, ...); bodies are
+  // decoded as they arrive, so write callbacks see plain JSON.
+  curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+  return handle;
+}
+
+void HttpConnectionPool::release(CURL* handle, const std::string& host) {
+  CURL* surplus = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = in_flight_.find(host);
+    if (it != in_flight_.end() && --it->second == 0) {
+      in_flight_.erase(it);
+    }
+    if (handle != nullptr) {
+      if (idle_handles_.size() < max_idle_handles_) {
+        idle_handles_.push_back(handle);
+      } else {
+        surplus = handle;
+      }
+    }
+  }
+  host_available_.notify_all();
+
+  if (surplus != nullptr) {
+    curl_easy_cleanup(surplus);
+  }
+}
+
+}  // namespace market_data
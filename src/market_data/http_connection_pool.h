@@ -0,0 +1,108 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace market_data {
+
+// Connection-level counters aggregated over every transfer made through an
+// HttpConnectionPool.
+struct HttpConnectionStats {
+  std::uint64_t requests = 0;
+  std::uint64_t new_connections = 0;
+  std::uint64_t reused_connections = 0;
+  std::uint64_t tls_handshakes = 0;
+  // Cumulative TCP connect time across new connections.
+  std::chrono::microseconds connect_time{0};
+  // Cumulative TLS handshake time (APPCONNECT - CONNECT) across new connections.
+  std::chrono::microseconds tls_handshake_time{0};
+
+  // Fraction of requests served on an already open connection.
+  double reuseRate() const;
+  std::chrono::microseconds averageConnectTime() const;
+  std::chrono::microseconds averageTlsHandshakeTime() const;
+};
+
+// HttpConnectionPool hands out reusable cURL easy handles that share one
+// connection cache, DNS cache and TLS session cache through a CURLSH, so
+// repeated requests to the same host skip the TCP and TLS handshakes. It also
+// caps how many requests may be in flight per host.
+class HttpConnectionPool {
+ public:
+  class Lease {
+   public:
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&&) = delete;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease();
+
+    CURL* handle() const { return handle_; }
+
+   private:
+    friend class HttpConnectionPool;
+    Lease(HttpConnectionPool* pool, CURL* handle, std::string host);
+
+    HttpConnectionPool* pool_;
+    CURL* handle_;
+    std::string host_;
+  };
+
+  explicit HttpConnectionPool(std::size_t max_connections_per_host = 4,
+                              std::size_t max_idle_handles = 8);
+  ~HttpConnectionPool();
+
+  HttpConnectionPool(const HttpConnectionPool&) = delete;
+  HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+  // Borrows a handle for a request to host (scheme://authority), blocking while
+  // the host already has max_connections_per_host requests in flight.
+  Lease acquire(const std::string& host);
+  // Like acquire, but returns std::nullopt instead of waiting for a busy host.
+  std::optional<Lease> tryAcquire(const std::string& host);
+
+  // Folds the connection info of a completed transfer into the stats.
+  void recordTransfer(CURL* handle);
+
+  void setMaxConnectionsPerHost(std::size_t limit);
+  HttpConnectionStats stats() const;
+
+  // Extracts the scheme://authority part of url, used as the per-host key.
+  static std::string hostKey(const std::string& url);
+
+ private:
+  static void lockShared(CURL* handle, curl_lock_data data, curl_lock_access access, void* userp);
+  static void unlockShared(CURL* handle, curl_lock_data data, void* userp);
+
+  // Requires mutex_.
+  bool hostAvailableLocked(const std::string& host) const;
+  // Counts the lease against host and releases lock before creating a handle.
+  Lease leaseLocked(std::unique_lock<std::mutex>& lock, const std::string& host);
+  CURL* createHandle();
+  void release(CURL* handle, const std::string& host);
+
+  CURLSH* share_ = nullptr;
+  std::array<std::mutex, CURL_LOCK_DATA_LAST> share_locks_;
+
+  std::mutex mutex_;
+  std::condition_variable host_available_;
+  std::size_t max_connections_per_host_;
+  const std::size_t max_idle_handles_;
+  std::vector<CURL*> idle_handles_;
+  std::unordered_map<std::string, std::size_t> in_flight_;
+
+  mutable std::mutex stats_mutex_;
+  HttpConnectionStats stats_;
+};
+
+}  // namespace market_data
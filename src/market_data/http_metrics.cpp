@@ -0,0 +1,163 @@
+#include "market_data/http_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace market_data {
+namespace {
+constexpr auto kSlowSampleInterval = std::chrono::seconds(1);
+
+std::chrono::microseconds infoMicros(CURL* handle, CURLINFO info) {
+  curl_off_t value = 0;
+  if (curl_easy_getinfo(handle, info, &value) != CURLE_OK || value < 0) {
+    return std::chrono::microseconds(0);
+  }
+  return std::chrono::microseconds(value);
+}
+
+std::chrono::microseconds phase(std::chrono::microseconds end, std::chrono::microseconds start) {
+  return end > start ? end - start : std::chrono::microseconds(0);
+}
+}  // namespace
+
+HttpTiming HttpTiming::fromHandle(CURL* handle) {
+  // libcurl reports each phase as the time from the start of the transfer
+  // until it completed.
+  const auto name_lookup = infoMicros(handle, CURLINFO_NAMELOOKUP_TIME_T);
+  const auto connected = infoMicros(handle, CURLINFO_CONNECT_TIME_T);
+  const auto app_connected = infoMicros(handle, CURLINFO_APPCONNECT_TIME_T);
+
+  HttpTiming timing;
+  timing.dns = name_lookup;
+  timing.connect = phase(connected, name_lookup);
+  timing.tls_handshake = app_connected.count() > 0 ? phase(app_connected, connected)
+                                                   : std::chrono::microseconds(0);
+  timing.first_byte = infoMicros(handle, CURLINFO_STARTTRANSFER_TIME_T);
+  timing.total = infoMicros(handle, CURLINFO_TOTAL_TIME_T);
+  curl_off_t downloaded = 0;
+  if (curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &downloaded) == CURLE_OK &&
+      downloaded > 0) {
+    timing.response_bytes = static_cast<std::uint64_t>(downloaded);
+  }
+  return timing;
+}
+
+std::string describeTiming(long status_code, const HttpTiming& timing) {
+  const auto millis = [](std::chrono::microseconds value) { return value.count() / 1000.0; };
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1);
+  if (status_code > 0) {
+    out << "HTTP " << status_code;
+  } else {
+    out << "failed";
+  }
+  out << " in " << millis(timing.total) << " ms (dns " << millis(timing.dns) << " ms, connect "
+      << millis(timing.connect) << " ms, tls " << millis(timing.tls_handshake)
+      << " ms, first byte " << millis(timing.first_byte) << " ms, " << timing.response_bytes
+      << " bytes)";
+  return out.str();
+}
+
+void Histogram::record(std::uint64_t value) {
+  ++counts_[bucketFor(value)];
+  ++count_;
+  sum_ += value;
+  max_ = std::max(max_, value);
+}
+
+double Histogram::mean() const {
+  return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_);
+}
+
+std::uint64_t Histogram::percentile(double quantile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const double clamped = std::clamp(quantile, 0.0, 1.0);
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(count_))));
+  std::uint64_t seen = 0;
+  for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+    seen += counts_[bucket];
+    if (seen >= rank) {
+      return std::min(bucketUpperBound(bucket), max_);
+    }
+  }
+  return max_;
+}
+
+std::size_t Histogram::bucketFor(std::uint64_t value) {
+  constexpr std::uint64_t kSubBuckets = std::uint64_t{1} << kSubBucketBits;
+  if (value < kSubBuckets) {
+    return static_cast<std::size_t>(value);
+  }
+  std::size_t top_bit = 63;
+  while ((value >> top_bit) == 0) {
+    --top_bit;
+  }
+  const std::size_t shift = top_bit - kSubBucketBits;
+  const auto sub_bucket = static_cast<std::size_t>((value >> shift) & (kSubBuckets - 1));
+  return ((shift + 1) << kSubBucketBits) + sub_bucket;
+}
+
+std::uint64_t Histogram::bucketUpperBound(std::size_t bucket) {
+  constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const std::size_t shift = (bucket >> kSubBucketBits) - 1;
+  const std::uint64_t lower = static_cast<std::uint64_t>(kSubBuckets + bucket % kSubBuckets)
+                              << shift;
+  return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+void HttpMetrics::setSlowRequestThreshold(std::chrono::milliseconds threshold) {
+  slow_threshold_ms_.store(std::max<long long>(0, threshold.count()));
+}
+
+bool HttpMetrics::record(const std::string& endpoint,
+                         long status_code,
+                         const HttpTiming& timing) {
+  const std::chrono::milliseconds threshold{slow_threshold_ms_.load()};
+  const bool slow = threshold.count() > 0 && timing.total > threshold;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = endpoints_[endpoint];
+  EndpointMetrics& metrics = entry.metrics;
+  ++metrics.requests;
+  if (status_code > 0) {
+    ++metrics.status_codes[status_code];
+  } else {
+    ++metrics.transport_errors;
+  }
+  metrics.dns.record(static_cast<std::uint64_t>(timing.dns.count()));
+  metrics.connect.record(static_cast<std::uint64_t>(timing.connect.count()));
+  metrics.tls_handshake.record(static_cast<std::uint64_t>(timing.tls_handshake.count()));
+  metrics.first_byte.record(static_cast<std::uint64_t>(timing.first_byte.count()));
+  metrics.total.record(static_cast<std::uint64_t>(timing.total.count()));
+  metrics.response_bytes.record(timing.response_bytes);
+  if (!slow) {
+    return false;
+  }
+
+  ++metrics.slow_requests;
+  const auto now = std::chrono::steady_clock::now();
+  if (metrics.slow_requests > 1 && now - entry.last_sampled < kSlowSampleInterval) {
+    return false;
+  }
+  entry.last_sampled = now;
+  return true;
+}
+
+std::unordered_map<std::string, EndpointMetrics> HttpMetrics::snapshot() const {
+  std::unordered_map<std::string, EndpointMetrics> snapshot;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [endpoint, entry] : endpoints_) {
+    snapshot.emplace(endpoint, entry.metrics);
+  }
+  return snapshot;
+}
+
+}  // namespace market_data
@@ -0,0 +1,356 @@
+#include "market_data/json_cursor.h"
+
+#include <charconv>
+
+namespace market_data {
+namespace {
+
+bool isWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+void appendUtf8(std::string& out, std::uint32_t code_point) {
+  if (code_point < 0x80) {
+    out.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+}  // namespace
+
+JsonCursor::Kind JsonCursor::peek() {
+  switch (current()) {
+    case '{':
+      return Kind::Object;
+    case '[':
+      return Kind::Array;
+    case '"':
+      return Kind::String;
+    case 't':
+    case 'f':
+      return Kind::Boolean;
+    case 'n':
+      return Kind::Null;
+    default:
+      if (current() == '-' || isDigit(current())) {
+        return Kind::Number;
+      }
+      fail("Invalid JSON value");
+  }
+}
+
+void JsonCursor::expectEnd() {
+  skipWhitespace();
+  if (pos_ != text_.size()) {
+    fail("Unexpected trailing characters in JSON");
+  }
+}
+
+void JsonCursor::skipValue() {
+  switch (peek()) {
+    case Kind::Object: {
+      enterObject();
+      std::string scratch;
+      std::string_view key;
+      while (nextMember(key, scratch)) {
+        skipValue();
+      }
+      break;
+    }
+    case Kind::Array:
+      enterArray();
+      while (nextElement()) {
+        skipValue();
+      }
+      break;
+    case Kind::String: {
+      ++pos_;
+      while (pos_ < text_.size() && text_[pos_] != '"') {
+        pos_ += text_[pos_] == '\\' ? 2 : 1;
+      }
+      if (pos_ >= text_.size()) {
+        fail("Unterminated string");
+      }
+      ++pos_;
+      break;
+    }
+    case Kind::Number:
+      scanNumber();
+      break;
+    case Kind::Boolean:
+      readBoolean();
+      break;
+    case Kind::Null:
+      readNull();
+      break;
+  }
+}
+
+std::string_view JsonCursor::readString(std::string& scratch) {
+  expect('"');
+  const std::size_t begin = pos_;
+  while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\\') {
+    ++pos_;
+  }
+  if (pos_ >= text_.size()) {
+    fail("Unterminated string");
+  }
+  if (text_[pos_] == '"') {
+    return text_.substr(begin, pos_++ - begin);
+  }
+
+  scratch.assign(text_.data() + begin, pos_ - begin);
+  while (pos_ < text_.size()) {
+    const char c = text_[pos_++];
+    if (c == '"') {
+      return scratch;
+    }
+    if (c != '\\') {
+      scratch.push_back(c);
+      continue;
+    }
+    if (pos_ >= text_.size()) {
+      break;
+    }
+    const char escape = text_[pos_++];
+    switch (escape) {
+      case '"':
+      case '\\':
+      case '/':
+        scratch.push_back(escape);
+        break;
+      case 'b':
+        scratch.push_back('\b');
+        break;
+      case 'f':
+        scratch.push_back('\f');
+        break;
+      case 'n':
+        scratch.push_back('\n');
+        break;
+      case 'r':
+        scratch.push_back('\r');
+        break;
+      case 't':
+        scratch.push_back('\t');
+        break;
+      case 'u': {
+        const auto readUnit = [this]() {
+          if (pos_ + 4 > text_.size()) {
+            fail("Invalid unicode escape");
+          }
+          std::uint32_t unit = 0;
+          for (int i = 0; i < 4; ++i) {
+            const int digit = hexValue(text_[pos_++]);
+            if (digit < 0) {
+              fail("Invalid unicode escape");
+            }
+            unit = (unit << 4) | static_cast<std::uint32_t>(digit);
+          }
+          return unit;
+        };
+        std::uint32_t code_point = readUnit();
+        if (code_point >= 0xD800 && code_point <= 0xDBFF && text_.substr(pos_, 2) == "\\u") {
+          pos_ += 2;
+          const std::uint32_t low = readUnit();
+          if (low < 0xDC00 || low > 0xDFFF) {
+            fail("Invalid unicode surrogate pair");
+          }
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        }
+        appendUtf8(scratch, code_point);
+        break;
+      }
+      default:
+        fail("Unsupported escape sequence");
+    }
+  }
+  fail("Unterminated string");
+}
+
+double JsonCursor::readNumber() {
+  if (peek() != Kind::Number) {
+    fail("Expected number");
+  }
+  const std::string_view token = scanNumber();
+  double value = 0.0;
+  const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+  if (error == std::errc::result_out_of_range) {
+    fail("Number out of range");
+  }
+  if (error != std::errc() || end != token.data() + token.size()) {
+    fail("Invalid number");
+  }
+  return value;
+}
+
+std::string_view JsonCursor::readNumberText() {
+  if (peek() != Kind::Number) {
+    fail("Expected number");
+  }
+  return scanNumber();
+}
+
+bool JsonCursor::readBoolean() {
+  skipWhitespace();
+  if (text_.substr(pos_, 4) == "true") {
+    pos_ += 4;
+    return true;
+  }
+  if (text_.substr(pos_, 5) == "false") {
+    pos_ += 5;
+    return false;
+  }
+  fail("Invalid literal");
+}
+
+void JsonCursor::readNull() {
+  skipWhitespace();
+  if (text_.substr(pos_, 4) != "null") {
+    fail("Invalid literal");
+  }
+  pos_ += 4;
+}
+
+void JsonCursor::enterObject() {
+  enterContainer('{');
+}
+
+bool JsonCursor::nextMember(std::string_view& key, std::string& scratch) {
+  if (!nextInContainer('}')) {
+    return false;
+  }
+  key = readString(scratch);
+  expect(':');
+  return true;
+}
+
+void JsonCursor::enterArray() {
+  enterContainer('[');
+}
+
+bool JsonCursor::nextElement() {
+  return nextInContainer(']');
+}
+
+void JsonCursor::skipWhitespace() {
+  while (pos_ < text_.size() && isWhitespace(text_[pos_])) {
+    ++pos_;
+  }
+}
+
+char JsonCursor::current() {
+  skipWhitespace();
+  if (pos_ >= text_.size()) {
+    fail("Unexpected end of JSON");
+  }
+  return text_[pos_];
+}
+
+void JsonCursor::expect(char expected) {
+  if (current() != expected) {
+    fail(expected == ':' ? "Expected ':' in object" : "Unexpected character in JSON");
+  }
+  ++pos_;
+}
+
+void JsonCursor::enterContainer(char open) {
+  if (depth_ >= kMaxDepth) {
+    fail("JSON nested too deeply");
+  }
+  expect(open);
+  started_ &= ~(std::uint64_t{1} << depth_);
+  ++depth_;
+}
+
+bool JsonCursor::nextInContainer(char close) {
+  if (depth_ == 0) {
+    fail("Not inside a JSON container");
+  }
+  const std::uint64_t bit = std::uint64_t{1} << (depth_ - 1);
+  const char c = current();
+  if (c == close) {
+    ++pos_;
+    --depth_;
+    return false;
+  }
+  if ((started_ & bit) != 0) {
+    if (c != ',') {
+      fail(close == '}' ? "Expected ',' in object" : "Expected ',' in array");
+    }
+    ++pos_;
+    if (current() == close) {
+      fail("Trailing ',' in JSON");
+    }
+  }
+  started_ |= bit;
+  return true;
+}
+
+std::string_view JsonCursor::scanNumber() {
+  skipWhitespace();
+  const std::size_t begin = pos_;
+  if (pos_ < text_.size() && text_[pos_] == '-') {
+    ++pos_;
+  }
+  const auto skipDigits = [this]() {
+    const std::size_t start = pos_;
+    while (pos_ < text_.size() && isDigit(text_[pos_])) {
+      ++pos_;
+    }
+    return pos_ > start;
+  };
+  if (!skipDigits()) {
+    fail("Invalid number");
+  }
+  if (pos_ < text_.size() && text_[pos_] == '.') {
+    ++pos_;
+    if (!skipDigits()) {
+      fail("Invalid number");
+    }
+  }
+  if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+    ++pos_;
+    if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+      ++pos_;
+    }
+    if (!skipDigits()) {
+      fail("Invalid number");
+    }
+  }
+  return text_.substr(begin, pos_ - begin);
+}
+
+void JsonCursor::fail(const char* message) const {
+  throw JsonParseError(std::string(message) + " at offset " + std::to_string(pos_));
+}
+
+}  // namespace market_data
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace market_data {
+
+class JsonParseError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// JsonCursor walks a JSON document in place without building a DOM. Callers
+// pull exactly the values they need and skip the rest; strings without escape
+// sequences are returned as views into the document. Cursors are cheap to copy,
+// so a copy can probe ahead (e.g. look for a wrapper key) without moving the
+// original. Malformed input raises JsonParseError.
+class JsonCursor {
+ public:
+  enum class Kind { Object, Array, String, Number, Boolean, Null };
+
+  explicit JsonCursor(std::string_view text) : text_(text) {}
+
+  // Kind of the next value. Throws at the end of the document.
+  Kind peek();
+  // Throws unless only whitespace remains.
+  void expectEnd();
+
+  void skipValue();
+  // The view points into the document, or into scratch when the string had to
+  // be unescaped; either way it is valid until scratch or the document change.
+  std::string_view readString(std::string& scratch);
+  double readNumber();
+  // The number's literal text, for callers that convert it themselves (e.g.
+  // exactly, as an integer).
+  std::string_view readNumberText();
+  bool readBoolean();
+  void readNull();
+
+  // Object members: enterObject(), then nextMember() until it returns false.
+  // After each true return the cursor sits on the member's value, which must
+  // be read or skipped before the next call.
+  void enterObject();
+  bool nextMember(std::string_view& key, std::string& scratch);
+
+  // Array elements: enterArray(), then nextElement() until it returns false,
+  // reading or skipping each element in between.
+  void enterArray();
+  bool nextElement();
+
+ private:
+  static constexpr std::size_t kMaxDepth = 64;
+
+  void skipWhitespace();
+  char current();
+  void expect(char expected);
+  void enterContainer(char open);
+  // Advances past a separator or the closing bracket of the innermost container.
+  bool nextInContainer(char close);
+  std::string_view scanNumber();
+  [[noreturn]] void fail(const char* message) const;
+
+  std::string_view text_;
+  std::size_t pos_ = 0;
+  std::size_t depth_ = 0;
+  // Bit d set once the container at depth d has yielded its first entry.
+  std::uint64_t started_ = 0;
+};
+
+}  // namespace market_data
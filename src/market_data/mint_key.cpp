@@ -0,0 +1,105 @@
+#include "market_data/mint_key.h"
+
+#include <stdexcept>
+
+namespace market_data {
+namespace {
+
+constexpr char kAlphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+// The longest base58 encoding of 32 bytes.
+constexpr std::size_t kMaxEncodedLength = 44;
+
+int digitValue(char c) {
+  static const auto kDigits = [] {
+    std::array<std::int8_t, 256> digits{};
+    digits.fill(-1);
+    for (int i = 0; i < 58; ++i) {
+      digits[static_cast<unsigned char>(kAlphabet[i])] = static_cast<std::int8_t>(i);
+    }
+    return digits;
+  }();
+  return kDigits[static_cast<unsigned char>(c)];
+}
+
+}  // namespace
+
+MintKey MintKey::fromBase58(std::string_view text) {
+  MintKey key;
+  if (!tryParse(text, key)) {
+    throw std::invalid_argument("Not a base58 mint address: " + std::string(text));
+  }
+  return key;
+}
+
+bool MintKey::tryParse(std::string_view text, MintKey& out) {
+  if (text.empty() || text.size() > kMaxEncodedLength) {
+    return false;
+  }
+  std::size_t leading_ones = 0;
+  while (leading_ones < text.size() && text[leading_ones] == '1') {
+    ++leading_ones;
+  }
+
+  // Big-endian base-256 accumulator; a carry out of the top byte means the
+  // value needs more than 32 bytes.
+  Bytes bytes{};
+  for (const char c : text) {
+    const int digit = digitValue(c);
+    if (digit < 0) {
+      return false;
+    }
+    unsigned carry = static_cast<unsigned>(digit);
+    for (std::size_t i = kSize; i-- > 0;) {
+      carry += 58u * bytes[i];
+      bytes[i] = static_cast<std::uint8_t>(carry);
+      carry >>= 8;
+    }
+    if (carry != 0) {
+      return false;
+    }
+  }
+
+  // Each leading '1' encodes one leading zero byte, so the decoded length is
+  // exactly 32 only if they match the accumulator's leading zeros.
+  std::size_t leading_zeros = 0;
+  while (leading_zeros < kSize && bytes[leading_zeros] == 0) {
+    ++leading_zeros;
+  }
+  if (leading_zeros != leading_ones) {
+    return false;
+  }
+  out.bytes_ = bytes;
+  return true;
+}
+
+std::string MintKey::toBase58() const {
+  std::size_t leading_zeros = 0;
+  while (leading_zeros < kSize && bytes_[leading_zeros] == 0) {
+    ++leading_zeros;
+  }
+
+  // Little-endian base-58 digits of the value.
+  std::array<std::uint8_t, kMaxEncodedLength> digits{};
+  std::size_t length = 0;
+  for (std::size_t i = leading_zeros; i < kSize; ++i) {
+    unsigned carry = bytes_[i];
+    for (std::size_t j = 0; j < length; ++j) {
+      carry += static_cast<unsigned>(digits[j]) << 8;
+      digits[j] = static_cast<std::uint8_t>(carry % 58);
+      carry /= 58;
+    }
+    while (carry > 0) {
+      digits[length++] = static_cast<std::uint8_t>(carry % 58);
+      carry /= 58;
+    }
+  }
+
+  std::string text(leading_zeros, '1');
+  text.reserve(leading_zeros + length);
+  for (std::size_t j = length; j-- > 0;) {
+    text += kAlphabet[digits[j]];
+  }
+  return text;
+}
+
+}  // namespace market_data
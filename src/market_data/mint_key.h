@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace market_data {
+
+// MintKey is a Solana mint address as its 32 raw public-key bytes, decoded
+// from base58 once at ingest. It is trivially copyable, needs no heap and
+// compares with a memcmp, so it can key per-mint tables on hot paths instead
+// of the 32-44 character address text.
+class MintKey {
+ public:
+  static constexpr std::size_t kSize = 32;
+  using Bytes = std::array<std::uint8_t, kSize>;
+
+  MintKey() = default;
+  explicit MintKey(const Bytes& bytes) : bytes_(bytes) {}
+
+  // Throws std::invalid_argument unless text is the base58 encoding of
+  // exactly 32 bytes.
+  static MintKey fromBase58(std::string_view text);
+  // Non-throwing variant of fromBase58; leaves out untouched on failure.
+  static bool tryParse(std::string_view text, MintKey& out);
+
+  std::string toBase58() const;
+
+  const Bytes& bytes() const { return bytes_; }
+
+  // Mint addresses are ed25519 public keys, so their bytes are already
+  // uniformly distributed: the leading eight serve as the hash as-is.
+  // (Vanity mints grind the base58 suffix, which lands in the trailing bytes.)
+  std::size_t hash() const {
+    std::uint64_t prefix;
+    std::memcpy(&prefix, bytes_.data(), sizeof(prefix));
+    return static_cast<std::size_t>(prefix);
+  }
+
+  friend bool operator==(const MintKey& lhs, const MintKey& rhs) {
+    return std::memcmp(lhs.bytes_.data(), rhs.bytes_.data(), kSize) == 0;
+  }
+  friend bool operator!=(const MintKey& lhs, const MintKey& rhs) { return !(lhs == rhs); }
+  friend bool operator<(const MintKey& lhs, const MintKey& rhs) {
+    return std::memcmp(lhs.bytes_.data(), rhs.bytes_.data(), kSize) < 0;
+  }
+
+ private:
+  Bytes bytes_{};
+};
+
+}  // namespace market_data
+
+namespace std {
+template <>
+struct hash<market_data::MintKey> {
+  std::size_t operator()(const market_data::MintKey& key) const noexcept { return key.hash(); }
+};
+}  // namespace std
@@ -1,17 +1,23 @@
 #include "market_data/pumpfun_client.h"
 
 #include "common/logging.h"
+#include "market_data/json_cursor.h"
+#include "market_data/response_parser.h"
 
 #include <curl/curl.h>
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <chrono>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <thread>
 
@@ -57,6 +63,14 @@ CurlGlobalGuard& curlGlobalGuard() {
   return guard;
 }
 
+std::runtime_error parseFailure(const std::string& payload,
+                                const std::string& context,
+                                const std::exception& ex) {
+  const std::string snippet = payload.size() > 256 ? payload.substr(0, 256) + "..." : payload;
+  return std::runtime_error("Failed to parse " + context + " response: " + std::string(ex.what()) +
+                            " (payload snippet: " + snippet + ")");
+}
+
 nlohmann::json parseJsonOrThrow(const std::string& payload, const std::string& context) {
   try {
     if (payload.empty()) {
@@ -64,10 +78,19 @@ nlohmann::json parseJsonOrThrow(const std::string& payload, const std::string& c
     }
     return nlohmann::json::parse(payload);
   } catch (const nlohmann::json::exception& ex) {
-    const std::string snippet = payload.size() > 256 ? payload.substr(0, 256) + "..." : payload;
-    throw std::runtime_error("Failed to parse " + context +
-                             " response: " + std::string(ex.what()) + " (payload snippet: " + snippet + ")");
+    throw parseFailure(payload, context, ex);
+  }
+}
+
+std::string joinMints(const std::vector<std::string>& token_mints) {
+  std::string joined;
+  for (const auto& mint : token_mints) {
+    if (!joined.empty()) {
+      joined += ',';
+    }
+    joined += mint;
   }
+  return joined;
 }
 
 std::string normalizeBaseUrl(std::string url) {
@@ -77,6 +100,48 @@ std::string normalizeBaseUrl(std::string url) {
   return url;
 }
 
+constexpr auto kMetadataCacheTtl = std::chrono::minutes(5);
+constexpr auto kCandlesCacheTtl = std::chrono::seconds(30);
+constexpr auto kMaxRetryBackoff = std::chrono::seconds(30);
+
+// Provider routing: weight of the newest sample in the latency and error-rate
+// averages, how much a fully failing provider's latency is inflated, and how
+// fast an idle provider's error rate is forgiven.
+constexpr double kHealthSampleWeight = 0.2;
+constexpr double kErrorRatePenalty = 4.0;
+constexpr auto kErrorRateHalfLife = std::chrono::seconds(60);
+constexpr auto kProviderBackoff = std::chrono::seconds(1);
+constexpr auto kMaxProviderBackoff = std::chrono::seconds(30);
+
+double decayedErrorRate(double error_rate, std::chrono::steady_clock::duration idle) {
+  const double half_lives =
+      std::chrono::duration<double>(idle) / std::chrono::duration<double>(kErrorRateHalfLife);
+  return half_lives > 0.0 ? error_rate * std::exp2(-half_lives) : error_rate;
+}
+
+// Does endpoint fall under prefix, either exactly or as a sub-path?
+bool underPrefix(const std::string& endpoint, const std::string& prefix) {
+  return !prefix.empty() && endpoint.compare(0, prefix.size(), prefix) == 0 &&
+         (endpoint.size() == prefix.size() || endpoint[prefix.size()] == '/');
+}
+
+std::mt19937_64& jitterEngine() {
+  thread_local std::mt19937_64 engine{std::random_device{}()};
+  return engine;
+}
+
+bool equalsIgnoreCase(const char* data, std::size_t size, const std::string& expected) {
+  if (size != expected.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < size; ++i) {
+    if (std::tolower(static_cast<unsigned char>(data[i])) != expected[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 std::string ensureEndpoint(const std::string& endpoint) {
   if (endpoint.empty()) {
     return endpoint;
@@ -88,6 +153,35 @@ std::string ensureEndpoint(const std::string& endpoint) {
 }
 }  // namespace
 
+bool CompactQuote::fromQuote(const TokenQuote& quote, CompactQuote& out) {
+  MintKey mint;
+  if (!MintKey::tryParse(quote.mint, mint)) {
+    return false;
+  }
+  out.mint = mint;
+  out.price = quote.price;
+  out.price_change_24h = quote.price_change_24h;
+  out.volume_24h = quote.volume_24h;
+  out.liquidity = quote.liquidity;
+  out.timestamp_ns = quote.timestamp_ns;
+  return true;
+}
+
+TokenQuote CompactQuote::toQuote() const {
+  return toQuote(mint.toBase58());
+}
+
+TokenQuote CompactQuote::toQuote(std::string mint_text) const {
+  TokenQuote quote;
+  quote.mint = std::move(mint_text);
+  quote.price = price;
+  quote.price_change_24h = price_change_24h;
+  quote.volume_24h = volume_24h;
+  quote.liquidity = liquidity;
+  quote.timestamp_ns = timestamp_ns;
+  return quote;
+}
+
 PumpFunClient::PumpFunClient(std::string base_url,
                              std::string api_key,
                              std::string metadata_endpoint,
@@ -102,15 +196,49 @@ PumpFunClient::PumpFunClient(std::string base_url,
       http_getter_(std::move(http_getter)) {
   curlGlobalGuard().acquire();
   curl_initialized_ = true;
+  connection_pool_ = std::make_unique<HttpConnectionPool>();
+
+  auto primary = std::make_shared<Provider>();
+  primary->config.name = base_url_;
+  primary->config.base_url = base_url_;
+  primary->config.api_key = api_key_;
+  primary->config.metadata_endpoint = metadata_endpoint_;
+  primary->config.quote_endpoint = quote_endpoint_;
+  primary->config.candles_endpoint = candles_endpoint_;
+  primary->host_key = HttpConnectionPool::hostKey(base_url_);
+  primary->health.name = primary->config.name;
+  primary->health.base_url = base_url_;
+  providers_.push_back(std::move(primary));
 
   if (!api_key_.empty()) {
     default_headers_["x-api-key"] = api_key_;
   }
+  refreshDefaultHeaderListLocked();
+
+  if (!metadata_endpoint_.empty()) {
+    cache_ttls_.emplace_back(metadata_endpoint_, kMetadataCacheTtl);
+  }
+  if (!candles_endpoint_.empty()) {
+    cache_ttls_.emplace_back(candles_endpoint_, kCandlesCacheTtl);
+  }
 }
 
 PumpFunClient::~PumpFunClient() {
   running_ = false;
   drainSubscriptions();
+  {
+    std::unique_ptr<CurlMultiLoop> loop;
+    {
+      std::lock_guard<std::mutex> lock(polling_mutex_);
+      loop = std::move(multi_loop_);
+    }
+    if (loop) {
+      loop->stop();
+    }
+  }
+  stopPollWorkers();
+  connection_pool_.reset();
+  providers_.clear();
 
   if (curl_initialized_) {
     curlGlobalGuard().release();
@@ -124,6 +252,7 @@ void PumpFunClient::setDefaultHeaders(std::unordered_map<std::string, std::strin
   if (!api_key_.empty() && default_headers_.find("x-api-key") == default_headers_.end()) {
     default_headers_["x-api-key"] = api_key_;
   }
+  refreshDefaultHeaderListLocked();
 }
 
 std::unordered_map<std::string, std::string> PumpFunClient::defaultHeaders() const {
@@ -144,6 +273,29 @@ void PumpFunClient::setRetryPolicy(std::size_t max_attempts,
   retry_backoff_ms_.store(initial_backoff.count());
 }
 
+void PumpFunClient::setTimerWheel(std::shared_ptr<common::TimerWheel> timers) {
+  if (!timers) {
+    throw std::invalid_argument("Timer wheel must be valid");
+  }
+  std::lock_guard<std::mutex> lock(polling_mutex_);
+  if (!poll_workers_.empty() || multi_loop_) {
+    throw std::logic_error("Timer wheel must be configured before subscribing");
+  }
+  timers_ = std::move(timers);
+  owns_timers_ = false;
+}
+
+void PumpFunClient::setPollingConcurrency(std::size_t workers) {
+  if (workers == 0) {
+    throw std::invalid_argument("Polling concurrency must be at least 1");
+  }
+  std::lock_guard<std::mutex> lock(polling_mutex_);
+  if (!poll_workers_.empty() || multi_loop_) {
+    throw std::logic_error("Polling concurrency must be configured before subscribing");
+  }
+  poll_worker_count_ = workers;
+}
+
 TokenMetadata PumpFunClient::fetchTokenMetadata(
     const std::string& token_mint,
     const std::unordered_map<std::string, std::string>& extra_headers) const {
@@ -152,7 +304,7 @@ TokenMetadata PumpFunClient::fetchTokenMetadata(
     endpoint += "/" + token_mint;
   }
 
-  const std::string response = performGet(endpoint, {}, extra_headers);
+  const std::string response = performGet(endpoint, {}, extra_headers, RequestPriority::Metadata);
 
   nlohmann::json json = parseJsonOrThrow(response, "token metadata");
   if (json.contains("result")) {
@@ -171,25 +323,123 @@ TokenMetadata PumpFunClient::fetchTokenMetadata(
 TokenQuote PumpFunClient::fetchTokenQuote(
     const std::string& token_mint,
     const std::unordered_map<std::string, std::string>& extra_headers) const {
-  std::string endpoint = quote_endpoint_;
-  if (!endpoint.empty()) {
-    endpoint += "/" + token_mint;
+  return quoteFromResponse(
+      performGet(quoteEndpointFor(token_mint), {}, extra_headers, quotePriority(token_mint)));
+}
+
+std::unordered_map<std::string, TokenQuote> PumpFunClient::fetchTokenQuotes(
+    const std::vector<std::string>& token_mints,
+    const std::unordered_map<std::string, std::string>& extra_headers) const {
+  std::vector<std::string> unique_mints;
+  std::unordered_set<std::string> seen;
+  for (const auto& mint : token_mints) {
+    if (!mint.empty() && seen.insert(mint).second) {
+      unique_mints.push_back(mint);
+    }
   }
 
-  const std::string response = performGet(endpoint, {}, extra_headers);
+  const BatchQuoteConfig config = batchQuoteConfig();
+  const std::size_t chunk_size = config.endpoint.empty() ? 1 : config.max_mints;
+  std::vector<std::vector<std::string>> chunks;
+  for (std::size_t begin = 0; begin < unique_mints.size(); begin += chunk_size) {
+    const std::size_t end = std::min(unique_mints.size(), begin + chunk_size);
+    chunks.emplace_back(unique_mints.begin() + begin, unique_mints.begin() + end);
+  }
 
-  nlohmann::json json = parseJsonOrThrow(response, "token quote");
-  if (json.contains("result")) {
-    json = json["result"];
+  std::mutex results_mutex;
+  std::unordered_map<std::string, TokenQuote> quotes;
+  std::vector<std::string> errors;
+  std::atomic<std::size_t> next_chunk{0};
+  const auto worker = [&]() {
+    for (std::size_t index = next_chunk++; index < chunks.size(); index = next_chunk++) {
+      try {
+        auto chunk_quotes = fetchQuoteChunk(chunks[index], config, extra_headers);
+        std::lock_guard<std::mutex> lock(results_mutex);
+        for (auto& [mint, quote] : chunk_quotes) {
+          quotes.insert_or_assign(mint, std::move(quote));
+        }
+      } catch (const std::exception& ex) {
+        std::lock_guard<std::mutex> lock(results_mutex);
+        errors.emplace_back(ex.what());
+      }
+    }
+  };
+
+  // The calling thread works too; helpers stay within the per-host connection limit.
+  const std::size_t parallelism =
+      std::min(chunks.size(), std::max<std::size_t>(1, max_connections_per_host_.load()));
+  std::vector<std::future<void>> helpers;
+  for (std::size_t i = 1; i < parallelism; ++i) {
+    helpers.push_back(std::async(std::launch::async, worker));
   }
-  if (json.contains("data") && json["data"].is_object()) {
-    json = json["data"];
+  worker();
+  for (auto& helper : helpers) {
+    helper.get();
+  }
+
+  if (!errors.empty()) {
+    if (errors.size() == chunks.size()) {
+      throw std::runtime_error("Failed to fetch quotes for " + std::to_string(unique_mints.size()) +
+                               " mints: " + errors.front());
+    }
+    LOG_WARN("PumpFunClient batch quote fetch: " + std::to_string(errors.size()) + " of " +
+             std::to_string(chunks.size()) + " requests failed: " + errors.front());
+  }
+  return quotes;
+}
+
+std::unordered_map<std::string, TokenQuote> PumpFunClient::fetchQuoteChunk(
+    const std::vector<std::string>& token_mints,
+    const BatchQuoteConfig& config,
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    std::size_t max_attempts) const {
+  std::unordered_map<std::string, TokenQuote> quotes;
+  if (config.endpoint.empty()) {
+    for (const auto& mint : token_mints) {
+      TokenQuote quote = fetchTokenQuote(mint, extra_headers);
+      if (quote.mint.empty()) {
+        quote.mint = mint;
+      }
+      quotes.insert_or_assign(mint, std::move(quote));
+    }
+    return quotes;
+  }
+
+  const std::string response =
+      performGet(config.endpoint, {{config.query_param, joinMints(token_mints)}}, extra_headers,
+                 quotePriority(token_mints), max_attempts);
+  return quotesFromBatchResponse(response, token_mints);
+}
+
+std::unordered_map<std::string, TokenQuote> PumpFunClient::quotesFromBatchResponse(
+    const std::string& response,
+    const std::vector<std::string>& token_mints) const {
+  try {
+    return parseBatchQuoteResponse(response, token_mints, &quote_layout_);
+  } catch (const JsonParseError& ex) {
+    throw parseFailure(response, "batch quotes", ex);
   }
-  if (json.is_array() && !json.empty()) {
-    json = json.front();
+}
+
+PumpFunClient::BatchQuoteConfig PumpFunClient::batchQuoteConfig() const {
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  return batch_quotes_;
+}
+
+std::string PumpFunClient::quoteEndpointFor(const std::string& token_mint) const {
+  std::string endpoint = quote_endpoint_;
+  if (!endpoint.empty()) {
+    endpoint += "/" + token_mint;
   }
+  return endpoint;
+}
 
-  return parseTokenQuote(json);
+TokenQuote PumpFunClient::quoteFromResponse(const std::string& response) const {
+  try {
+    return parseQuoteResponse(response, &quote_layout_);
+  } catch (const JsonParseError& ex) {
+    throw parseFailure(response, "token quote", ex);
+  }
 }
 
 std::vector<HistoricalCandle> PumpFunClient::fetchHistoricalCandles(
@@ -206,35 +456,51 @@ std::vector<HistoricalCandle> PumpFunClient::fetchHistoricalCandles(
       {"limit", std::to_string(limit)},
   };
 
-  std::string endpoint = candles_endpoint_;
-  if (!endpoint.empty()) {
-    endpoint += "/" + token_mint;
+  const std::string response = performGet(candlesEndpointFor(token_mint), query_params,
+                                          extra_headers, RequestPriority::Candles);
+  try {
+    return parseCandlesResponse(response, token_mint, timeframe, &candle_layout_);
+  } catch (const JsonParseError& ex) {
+    throw parseFailure(response, "historical candles", ex);
   }
+}
 
-  const std::string response = performGet(endpoint, query_params, extra_headers);
-
-  nlohmann::json json = parseJsonOrThrow(response, "historical candles");
-  if (json.contains("result")) {
-    json = json["result"];
-  }
-  if (json.contains("data")) {
-    json = json["data"];
-  }
-  if (json.contains("candles")) {
-    json = json["candles"];
+std::size_t PumpFunClient::streamHistoricalCandles(
+    const std::string& token_mint,
+    const std::string& timeframe,
+    int limit,
+    const CandleCallback& on_candle,
+    const std::unordered_map<std::string, std::string>& extra_headers) const {
+  if (limit <= 0) {
+    throw std::invalid_argument("limit must be greater than zero");
   }
 
-  std::vector<HistoricalCandle> candles;
-  if (json.is_array()) {
-    candles.reserve(json.size());
-    for (const auto& entry : json) {
-      candles.push_back(parseHistoricalCandle(entry, token_mint, timeframe));
-    }
-  } else if (!json.is_null()) {
-    candles.push_back(parseHistoricalCandle(json, token_mint, timeframe));
+  std::vector<std::pair<std::string, std::string>> query_params = {
+      {"timeframe", timeframe},
+      {"limit", std::to_string(limit)},
+  };
+
+  CandleStreamParser parser(token_mint, timeframe, on_candle, &candle_layout_);
+  const BodySink sink{[&parser](std::string_view chunk) { parser.feed(chunk); },
+                      [&parser]() { parser.reset(); },
+                      [&parser]() { return parser.candlesDelivered() > 0; }};
+  try {
+    performGetWithRetries(candlesEndpointFor(token_mint), query_params, extra_headers, nullptr,
+                          RequestPriority::Candles, 0, &sink);
+    parser.finish();
+  } catch (const JsonParseError& ex) {
+    throw std::runtime_error("Failed to parse historical candles response: " +
+                             std::string(ex.what()));
   }
+  return parser.candlesDelivered();
+}
 
-  return candles;
+std::string PumpFunClient::candlesEndpointFor(const std::string& token_mint) const {
+  std::string endpoint = candles_endpoint_;
+  if (!endpoint.empty()) {
+    endpoint += "/" + token_mint;
+  }
+  return endpoint;
 }
 
 PumpFunClient::SubscriptionId PumpFunClient::subscribeToQuotes(const std::string& token_mint,
@@ -248,53 +514,52 @@ PumpFunClient::SubscriptionId PumpFunClient::subscribeToQuotes(const std::string
     throw std::runtime_error("PumpFunClient is shutting down");
   }
 
+  auto timers = ensurePollingStarted();
+
   auto subscription = std::make_shared<Subscription>();
   subscription->token_mint = token_mint;
   subscription->callback = std::move(callback);
   subscription->interval = interval;
 
   const SubscriptionId id = next_subscription_id_.fetch_add(1);
+  subscription->id = id;
+
+  common::TimerWheel::TimerId replaced = 0;
   {
+    // Hold the map lock while arming so unsubscribe() always sees the timer id.
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    auto& poll = mint_polls_[token_mint];
+    if (!poll) {
+      poll = std::make_shared<MintPoll>();
+      poll->token_mint = token_mint;
+    }
+    poll->listeners.push_back(subscription);
     subscriptions_.emplace(id, subscription);
+    resetAdaptedIntervalLocked(*poll);
+    replaced = rearmPollLocked(poll, *timers);
+  }
+  if (replaced != 0) {
+    timers->cancel(replaced);
   }
 
-  subscription->worker = std::thread([this, subscription, id]() {
-    while (running_.load() && subscription->active.load()) {
-      try {
-        const TokenQuote quote = fetchTokenQuote(subscription->token_mint);
-        try {
-          subscription->callback(quote);
-          subscription->callback_error.store(false);
-        } catch (const std::exception& callback_ex) {
-          subscription->callback_error.store(true);
-          LOG_ERROR(std::string("PumpFunClient quote callback error (subscription ") +
-                    std::to_string(id) + ", token " + subscription->token_mint + "): " +
-                    callback_ex.what());
-        } catch (...) {
-          subscription->callback_error.store(true);
-          LOG_ERROR(std::string("PumpFunClient quote callback error (subscription ") +
-                    std::to_string(id) + ", token " + subscription->token_mint +
-                    "): unknown exception");
-        }
-      } catch (const std::exception& ex) {
-        LOG_WARN(std::string("PumpFunClient quote polling error (subscription ") +
-                 std::to_string(id) + ", token " + subscription->token_mint + "): " +
-                 ex.what());
-      }
-
-      const auto wake_time = std::chrono::steady_clock::now() + subscription->interval;
-      while (running_.load() && subscription->active.load() && std::chrono::steady_clock::now() < wake_time) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-      }
-    }
-  });
-
+  // The event loop may be sleeping until a later timer; let it pick this one up.
+  if (multi_loop_) {
+    multi_loop_->wakeup();
+  }
   return id;
 }
 
 void PumpFunClient::unsubscribe(SubscriptionId id) {
+  std::shared_ptr<common::TimerWheel> timers;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    timers = timers_;
+  }
+
   std::shared_ptr<Subscription> subscription;
+  std::shared_ptr<MintPoll> poll;
+  bool last_listener = false;
+  common::TimerWheel::TimerId replaced = 0;
   {
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
     auto it = subscriptions_.find(id);
@@ -303,21 +568,37 @@ void PumpFunClient::unsubscribe(SubscriptionId id) {
     }
     subscription = it->second;
     subscriptions_.erase(it);
-  }
 
-  if (subscription) {
-    subscription->active.store(false);
-    if (subscription->worker.joinable()) {
-      const auto worker_id = subscription->worker.get_id();
-      const auto current_id = std::this_thread::get_id();
-      if (worker_id == current_id) {
-        // Avoid joining from the worker thread itself since std::thread::join would deadlock.
-        subscription->worker.detach();
-      } else {
-        subscription->worker.join();
+    auto poll_it = mint_polls_.find(subscription->token_mint);
+    if (poll_it != mint_polls_.end()) {
+      poll = poll_it->second;
+      auto& listeners = poll->listeners;
+      listeners.erase(std::remove(listeners.begin(), listeners.end(), subscription),
+                      listeners.end());
+      if (listeners.empty()) {
+        setAdaptedIntervalLocked(*poll, std::chrono::milliseconds(0));
+        mint_polls_.erase(poll_it);
+        last_listener = true;
+      } else if (timers) {
+        // The departing listener may have been the one setting the pace.
+        resetAdaptedIntervalLocked(*poll);
+        replaced = rearmPollLocked(poll, *timers);
       }
     }
   }
+
+  subscription->active.store(false);
+  if (timers && replaced != 0) {
+    timers->cancel(replaced);
+  }
+  if (!poll) {
+    return;
+  }
+  if (last_listener) {
+    retirePoll(poll);
+  } else {
+    waitForDelivery(poll);
+  }
 }
 
 bool PumpFunClient::subscriptionHadCallbackError(SubscriptionId id) const {
@@ -345,42 +626,51 @@ TokenMetadata PumpFunClient::parseTokenMetadata(const nlohmann::json& json) cons
   metadata.market_cap = json.value("marketCap", json.value("market_cap", 0.0));
   metadata.liquidity = json.value("liquidity", json.value("liquidityUsd", 0.0));
   metadata.holder_count = json.value("holderCount", json.value("holder_count", json.value("holders", 0ULL)));
-  metadata.last_updated = json.value("updatedAt", json.value("updated_at", json.value("last_updated", "")));
+  metadata.last_updated_ns = timestampFromJson(json, {"updatedAt", "updated_at", "last_updated"});
   return metadata;
 }
 
-TokenQuote PumpFunClient::parseTokenQuote(const nlohmann::json& json) const {
+TokenQuote PumpFunClient::parseTokenQuote(const nlohmann::json& json) {
   TokenQuote quote;
   quote.mint = json.value("mint", json.value("address", ""));
   quote.price = json.value("price", json.value("priceUsd", json.value("usdPrice", 0.0)));
   quote.price_change_24h = json.value("priceChange24h", json.value("price_change_24h", json.value("priceChange", 0.0)));
   quote.volume_24h = json.value("volume24h", json.value("volume_24h", json.value("volume", 0.0)));
   quote.liquidity = json.value("liquidity", json.value("liquidityUsd", 0.0));
-  quote.timestamp = json.value("timestamp", json.value("updatedAt", json.value("time", "")));
+  quote.timestamp_ns = timestampFromJson(json, {"timestamp", "updatedAt", "time"});
   return quote;
 }
 
-HistoricalCandle PumpFunClient::parseHistoricalCandle(const nlohmann::json& json,
-                                                      const std::string& token_mint,
-                                                      const std::string& timeframe) const {
-  HistoricalCandle candle;
-  candle.mint = token_mint;
-  candle.timeframe = timeframe;
-  candle.open_time = json.value("open_time", json.value("startTime", json.value("time", "")));
-  candle.close_time = json.value("close_time", json.value("closeTime", json.value("endTime", "")));
-  candle.open = json.value("open", 0.0);
-  candle.high = json.value("high", 0.0);
-  candle.low = json.value("low", 0.0);
-  candle.close = json.value("close", 0.0);
-  candle.volume = json.value("volume", json.value("volumeUsd", 0.0));
-  candle.quote_volume = json.value("quote_volume", json.value("quoteVolume", 0.0));
-  return candle;
+TimestampNs PumpFunClient::timestampFromJson(const nlohmann::json& json,
+                                             std::initializer_list<const char*> keys) {
+  for (const char* key : keys) {
+    if (!json.contains(key)) {
+      continue;
+    }
+    TimestampNs timestamp = 0;
+    if (json[key].is_string()) {
+      parseTimestamp(json.value(key, std::string()), timestamp);
+    } else if (json[key].is_number()) {
+      timestamp = timestampFromEpoch(json.value(key, 0.0));
+    }
+    if (timestamp != 0) {
+      return timestamp;
+    }
+  }
+  return 0;
 }
 
 std::string PumpFunClient::buildUrl(
     const std::string& endpoint,
     const std::vector<std::pair<std::string, std::string>>& query_params) const {
-  std::string url = base_url_;
+  return buildUrl(base_url_, endpoint, query_params);
+}
+
+std::string PumpFunClient::buildUrl(
+    const std::string& base_url,
+    const std::string& endpoint,
+    const std::vector<std::pair<std::string, std::string>>& query_params) {
+  std::string url = base_url;
   if (!endpoint.empty()) {
     if (url.empty()) {
       url = endpoint;
@@ -417,102 +707,1020 @@ std::string PumpFunClient::buildUrl(
 std::string PumpFunClient::performGet(
     const std::string& endpoint,
     const std::vector<std::pair<std::string, std::string>>& query_params,
-    const std::unordered_map<std::string, std::string>& extra_headers) const {
-  const std::size_t max_attempts = std::max<std::size_t>(1, max_attempts_.load());
-  std::chrono::milliseconds backoff{retry_backoff_ms_.load()};
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    RequestPriority priority,
+    std::size_t max_attempts) const {
+  std::string key = buildUrl(endpoint, query_params);
+  std::vector<std::pair<std::string, std::string>> headers(extra_headers.begin(),
+                                                           extra_headers.end());
+  std::sort(headers.begin(), headers.end());
+  for (const auto& [name, value] : headers) {
+    key += '\n' + name + ": " + value;
+  }
+
+  const std::chrono::milliseconds ttl = cacheTtlFor(endpoint);
+  if (ttl.count() <= 0) {
+    return request_coalescer_.run(key, [&]() {
+      return performGetWithRetries(endpoint, query_params, extra_headers, nullptr, priority,
+                                   max_attempts)
+          .body;
+    });
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  std::optional<CachedResponse> cached = response_cache_.lookup(key, now);
+  if (cached && now < cached->expires_at) {
+    return std::move(cached->body);
+  }
+  return request_coalescer_.run(key, [&]() {
+    return fetchAndCache(key, endpoint, query_params, extra_headers, ttl, cached, priority,
+                         max_attempts);
+  });
+}
+
+std::string PumpFunClient::fetchAndCache(
+    const std::string& key,
+    const std::string& endpoint,
+    const std::vector<std::pair<std::string, std::string>>& query_params,
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    std::chrono::milliseconds ttl,
+    const std::optional<CachedResponse>& cached,
+    RequestPriority priority,
+    std::size_t max_attempts) const {
+  HttpResponse response;
+  try {
+    response = performGetWithRetries(endpoint, query_params, extra_headers,
+                                     cached ? &*cached : nullptr, priority, max_attempts);
+  } catch (const std::exception& ex) {
+    const std::chrono::milliseconds stale_window{stale_if_error_ms_.load()};
+    if (!cached || std::chrono::steady_clock::now() >= cached->expires_at + stale_window) {
+      throw;
+    }
+    response_cache_.recordStaleServed();
+    LOG_WARN("PumpFunClient serving stale " + buildUrl(endpoint, query_params) +
+             " after upstream error: " + ex.what());
+    return cached->body;
+  }
+
+  const auto expires_at = std::chrono::steady_clock::now() + ttl;
+  if (response.status_code == 304 && cached) {
+    response_cache_.refresh(key, expires_at);
+    return cached->body;
+  }
+  response_cache_.store(key, CachedResponse{response.body, response.etag, response.last_modified,
+                                            expires_at});
+  return std::move(response.body);
+}
+
+std::chrono::milliseconds PumpFunClient::cacheTtlFor(const std::string& endpoint) const {
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  std::size_t longest = 0;
+  std::chrono::milliseconds ttl{0};
+  for (const auto& [prefix, prefix_ttl] : cache_ttls_) {
+    const bool matches = endpoint.compare(0, prefix.size(), prefix) == 0 &&
+                         (endpoint.size() == prefix.size() || endpoint[prefix.size()] == '/');
+    if (matches && prefix.size() >= longest) {
+      longest = prefix.size();
+      ttl = prefix_ttl;
+    }
+  }
+  return ttl;
+}
+
+PumpFunClient::HttpResponse PumpFunClient::performGetWithRetries(
+    const std::string& endpoint,
+    const std::vector<std::pair<std::string, std::string>>& query_params,
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    const CachedResponse* validators,
+    RequestPriority priority,
+    std::size_t max_attempts,
+    const BodySink* sink) const {
+  if (max_attempts == 0) {
+    max_attempts = std::max<std::size_t>(1, max_attempts_.load());
+  }
+  HttpGetFunction getter;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    getter = http_getter_;
+  }
 
+  // Providers that failed this request in the current round.
+  std::unordered_set<const Provider*> failed;
+  std::size_t round = 1;
   std::size_t attempt = 0;
   while (true) {
     ++attempt;
-    try {
-      HttpGetFunction getter;
-      {
-        std::lock_guard<std::mutex> lock(http_mutex_);
-        getter = http_getter_;
+    const std::vector<Route> routes = routesFor(endpoint);
+    if (routes.empty()) {
+      throw std::runtime_error("No provider serves " + endpoint);
+    }
+
+    // The best provider not yet tried whose breaker is closed and that has
+    // rate budget. Breakers and limiters are checked per attempt, so retries
+    // stop as soon as they trip.
+    const Route* route = nullptr;
+    std::shared_ptr<CircuitBreaker> breaker;
+    bool circuit_open = false;
+    for (const auto& candidate : routes) {
+      if (failed.count(candidate.provider.get()) > 0) {
+        continue;
       }
+      auto candidate_breaker = circuitBreakerFor(*candidate.provider, candidate.endpoint);
+      if (candidate_breaker && !candidate_breaker->admits()) {
+        circuit_open = true;
+        continue;
+      }
+      const auto limiter = rateLimiter(*candidate.provider);
+      if (limiter && !limiter->acquire(priority)) {
+        continue;
+      }
+      // Claimed last, so a shed or queued request never holds the half-open probe.
+      if (candidate_breaker && !candidate_breaker->allowRequest()) {
+        circuit_open = true;
+        continue;
+      }
+      route = &candidate;
+      breaker = std::move(candidate_breaker);
+      break;
+    }
+    if (!route) {
+      // A shed or fast-failed request is not retried.
+      if (circuit_open) {
+        throw CircuitOpenError("PumpFunClient circuit open for " + buildUrl(endpoint, query_params));
+      }
+      throw RateLimitedError("PumpFunClient rate limiter shed " + buildUrl(endpoint, query_params));
+    }
 
+    Provider& provider = *route->provider;
+    try {
       if (getter) {
-        return getter(endpoint, query_params, extra_headers);
+        HttpResponse response;
+        const auto started = std::chrono::steady_clock::now();
+        try {
+          response.body = getter(route->endpoint, query_params, extra_headers);
+        } catch (const std::exception& ex) {
+          recordResponse(provider, breaker.get(), 0, std::chrono::milliseconds(0),
+                         std::chrono::steady_clock::now() - started, ex.what());
+          throw;
+        }
+        recordResponse(provider, breaker.get(), response.status_code, std::chrono::milliseconds(0),
+                       std::chrono::steady_clock::now() - started, {});
+        if (sink) {
+          sink->consume(response.body);
+        }
+        return response;
       }
 
-      return performCurlGet(endpoint, query_params, extra_headers);
+      // A streamed body can't be raced against a hedge.
+      const auto hedging = validators || sink ? nullptr : hedgePolicyFor(endpoint);
+      if (!hedging) {
+        return performCurlGet(provider, route->endpoint, query_params, extra_headers, validators,
+                              breaker.get(), sink);
+      }
+      if (priority == RequestPriority::HeldPosition) {
+        if (const auto delay = hedging->onRequest()) {
+          return performHedgedCurlGet(*route, breaker, endpoint, query_params, extra_headers,
+                                      priority, *hedging, *delay);
+        }
+      }
+      // Unhedged quotes still train the hedge delay.
+      const auto started = std::chrono::steady_clock::now();
+      HttpResponse response =
+          performCurlGet(provider, route->endpoint, query_params, extra_headers, nullptr,
+                         breaker.get());
+      hedging->recordLatency(std::chrono::steady_clock::now() - started);
+      return response;
     } catch (const std::exception& ex) {
-      if (attempt >= max_attempts) {
+      if (attempt >= max_attempts || (sink && sink->committed())) {
         throw;
       }
+      if (sink) {
+        sink->restart();
+      }
 
       LOG_WARN(std::string("PumpFunClient GET failed (attempt ") + std::to_string(attempt) +
-               "/" + std::to_string(max_attempts) + ") for " + buildUrl(endpoint, query_params) +
-               ": " + ex.what());
-
-      if (backoff.count() > 0) {
-        std::this_thread::sleep_for(backoff);
+               "/" + std::to_string(max_attempts) + ") for " +
+               buildUrl(provider.config.base_url, route->endpoint, query_params) + ": " +
+               ex.what());
+
+      // Fail over straight away; back off only once every provider has failed.
+      failed.insert(&provider);
+      const bool all_failed = std::all_of(routes.begin(), routes.end(), [&](const Route& candidate) {
+        return failed.count(candidate.provider.get()) > 0;
+      });
+      if (all_failed) {
+        failed.clear();
+        const auto backoff = retryBackoff(round++);
+        if (backoff.count() > 0) {
+          std::this_thread::sleep_for(backoff);
+        }
       }
-      backoff = std::chrono::milliseconds(backoff.count() == 0 ? 0 : backoff.count() * 2);
     }
   }
 }
 
-std::string PumpFunClient::performCurlGet(
+std::chrono::milliseconds PumpFunClient::retryBackoff(std::size_t attempt) const {
+  const long long initial = retry_backoff_ms_.load();
+  if (initial <= 0) {
+    return std::chrono::milliseconds(0);
+  }
+  // Doubles per attempt up to the cap, then a uniform draw from its upper half.
+  const long long cap = std::chrono::milliseconds(kMaxRetryBackoff).count();
+  long long ceiling = std::min(initial, cap);
+  for (std::size_t i = 1; i < attempt && ceiling < cap; ++i) {
+    ceiling = std::min(ceiling * 2, cap);
+  }
+  std::uniform_int_distribution<long long> jitter(ceiling / 2, ceiling);
+  return std::chrono::milliseconds(jitter(jitterEngine()));
+}
+
+PumpFunClient::HttpResponse PumpFunClient::performCurlGet(
+    Provider& provider,
     const std::string& endpoint,
     const std::vector<std::pair<std::string, std::string>>& query_params,
-    const std::unordered_map<std::string, std::string>& extra_headers) const {
-  const std::string url = buildUrl(endpoint, query_params);
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    const CachedResponse* validators,
+    CircuitBreaker* breaker,
+    const BodySink* sink) const {
+  const std::string url = buildUrl(provider.config.base_url, endpoint, query_params);
+  const auto header_list = requestHeaders(provider, extra_headers, validators);
+
+  auto lease = connection_pool_->acquire(provider.host_key);
+  CURL* curl = lease.handle();
+  HttpResponse response;
+  prepareCurlGet(curl, url, header_list.get(), response,
+                 sink ? sink->consume : ReceiveBuffer::Consumer{});
+
+  const auto started = std::chrono::steady_clock::now();
+  const CURLcode result = curl_easy_perform(curl);
+  finishCurlGet(provider, endpoint, breaker, curl, result,
+                std::chrono::steady_clock::now() - started, response);
+  return response;
+}
 
-  CURL* curl = curl_easy_init();
-  if (!curl) {
-    throw std::runtime_error("Failed to initialize CURL easy handle");
+PumpFunClient::HttpResponse PumpFunClient::performHedgedCurlGet(
+    const Route& route,
+    std::shared_ptr<CircuitBreaker> breaker,
+    const std::string& endpoint,
+    const std::vector<std::pair<std::string, std::string>>& query_params,
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    RequestPriority priority,
+    HedgePolicy& hedging,
+    std::chrono::milliseconds delay) const {
+  struct Attempt {
+    Route route;
+    std::shared_ptr<CircuitBreaker> breaker;
+    HttpConnectionPool::Lease lease;
+    bool hedge = false;
+    std::string url{};
+    std::shared_ptr<curl_slist> headers{};
+    HttpResponse response{};
+    std::chrono::steady_clock::time_point started{};
+    bool running = false;
+  };
+  std::vector<std::unique_ptr<Attempt>> attempts;
+
+  // Both transfers run on a private multi handle; whichever is still running
+  // when the other settles the request is removed, which cancels it.
+  struct MultiHandle {
+    CURLM* multi;
+    std::vector<std::unique_ptr<Attempt>>& attempts;
+    ~MultiHandle() {
+      for (const auto& attempt : attempts) {
+        if (attempt->running) {
+          curl_multi_remove_handle(multi, attempt->lease.handle());
+        }
+      }
+      curl_multi_cleanup(multi);
+    }
+  } transfers{curl_multi_init(), attempts};
+  if (transfers.multi == nullptr) {
+    throw std::runtime_error("Failed to initialize CURL multi handle");
   }
 
-  std::string buffer;
-  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &PumpFunClient::curlWriteCallback);
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-  curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-
-  std::unordered_map<std::string, std::string> headers;
-  {
-    std::lock_guard<std::mutex> lock(http_mutex_);
-    headers = default_headers_;
-  }
+  const auto start = [&](const Route& target, std::shared_ptr<CircuitBreaker> target_breaker,
+                         HttpConnectionPool::Lease lease, bool hedge) {
+    attempts.push_back(std::unique_ptr<Attempt>(
+        new Attempt{target, std::move(target_breaker), std::move(lease), hedge}));
+    Attempt& attempt = *attempts.back();
+    attempt.url = buildUrl(target.provider->config.base_url, target.endpoint, query_params);
+    attempt.headers = requestHeaders(*target.provider, extra_headers, nullptr);
+    prepareCurlGet(attempt.lease.handle(), attempt.url, attempt.headers.get(), attempt.response);
+    attempt.started = std::chrono::steady_clock::now();
+    attempt.running = curl_multi_add_handle(transfers.multi, attempt.lease.handle()) == CURLM_OK;
+    if (!attempt.running) {
+      throw std::runtime_error("Failed to start request for " + attempt.url);
+    }
+  };
+  start(route, std::move(breaker), connection_pool_->acquire(route.provider->host_key), false);
 
-  for (const auto& [key, value] : extra_headers) {
-    headers[key] = value;
-  }
+  const auto hedge_at = attempts.front()->started + delay;
+  bool hedge_considered = false;
+  while (true) {
+    int running_handles = 0;
+    curl_multi_perform(transfers.multi, &running_handles);
+    int remaining = 0;
+    while (CURLMsg* message = curl_multi_info_read(transfers.multi, &remaining)) {
+      if (message->msg != CURLMSG_DONE) {
+        continue;
+      }
+      const auto it = std::find_if(attempts.begin(), attempts.end(), [message](const auto& attempt) {
+        return attempt->lease.handle() == message->easy_handle;
+      });
+      if (it == attempts.end()) {
+        continue;
+      }
+      Attempt& attempt = **it;
+      const CURLcode result = message->data.result;
+      curl_multi_remove_handle(transfers.multi, attempt.lease.handle());
+      attempt.running = false;
+
+      long status_code = 0;
+      if (result == CURLE_OK) {
+        curl_easy_getinfo(attempt.lease.handle(), CURLINFO_RESPONSE_CODE, &status_code);
+      }
+      const auto latency = std::chrono::steady_clock::now() - attempt.started;
+      try {
+        finishCurlGet(*attempt.route.provider, attempt.route.endpoint, attempt.breaker.get(),
+                      attempt.lease.handle(), result, latency, attempt.response);
+      } catch (const std::exception&) {
+        // A transient failure leaves the request to the other transfer.
+        const bool transient = status_code == 0 || status_code == 429 || status_code >= 500;
+        const bool other_running = std::any_of(attempts.begin(), attempts.end(),
+                                               [](const auto& other) { return other->running; });
+        if (transient && other_running) {
+          continue;
+        }
+        throw;
+      }
+      hedging.recordLatency(latency);
+      if (attempt.hedge) {
+        hedging.onHedgeWon();
+      }
+      return std::move(attempt.response);
+    }
 
-  if (!api_key_.empty() && headers.find("x-api-key") == headers.end() && headers.find("X-API-Key") == headers.end()) {
-    headers["x-api-key"] = api_key_;
-  }
+    if (!hedge_considered && std::chrono::steady_clock::now() >= hedge_at) {
+      hedge_considered = true;
+      if (hedging.allowHedge()) {
+        for (const auto& target : hedgeRoutes(endpoint, *route.provider)) {
+          auto lease = connection_pool_->tryAcquire(target.provider->host_key);
+          if (!lease || !admitHedge(target, priority)) {
+            continue;
+          }
+          start(target, circuitBreakerFor(*target.provider, target.endpoint), std::move(*lease),
+                true);
+          hedging.onHedgeSent();
+          break;
+        }
+      }
+    }
 
-  struct curl_slist* header_list = nullptr;
-  for (const auto& [key, value] : headers) {
-    header_list = curl_slist_append(header_list, (key + ": " + value).c_str());
+    int timeout_ms = 1000;
+    if (!hedge_considered) {
+      const auto until_hedge = std::chrono::ceil<std::chrono::milliseconds>(
+          hedge_at - std::chrono::steady_clock::now());
+      timeout_ms = static_cast<int>(std::clamp<long long>(until_hedge.count(), 0, timeout_ms));
+    }
+    curl_multi_poll(transfers.multi, nullptr, 0, timeout_ms, nullptr);
   }
-  header_list = curl_slist_append(header_list, "Accept: application/json");
+}
 
-  if (header_list != nullptr) {
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
-  }
+void PumpFunClient::prepareCurlGet(CURL* curl,
+                                   const std::string& url,
+                                   curl_slist* headers,
+                                   HttpResponse& response,
+                                   ReceiveBuffer::Consumer consumer) {
+  // Pooled handles keep their connection, DNS and TLS session caches between
+  // requests; only per-request options are set here.
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  response.receive.attach(curl, std::move(consumer));
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &PumpFunClient::curlHeaderCallback);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+}
 
-  const CURLcode result = curl_easy_perform(curl);
+void PumpFunClient::finishCurlGet(Provider& provider,
+                                  const std::string& endpoint,
+                                  CircuitBreaker* breaker,
+                                  CURL* curl,
+                                  CURLcode result,
+                                  std::chrono::steady_clock::duration latency,
+                                  HttpResponse& response) const {
   long status_code = 0;
   curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
-
-  if (header_list != nullptr) {
-    curl_slist_free_all(header_list);
+  // The body outlives the pooled handle (cache, coalesced callers), so it is
+  // moved out rather than read in place.
+  response.body = response.receive.take();
+  // A consumer that threw aborted the transfer, but the response itself arrived.
+  const bool responded = result == CURLE_OK || response.receive.consumerFailed();
+  const HttpTiming timing = HttpTiming::fromHandle(curl);
+  if (recordTiming(provider, endpoint, responded ? status_code : 0, timing)) {
+    const char* url = nullptr;
+    curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url);
+    LOG_DEBUG("PumpFunClient slow request " + std::string(url ? url : endpoint.c_str()) + ": " +
+              describeTiming(responded ? status_code : 0, timing));
   }
-  curl_easy_cleanup(curl);
-
-  if (result != CURLE_OK) {
-    throw std::runtime_error(std::string("cURL request failed: ") + curl_easy_strerror(result));
+  if (!responded) {
+    const std::string error = std::string("cURL request failed: ") + curl_easy_strerror(result);
+    recordResponse(provider, breaker, 0, std::chrono::milliseconds(0), latency, error);
+    throw std::runtime_error(error);
   }
+  connection_pool_->recordTransfer(curl);
+  curl_off_t retry_after = 0;
+  curl_easy_getinfo(curl, CURLINFO_RETRY_AFTER, &retry_after);
+  recordResponse(provider, breaker, status_code,
+                 std::chrono::seconds(std::max<curl_off_t>(0, retry_after)), latency, {});
+  response.receive.rethrowConsumerError();
 
   if (status_code >= 400) {
-    throw std::runtime_error("HTTP error " + std::to_string(status_code) + ": " + buffer);
+    throw std::runtime_error("HTTP error " + std::to_string(status_code) + ": " + response.body);
   }
-
-  return buffer;
+  response.status_code = status_code;
+}
+
+std::shared_ptr<curl_slist> PumpFunClient::requestHeaders(
+    const Provider& provider,
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    const CachedResponse* validators) const {
+  if (validators && (!validators->etag.empty() || !validators->last_modified.empty())) {
+    auto conditional_headers = extra_headers;
+    if (!validators->etag.empty()) {
+      conditional_headers["If-None-Match"] = validators->etag;
+    }
+    if (!validators->last_modified.empty()) {
+      conditional_headers["If-Modified-Since"] = validators->last_modified;
+    }
+    return buildHeaderList(provider, conditional_headers);
+  }
+  if (extra_headers.empty()) {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    return provider.header_list;
+  }
+  return buildHeaderList(provider, extra_headers);
+}
+
+std::shared_ptr<curl_slist> PumpFunClient::buildHeaderList(
+    const Provider& provider,
+    const std::unordered_map<std::string, std::string>& extra_headers) const {
+  std::unordered_map<std::string, std::string> headers;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    headers = default_headers_;
+  }
+
+  for (const auto& [key, value] : extra_headers) {
+    headers[key] = value;
+  }
+  return headerListFor(provider, std::move(headers));
+}
+
+std::shared_ptr<curl_slist> PumpFunClient::headerListFor(
+    const Provider& provider,
+    std::unordered_map<std::string, std::string> headers) const {
+  const std::string& api_key = provider.config.api_key;
+  // The constructor put the primary's key among the defaults; a fallback must
+  // not be sent it.
+  if (!api_key_.empty() && api_key != api_key_) {
+    for (const char* name : {"x-api-key", "X-API-Key"}) {
+      auto it = headers.find(name);
+      if (it != headers.end() && it->second == api_key_) {
+        headers.erase(it);
+      }
+    }
+  }
+  if (!api_key.empty() && headers.find("x-api-key") == headers.end() &&
+      headers.find("X-API-Key") == headers.end()) {
+    headers["x-api-key"] = api_key;
+  }
+
+  struct curl_slist* header_list = nullptr;
+  for (const auto& [key, value] : headers) {
+    header_list = curl_slist_append(header_list, (key + ": " + value).c_str());
+  }
+  header_list = curl_slist_append(header_list, "Accept: application/json");
+  return std::shared_ptr<curl_slist>(header_list, &curl_slist_free_all);
+}
+
+void PumpFunClient::refreshDefaultHeaderListLocked() {
+  for (const auto& provider : providers_) {
+    provider->header_list = headerListFor(*provider, default_headers_);
+  }
+}
+
+void PumpFunClient::setBatchQuoteEndpoint(std::string endpoint,
+                                          std::size_t max_mints_per_request,
+                                          std::string query_param) {
+  if (max_mints_per_request == 0) {
+    throw std::invalid_argument("max_mints_per_request must be greater than zero");
+  }
+  if (query_param.empty()) {
+    throw std::invalid_argument("query_param must not be empty");
+  }
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  batch_quotes_.endpoint = endpoint.empty() ? std::string() : ensureEndpoint(endpoint);
+  providers_.front()->config.batch_quote_endpoint = batch_quotes_.endpoint;
+  batch_quotes_.max_mints = max_mints_per_request;
+  batch_quotes_.query_param = std::move(query_param);
+}
+
+void PumpFunClient::setMaxConnectionsPerHost(std::size_t limit) {
+  max_connections_per_host_.store(std::max<std::size_t>(1, limit));
+  connection_pool_->setMaxConnectionsPerHost(limit);
+  std::lock_guard<std::mutex> lock(polling_mutex_);
+  if (multi_loop_) {
+    multi_loop_->setMaxConnectionsPerHost(limit);
+  }
+}
+
+void PumpFunClient::setAdaptivePolling(std::optional<AdaptivePollingOptions> options) {
+  if (options) {
+    if (!(options->max_requests_per_second > 0.0)) {
+      throw std::invalid_argument("max_requests_per_second must be positive");
+    }
+    if (options->min_interval.count() <= 0 || options->max_interval < options->min_interval) {
+      throw std::invalid_argument("Adaptive polling needs 0 < min_interval <= max_interval");
+    }
+  }
+
+  std::shared_ptr<common::TimerWheel> timers;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    timers = timers_;
+  }
+  std::vector<common::TimerWheel::TimerId> replaced;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    adaptive_polling_ = std::move(options);
+    // Every adapted interval feeds the budget stretch, so reset them all first.
+    for (auto& [mint, poll] : mint_polls_) {
+      (void)mint;
+      resetAdaptedIntervalLocked(*poll);
+    }
+    if (timers) {
+      for (auto& [mint, poll] : mint_polls_) {
+        (void)mint;
+        if (const auto id = rearmPollLocked(poll, *timers)) {
+          replaced.push_back(id);
+        }
+      }
+    }
+  }
+  for (const auto id : replaced) {
+    timers->cancel(id);
+  }
+}
+
+void PumpFunClient::setPollingBoost(const std::string& token_mint, bool boosted) {
+  std::shared_ptr<common::TimerWheel> timers;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    timers = timers_;
+  }
+  common::TimerWheel::TimerId replaced = 0;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    if (boosted) {
+      boosted_mints_.insert(token_mint);
+    } else {
+      boosted_mints_.erase(token_mint);
+    }
+    auto it = mint_polls_.find(token_mint);
+    // Boosting takes effect now; an unboosted poll decays from its next quote.
+    if (boosted && adaptive_polling_ && it != mint_polls_.end()) {
+      const auto& poll = it->second;
+      setAdaptedIntervalLocked(
+          *poll, std::min(requestedIntervalLocked(*poll), adaptive_polling_->min_interval));
+      if (timers) {
+        replaced = rearmPollLocked(poll, *timers);
+      }
+    }
+  }
+  if (replaced != 0) {
+    timers->cancel(replaced);
+  }
+}
+
+std::chrono::milliseconds PumpFunClient::pollInterval(const std::string& token_mint) const {
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  auto it = mint_polls_.find(token_mint);
+  return it != mint_polls_.end() ? it->second->interval : std::chrono::milliseconds(0);
+}
+
+void PumpFunClient::setRateLimit(std::optional<RateLimiter::Options> options) {
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  rate_limit_options_ = options;
+  for (const auto& provider : providers_) {
+    // Shared by key, so clients of one API key draw from the same bucket.
+    const ProviderConfig& config = provider->config;
+    provider->rate_limiter =
+        options ? RateLimiter::forKey(config.api_key.empty() ? config.base_url : config.api_key,
+                                      *options)
+                : nullptr;
+  }
+}
+
+void PumpFunClient::setCircuitBreaker(std::optional<CircuitBreaker::Options> options) {
+  if (options) {
+    CircuitBreaker::validate(*options);
+  }
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  circuit_breaker_options_ = options;
+  circuit_breakers_.clear();
+}
+
+std::unordered_map<std::string, CircuitBreakerStats> PumpFunClient::circuitBreakerStats() const {
+  std::unordered_map<std::string, std::shared_ptr<CircuitBreaker>> breakers;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    breakers = circuit_breakers_;
+  }
+  std::unordered_map<std::string, CircuitBreakerStats> stats;
+  for (const auto& [endpoint, breaker] : breakers) {
+    stats.emplace(endpoint, breaker->stats());
+  }
+  return stats;
+}
+
+void PumpFunClient::setHedging(std::optional<HedgePolicy::Options> options) {
+  if (options) {
+    HedgePolicy::validate(*options);
+  }
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  hedging_options_ = options;
+  hedge_policies_.clear();
+}
+
+std::unordered_map<std::string, HedgingStats> PumpFunClient::hedgingStats() const {
+  std::unordered_map<std::string, std::shared_ptr<HedgePolicy>> policies;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    policies = hedge_policies_;
+  }
+  std::unordered_map<std::string, HedgingStats> stats;
+  for (const auto& [endpoint, policy] : policies) {
+    stats.emplace(endpoint, policy->stats());
+  }
+  return stats;
+}
+
+RateLimiterStats PumpFunClient::rateLimiterStats() const {
+  std::unordered_set<std::shared_ptr<RateLimiter>> limiters;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    for (const auto& provider : providers_) {
+      if (provider->rate_limiter) {
+        limiters.insert(provider->rate_limiter);
+      }
+    }
+  }
+  RateLimiterStats total;
+  for (const auto& limiter : limiters) {
+    const RateLimiterStats stats = limiter->stats();
+    for (std::size_t i = 0; i < kRequestPriorityCount; ++i) {
+      total.granted[i] += stats.granted[i];
+      total.shed[i] += stats.shed[i];
+    }
+    total.rate_limited_responses += stats.rate_limited_responses;
+    total.requests_per_second += stats.requests_per_second;
+  }
+  return total;
+}
+
+std::shared_ptr<RateLimiter> PumpFunClient::rateLimiter(const Provider& provider) const {
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  return provider.rate_limiter;
+}
+
+void PumpFunClient::addProvider(ProviderConfig config) {
+  config.base_url = normalizeBaseUrl(std::move(config.base_url));
+  if (config.base_url.empty()) {
+    throw std::invalid_argument("Provider base URL must not be empty");
+  }
+  if (config.name.empty()) {
+    config.name = config.base_url;
+  }
+  for (std::string* endpoint : {&config.metadata_endpoint, &config.quote_endpoint,
+                                &config.candles_endpoint, &config.batch_quote_endpoint}) {
+    *endpoint = ensureEndpoint(*endpoint);
+  }
+
+  auto provider = std::make_shared<Provider>();
+  provider->host_key = HttpConnectionPool::hostKey(config.base_url);
+  provider->health.name = config.name;
+  provider->health.base_url = config.base_url;
+  provider->config = std::move(config);
+
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  provider->header_list = headerListFor(*provider, default_headers_);
+  if (rate_limit_options_) {
+    const ProviderConfig& added = provider->config;
+    provider->rate_limiter = RateLimiter::forKey(
+        added.api_key.empty() ? added.base_url : added.api_key, *rate_limit_options_);
+  }
+  providers_.push_back(std::move(provider));
+}
+
+std::vector<PumpFunClient::ProviderHealth> PumpFunClient::providerHealth() const {
+  std::vector<std::shared_ptr<Provider>> providers;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    providers = providers_;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<ProviderHealth> health;
+  health.reserve(providers.size());
+  for (const auto& provider : providers) {
+    std::lock_guard<std::mutex> lock(provider->health_mutex);
+    health.push_back(provider->health);
+    health.back().error_rate =
+        decayedErrorRate(provider->health.error_rate, now - provider->updated_at);
+    health.back().available = now >= provider->retry_at;
+  }
+  return health;
+}
+
+std::vector<PumpFunClient::Route> PumpFunClient::routesFor(const std::string& endpoint) const {
+  std::vector<Route> routes;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    // Requests are built against the primary's layout; find the endpoint kind
+    // and swap in each provider's path for it.
+    const ProviderConfig& primary = providers_.front()->config;
+    std::string ProviderConfig::*kind = nullptr;
+    std::string primary_prefix;
+    for (const auto member : {&ProviderConfig::metadata_endpoint, &ProviderConfig::quote_endpoint,
+                              &ProviderConfig::candles_endpoint,
+                              &ProviderConfig::batch_quote_endpoint}) {
+      const std::string& prefix = primary.*member;
+      if (prefix.size() > primary_prefix.size() && underPrefix(endpoint, prefix)) {
+        primary_prefix = prefix;
+        kind = member;
+      }
+    }
+
+    for (std::size_t i = 0; i < providers_.size(); ++i) {
+      const auto& provider = providers_[i];
+      if (i == 0 || !kind) {
+        routes.push_back(Route{provider, endpoint});
+        continue;
+      }
+      const std::string& prefix = provider->config.*kind;
+      if (!prefix.empty()) {
+        routes.push_back(Route{provider, prefix + endpoint.substr(primary_prefix.size())});
+      }
+    }
+  }
+  if (routes.size() < 2) {
+    return routes;
+  }
+
+  // Unsampled providers score zero, so each is tried once before latency decides.
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<std::pair<double, bool>> scores;
+  scores.reserve(routes.size());
+  for (const auto& route : routes) {
+    const Provider& provider = *route.provider;
+    std::lock_guard<std::mutex> lock(provider.health_mutex);
+    const double error_rate = decayedErrorRate(provider.health.error_rate, now - provider.updated_at);
+    scores.emplace_back(provider.health.latency_ms * (1.0 + kErrorRatePenalty * error_rate),
+                        now >= provider.retry_at);
+  }
+  std::vector<std::size_t> order(routes.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  // Providers backing off go last, in registration order.
+  std::stable_sort(order.begin(), order.end(), [&scores](std::size_t a, std::size_t b) {
+    if (scores[a].second != scores[b].second) {
+      return scores[a].second;
+    }
+    return scores[a].second && scores[a].first < scores[b].first;
+  });
+  std::vector<Route> ranked;
+  ranked.reserve(routes.size());
+  for (const std::size_t index : order) {
+    ranked.push_back(std::move(routes[index]));
+  }
+  return ranked;
+}
+
+std::shared_ptr<HedgePolicy> PumpFunClient::hedgePolicyFor(const std::string& endpoint) const {
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  if (!hedging_options_) {
+    return nullptr;
+  }
+  const ProviderConfig& primary = providers_.front()->config;
+  std::string prefix;
+  for (const std::string* candidate : {&primary.quote_endpoint, &primary.batch_quote_endpoint}) {
+    if (candidate->size() > prefix.size() && underPrefix(endpoint, *candidate)) {
+      prefix = *candidate;
+    }
+  }
+  if (prefix.empty()) {
+    return nullptr;
+  }
+  auto& policy = hedge_policies_[prefix];
+  if (!policy) {
+    policy = std::make_shared<HedgePolicy>(*hedging_options_);
+  }
+  return policy;
+}
+
+std::vector<PumpFunClient::Route> PumpFunClient::hedgeRoutes(const std::string& endpoint,
+                                                             const Provider& original) const {
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<Route> routes;
+  std::optional<Route> same;
+  for (auto& route : routesFor(endpoint)) {
+    if (route.provider.get() == &original) {
+      same = std::move(route);
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(route.provider->health_mutex);
+    if (now >= route.provider->retry_at) {
+      routes.push_back(std::move(route));
+    }
+  }
+  if (same) {
+    routes.push_back(std::move(*same));
+  }
+  return routes;
+}
+
+bool PumpFunClient::admitHedge(const Route& route, RequestPriority priority) const {
+  // A hedge is only worth sending now; it never queues for a token.
+  const auto limiter = rateLimiter(*route.provider);
+  if (limiter) {
+    const auto wait = limiter->tryAcquire(priority);
+    if (!wait || wait->count() != 0) {
+      return false;
+    }
+  }
+  // Asked last: on a half-open breaker a true answer makes this hedge the
+  // probe, so it must only be asked once the hedge is certain to be sent.
+  const auto breaker = circuitBreakerFor(*route.provider, route.endpoint);
+  return !breaker || breaker->allowRequest();
+}
+
+RequestPriority PumpFunClient::quotePriority(const std::string& token_mint) const {
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  return boosted_mints_.count(token_mint) > 0 ? RequestPriority::HeldPosition
+                                              : RequestPriority::Watchlist;
+}
+
+RequestPriority PumpFunClient::quotePriority(const std::vector<std::string>& token_mints) const {
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  for (const auto& mint : token_mints) {
+    if (boosted_mints_.count(mint) > 0) {
+      return RequestPriority::HeldPosition;
+    }
+  }
+  return RequestPriority::Watchlist;
+}
+
+std::string PumpFunClient::endpointKeyLocked(const Provider& provider,
+                                             const std::string& endpoint) const {
+  // Per-mint paths are grouped under the endpoint they were built from.
+  const ProviderConfig& config = provider.config;
+  std::string prefix = endpoint;
+  std::size_t longest = 0;
+  for (const std::string* candidate : {&config.metadata_endpoint, &config.quote_endpoint,
+                                       &config.candles_endpoint, &config.batch_quote_endpoint}) {
+    if (candidate->size() > longest && underPrefix(endpoint, *candidate)) {
+      longest = candidate->size();
+      prefix = *candidate;
+    }
+  }
+  return config.base_url + prefix;
+}
+
+bool PumpFunClient::recordTiming(const Provider& provider,
+                                 const std::string& endpoint,
+                                 long status_code,
+                                 const HttpTiming& timing) const {
+  std::string key;
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    key = endpointKeyLocked(provider, endpoint);
+  }
+  return http_metrics_.record(key, status_code, timing);
+}
+
+std::shared_ptr<CircuitBreaker> PumpFunClient::circuitBreakerFor(const Provider& provider,
+                                                                 const std::string& endpoint) const {
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  if (!circuit_breaker_options_ || endpoint.empty()) {
+    return nullptr;
+  }
+
+  const std::string key = endpointKeyLocked(provider, endpoint);
+  auto& breaker = circuit_breakers_[key];
+  if (!breaker) {
+    breaker = std::make_shared<CircuitBreaker>(key, *circuit_breaker_options_);
+  }
+  return breaker;
+}
+
+void PumpFunClient::recordResponse(Provider& provider,
+                                   CircuitBreaker* breaker,
+                                   long status_code,
+                                   std::chrono::milliseconds retry_after,
+                                   std::chrono::steady_clock::duration latency,
+                                   const std::string& error) const {
+  if (breaker) {
+    // A 429 says nothing about the endpoint's health; the limiter handles it.
+    if (status_code == 0 || status_code >= 500) {
+      breaker->onFailure();
+    } else if (status_code != 429) {
+      breaker->onSuccess();
+    }
+  }
+
+  // For routing, a throttled provider is as good as a failing one.
+  const bool failed = status_code == 0 || status_code == 429 || status_code >= 500;
+  {
+    std::lock_guard<std::mutex> lock(provider.health_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    ProviderHealth& health = provider.health;
+    const double latency_ms = std::chrono::duration<double, std::milli>(latency).count();
+    const double error_rate = decayedErrorRate(health.error_rate, now - provider.updated_at);
+    const double outcome = failed ? 1.0 : 0.0;
+    if (health.requests == 0) {
+      health.latency_ms = latency_ms;
+      health.error_rate = outcome;
+    } else {
+      health.latency_ms += kHealthSampleWeight * (latency_ms - health.latency_ms);
+      health.error_rate = error_rate + kHealthSampleWeight * (outcome - error_rate);
+    }
+    provider.updated_at = now;
+    ++health.requests;
+    if (failed) {
+      ++health.failures;
+      ++health.consecutive_failures;
+      health.last_error = error.empty() ? "HTTP " + std::to_string(status_code) : error;
+      const auto backoff = std::min<std::chrono::milliseconds>(
+          kMaxProviderBackoff,
+          kProviderBackoff * (std::int64_t{1} << std::min<std::uint64_t>(
+                                  health.consecutive_failures - 1, 5)));
+      provider.retry_at = now + backoff;
+    } else {
+      health.consecutive_failures = 0;
+      provider.retry_at = now;
+    }
+  }
+
+  const auto limiter = rateLimiter(provider);
+  if (!limiter) {
+    return;
+  }
+  if (status_code == 429) {
+    limiter->onRateLimited(retry_after);
+  } else if (status_code > 0 && status_code < 400) {
+    limiter->onSuccess();
+  }
+}
+
+HttpConnectionStats PumpFunClient::connectionStats() const {
+  return connection_pool_->stats();
+}
+
+std::unordered_map<std::string, EndpointMetrics> PumpFunClient::httpMetrics() const {
+  return http_metrics_.snapshot();
+}
+
+void PumpFunClient::setSlowRequestThreshold(std::chrono::milliseconds threshold) {
+  http_metrics_.setSlowRequestThreshold(threshold);
+}
+
+RequestCoalescingStats PumpFunClient::coalescingStats() const {
+  return request_coalescer_.stats();
+}
+
+void PumpFunClient::setCacheTtl(const std::string& endpoint_prefix, std::chrono::milliseconds ttl) {
+  const std::string prefix = ensureEndpoint(endpoint_prefix);
+  std::lock_guard<std::mutex> lock(http_mutex_);
+  auto it = std::find_if(cache_ttls_.begin(), cache_ttls_.end(),
+                         [&prefix](const auto& entry) { return entry.first == prefix; });
+  if (it != cache_ttls_.end()) {
+    it->second = ttl;
+  } else {
+    cache_ttls_.emplace_back(prefix, ttl);
+  }
+}
+
+void PumpFunClient::setStaleIfError(std::chrono::milliseconds window) {
+  stale_if_error_ms_.store(std::max<long long>(0, window.count()));
+}
+
+void PumpFunClient::setCacheCapacity(std::size_t max_bytes) {
+  response_cache_.reset(max_bytes);
+}
+
+ResponseCacheStats PumpFunClient::cacheStats() const {
+  return response_cache_.stats();
 }
 
 std::string PumpFunClient::encodeQueryParam(const std::string& value) {
@@ -532,28 +1740,846 @@ std::string PumpFunClient::encodeQueryParam(const std::string& value) {
   return escaped.str();
 }
 
-size_t PumpFunClient::curlWriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-  const size_t total_size = size * nmemb;
-  auto* buffer = static_cast<std::string*>(userp);
-  buffer->append(static_cast<char*>(contents), total_size);
+size_t PumpFunClient::curlHeaderCallback(char* buffer, size_t size, size_t nitems, void* userp) {
+  const size_t total_size = size * nitems;
+  auto* response = static_cast<HttpResponse*>(userp);
+  std::string line(buffer, total_size);
+  if (line.compare(0, 5, "HTTP/") == 0) {
+    // A new status line (e.g. after a redirect) starts a fresh header block.
+    response->etag.clear();
+    response->last_modified.clear();
+    return total_size;
+  }
+
+  const auto colon = line.find(':');
+  if (colon == std::string::npos) {
+    return total_size;
+  }
+  const auto value_begin = line.find_first_not_of(" \t", colon + 1);
+  const auto value_end = line.find_last_not_of(" \t\r\n");
+  if (value_begin == std::string::npos || value_end < value_begin) {
+    return total_size;
+  }
+  std::string value = line.substr(value_begin, value_end - value_begin + 1);
+  if (equalsIgnoreCase(line.data(), colon, "etag")) {
+    response->etag = std::move(value);
+  } else if (equalsIgnoreCase(line.data(), colon, "last-modified")) {
+    response->last_modified = std::move(value);
+  }
   return total_size;
 }
 
 void PumpFunClient::drainSubscriptions() {
   std::unordered_map<SubscriptionId, std::shared_ptr<Subscription>> local;
+  std::unordered_map<std::string, std::shared_ptr<MintPoll>> polls;
   {
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
     local.swap(subscriptions_);
+    polls.swap(mint_polls_);
+    poll_demand_ = 0.0;
   }
 
   for (auto& [id, subscription] : local) {
     (void)id;
-    if (!subscription) {
+    subscription->active.store(false);
+  }
+  for (auto& [mint, poll] : polls) {
+    (void)mint;
+    retirePoll(poll);
+  }
+
+  std::unordered_set<common::TimerWheel::TimerId> batch_timers;
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    batch_timers.swap(batch_timers_);
+    batch_pending_.clear();
+    batch_flush_scheduled_ = false;
+  }
+  std::shared_ptr<common::TimerWheel> timers;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    timers = timers_;
+  }
+  if (timers) {
+    for (const auto id : batch_timers) {
+      timers->cancel(id);
+    }
+  }
+}
+
+void PumpFunClient::retirePoll(const std::shared_ptr<MintPoll>& poll) {
+  poll->active.store(false);
+
+  std::shared_ptr<common::TimerWheel> timers;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    timers = timers_;
+  }
+  if (timers) {
+    // No longer reachable through mint_polls_, so nothing re-arms it.
+    timers->cancel(poll->timer_id);
+  }
+
+  // Wait out an in-flight poll unless we are being called from its own callback.
+  // A failed asynchronous poll may have armed a retry meanwhile; drop it too.
+  common::TimerWheel::TimerId retry_timer = 0;
+  if (poll->polling_thread.load() != std::this_thread::get_id()) {
+    std::lock_guard<std::mutex> poll_lock(poll->poll_mutex);
+    retry_timer = std::exchange(poll->retry_timer_id, 0);
+  } else {
+    retry_timer = std::exchange(poll->retry_timer_id, 0);
+  }
+  if (timers && retry_timer != 0) {
+    timers->cancel(retry_timer);
+  }
+}
+
+void PumpFunClient::waitForDelivery(const std::shared_ptr<MintPoll>& poll) {
+  if (poll->polling_thread.load() != std::this_thread::get_id()) {
+    std::lock_guard<std::mutex> poll_lock(poll->poll_mutex);
+  }
+}
+
+common::TimerWheel::TimerId PumpFunClient::rearmPollLocked(const std::shared_ptr<MintPoll>& poll,
+                                                           common::TimerWheel& timers) {
+  const auto interval = pollIntervalLocked(*poll);
+  if (poll->timer_id != 0) {
+    // Adaptive intervals drift with the budget stretch; small drifts are not
+    // worth a re-arm.
+    const auto drift = interval > poll->interval ? interval - poll->interval
+                                                 : poll->interval - interval;
+    if (drift.count() == 0 || (adaptive_polling_ && drift * 10 < poll->interval)) {
+      return 0;
+    }
+  }
+
+  // A brand new poll fires immediately; a re-paced one keeps its cadence.
+  const bool first = poll->timer_id == 0;
+  poll->interval = interval;
+  std::weak_ptr<MintPoll> weak = poll;
+  const auto replaced = std::exchange(
+      poll->timer_id, timers.scheduleEvery(
+                          interval,
+                          [this, weak]() {
+                            if (auto locked = weak.lock()) {
+                              enqueuePoll(locked);
+                            }
+                          },
+                          first ? std::chrono::milliseconds(0) : interval));
+  return replaced;
+}
+
+std::chrono::milliseconds PumpFunClient::requestedIntervalLocked(const MintPoll& poll) const {
+  auto interval = std::chrono::milliseconds::max();
+  for (const auto& listener : poll.listeners) {
+    interval = std::min(interval, std::max(listener->interval, std::chrono::milliseconds(1)));
+  }
+  return interval;
+}
+
+std::chrono::milliseconds PumpFunClient::pollIntervalLocked(const MintPoll& poll) const {
+  if (!adaptive_polling_) {
+    return requestedIntervalLocked(poll);
+  }
+  const double budget = adaptive_polling_->max_requests_per_second;
+  const double stretch = poll_demand_ > budget ? poll_demand_ / budget : 1.0;
+  return std::max(std::chrono::milliseconds(1),
+                  std::chrono::milliseconds(std::llround(
+                      static_cast<double>(poll.adapted_interval.count()) * stretch)));
+}
+
+void PumpFunClient::setAdaptedIntervalLocked(MintPoll& poll, std::chrono::milliseconds interval) {
+  const auto rate = [](std::chrono::milliseconds value) {
+    return value.count() > 0 ? 1000.0 / static_cast<double>(value.count()) : 0.0;
+  };
+  poll_demand_ = std::max(0.0, poll_demand_ + rate(interval) - rate(poll.adapted_interval));
+  poll.adapted_interval = interval;
+}
+
+void PumpFunClient::resetAdaptedIntervalLocked(MintPoll& poll) {
+  auto interval = requestedIntervalLocked(poll);
+  if (adaptive_polling_ && boosted_mints_.count(poll.token_mint) > 0) {
+    interval = std::min(interval, adaptive_polling_->min_interval);
+  }
+  setAdaptedIntervalLocked(poll, interval);
+}
+
+void PumpFunClient::adaptPollInterval(const std::shared_ptr<MintPoll>& poll,
+                                      const TokenQuote& quote) {
+  const double previous_price = std::exchange(poll->last_price, quote.price);
+  const double previous_volume = std::exchange(poll->last_volume, quote.volume_24h);
+
+  std::shared_ptr<common::TimerWheel> timers;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    timers = timers_;
+  }
+  if (!timers) {
+    return;
+  }
+
+  common::TimerWheel::TimerId replaced = 0;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    // A retired poll is no longer in mint_polls_ and must not be re-armed.
+    auto it = mint_polls_.find(poll->token_mint);
+    if (!adaptive_polling_ || it == mint_polls_.end() || it->second != poll) {
+      return;
+    }
+
+    const AdaptivePollingOptions& options = *adaptive_polling_;
+    const auto requested = requestedIntervalLocked(*poll);
+    const auto moved = [](double previous, double current, double threshold) {
+      return previous > 0.0 && std::abs(current - previous) >= threshold * previous;
+    };
+    auto interval = poll->adapted_interval;
+    if (boosted_mints_.count(poll->token_mint) > 0 ||
+        moved(previous_price, quote.price, options.price_change_threshold) ||
+        moved(previous_volume, quote.volume_24h, options.volume_change_threshold)) {
+      interval = std::min(requested, options.min_interval);
+    } else if (previous_price > 0.0) {
+      interval = std::min(std::max(requested, options.max_interval), interval * 2);
+    }
+    setAdaptedIntervalLocked(*poll, interval);
+    replaced = rearmPollLocked(poll, *timers);
+  }
+  if (replaced != 0) {
+    timers->cancel(replaced);
+  }
+}
+
+std::shared_ptr<common::TimerWheel> PumpFunClient::ensurePollingStarted() {
+  std::lock_guard<std::mutex> lock(polling_mutex_);
+
+  bool use_curl = false;
+  {
+    std::lock_guard<std::mutex> http_lock(http_mutex_);
+    use_curl = !http_getter_;
+  }
+  if (use_curl) {
+    if (!multi_loop_) {
+      // The event loop drives a private wheel itself, so cURL polling needs
+      // exactly one thread.
+      std::shared_ptr<common::TimerWheel> driven;
+      if (!timers_) {
+        timers_ = std::make_shared<common::TimerWheel>();
+        owns_timers_ = true;
+        driven = timers_;
+      }
+      HttpConnectionPool* pool = connection_pool_.get();
+      multi_loop_ = std::make_unique<CurlMultiLoop>(
+          std::move(driven), [pool](CURL* handle) { pool->recordTransfer(handle); });
+      multi_loop_->start();
+    }
+    return timers_;
+  }
+
+  if (!timers_) {
+    timers_ = std::make_shared<common::TimerWheel>();
+    owns_timers_ = true;
+  }
+  if (owns_timers_ && !timers_->isRunning()) {
+    timers_->start();
+  }
+
+  if (poll_workers_.empty()) {
+    {
+      std::lock_guard<std::mutex> queue_lock(poll_queue_mutex_);
+      poll_workers_stopping_ = false;
+    }
+    const std::size_t count = std::max<std::size_t>(1, poll_worker_count_);
+    poll_workers_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      poll_workers_.emplace_back(&PumpFunClient::pollWorkerLoop, this);
+    }
+  }
+  return timers_;
+}
+
+void PumpFunClient::enqueuePoll(const std::shared_ptr<MintPoll>& poll) {
+  if (!poll->active.load() || poll->queued.exchange(true)) {
+    return;
+  }
+  if (!batchQuoteConfig().endpoint.empty()) {
+    bool schedule_flush = false;
+    {
+      std::lock_guard<std::mutex> lock(batch_mutex_);
+      batch_pending_.push_back(poll);
+      schedule_flush = !std::exchange(batch_flush_scheduled_, true);
+    }
+    if (schedule_flush) {
+      // Every poll that falls due in this wheel tick joins the same flush.
+      scheduleBatchTimer(std::chrono::milliseconds(0), [this]() { flushBatchedPolls(); });
+    }
+    return;
+  }
+  if (multi_loop_) {
+    startAsyncPoll(poll, 1);
+    return;
+  }
+  enqueuePollJob({poll}, 1);
+}
+
+void PumpFunClient::enqueuePollJob(std::vector<std::shared_ptr<MintPoll>> polls,
+                                   std::size_t attempt) {
+  {
+    std::lock_guard<std::mutex> lock(poll_queue_mutex_);
+    poll_queue_.push_back(PollJob{std::move(polls), attempt});
+  }
+  poll_queue_condition_.notify_one();
+}
+
+void PumpFunClient::flushBatchedPolls() {
+  std::vector<std::shared_ptr<MintPoll>> pending;
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    pending.swap(batch_pending_);
+    batch_flush_scheduled_ = false;
+  }
+
+  const BatchQuoteConfig config = batchQuoteConfig();
+  const std::size_t chunk_size = config.endpoint.empty() ? 1 : config.max_mints;
+  for (std::size_t begin = 0; begin < pending.size(); begin += chunk_size) {
+    const std::size_t end = std::min(pending.size(), begin + chunk_size);
+    std::vector<std::shared_ptr<MintPoll>> chunk(pending.begin() + begin, pending.begin() + end);
+    if (multi_loop_) {
+      startAsyncBatch(std::move(chunk), 1);
       continue;
     }
-    subscription->active.store(false);
-    if (subscription->worker.joinable()) {
-      subscription->worker.join();
+    enqueuePollJob(std::move(chunk), 1);
+  }
+}
+
+void PumpFunClient::scheduleBatchTimer(std::chrono::milliseconds delay,
+                                       std::function<void()> callback) {
+  std::shared_ptr<common::TimerWheel> timers;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    timers = timers_;
+  }
+  if (!timers || !running_.load()) {
+    return;
+  }
+
+  // Registered under the lock so the callback always finds its own id.
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  auto id = std::make_shared<common::TimerWheel::TimerId>(0);
+  *id = timers->schedule(delay, [this, id, callback = std::move(callback)]() {
+    {
+      std::lock_guard<std::mutex> timer_lock(batch_mutex_);
+      batch_timers_.erase(*id);
+    }
+    callback();
+  });
+  batch_timers_.insert(*id);
+}
+
+void PumpFunClient::pollWorkerLoop() {
+  while (true) {
+    PollJob job;
+    {
+      std::unique_lock<std::mutex> lock(poll_queue_mutex_);
+      poll_queue_condition_.wait(lock, [this]() {
+        return poll_workers_stopping_ || !poll_queue_.empty();
+      });
+      if (poll_workers_stopping_) {
+        return;
+      }
+      job = std::move(poll_queue_.front());
+      poll_queue_.pop_front();
+    }
+
+    if (!batchQuoteConfig().endpoint.empty()) {
+      pollBatch(job.polls, job.attempt);
+      continue;
+    }
+    for (const auto& poll : job.polls) {
+      pollMint(poll, job.attempt);
+    }
+  }
+}
+
+void PumpFunClient::pollMint(const std::shared_ptr<MintPoll>& poll, std::size_t attempt) {
+  std::lock_guard<std::mutex> poll_lock(poll->poll_mutex);
+  if (!running_.load() || !poll->active.load()) {
+    poll->queued.store(false);
+    return;
+  }
+
+  TokenQuote quote;
+  try {
+    quote = quoteFromResponse(performGet(quoteEndpointFor(poll->token_mint), {}, {},
+                                         quotePriority(poll->token_mint), 1));
+  } catch (const CircuitOpenError&) {
+    // Skip the tick; the breaker logs its own transitions.
+    poll->queued.store(false);
+    return;
+  } catch (const RateLimitedError&) {
+    poll->queued.store(false);
+    return;
+  } catch (const std::exception& ex) {
+    const std::size_t max_attempts = std::max<std::size_t>(1, max_attempts_.load());
+    const std::string context = "PumpFunClient quote polling error (token " + poll->token_mint;
+    if (attempt >= max_attempts) {
+      LOG_WARN(context + "): " + ex.what());
+      poll->queued.store(false);
+      return;
+    }
+    LOG_WARN(context + ", attempt " + std::to_string(attempt) + "/" +
+             std::to_string(max_attempts) + "): " + ex.what());
+    // Retry off a timer so the worker moves on to other polls meanwhile.
+    scheduleBatchTimer(retryBackoff(attempt),
+                       [this, poll, attempt]() { enqueuePollJob({poll}, attempt + 1); });
+    return;
+  }
+
+  poll->queued.store(false);
+  poll->polling_thread.store(std::this_thread::get_id());
+  deliverQuote(poll, quote);
+  poll->polling_thread.store(std::thread::id{});
+}
+
+void PumpFunClient::pollBatch(const std::vector<std::shared_ptr<MintPoll>>& polls,
+                              std::size_t attempt) {
+  std::vector<std::string> mints;
+  for (const auto& poll : polls) {
+    if (poll->active.load()) {
+      mints.push_back(poll->token_mint);
+    }
+  }
+
+  std::unordered_map<std::string, TokenQuote> quotes;
+  if (running_.load() && !mints.empty()) {
+    try {
+      quotes = fetchQuoteChunk(mints, batchQuoteConfig(), {}, 1);
+    } catch (const CircuitOpenError&) {
+      // Skip the tick like a single poll would.
+    } catch (const RateLimitedError&) {
+    } catch (const std::exception& ex) {
+      const std::size_t max_attempts = std::max<std::size_t>(1, max_attempts_.load());
+      const std::string context = "PumpFunClient batch quote polling error (" +
+                                  std::to_string(mints.size()) + " mints";
+      if (attempt < max_attempts) {
+        LOG_WARN(context + ", attempt " + std::to_string(attempt) + "/" +
+                 std::to_string(max_attempts) + "): " + ex.what());
+        scheduleBatchTimer(retryBackoff(attempt),
+                           [this, polls, attempt]() { enqueuePollJob(polls, attempt + 1); });
+        return;
+      }
+      LOG_WARN(context + "): " + ex.what());
+    }
+  }
+  deliverBatch(polls, quotes);
+}
+
+void PumpFunClient::deliverBatch(const std::vector<std::shared_ptr<MintPoll>>& polls,
+                                 const std::unordered_map<std::string, TokenQuote>& quotes) {
+  std::size_t missing = 0;
+  for (const auto& poll : polls) {
+    std::lock_guard<std::mutex> poll_lock(poll->poll_mutex);
+    poll->queued.store(false);
+    if (!running_.load() || !poll->active.load()) {
+      continue;
+    }
+    auto it = quotes.find(poll->token_mint);
+    if (it == quotes.end()) {
+      ++missing;
+      continue;
+    }
+    poll->polling_thread.store(std::this_thread::get_id());
+    deliverQuote(poll, it->second);
+    poll->polling_thread.store(std::thread::id{});
+  }
+
+  if (missing > 0 && !quotes.empty()) {
+    LOG_WARN("PumpFunClient batch quote response omitted " + std::to_string(missing) + " of " +
+             std::to_string(polls.size()) + " mints");
+  }
+}
+
+void PumpFunClient::deliverQuote(const std::shared_ptr<MintPoll>& poll, const TokenQuote& quote) {
+  std::vector<std::shared_ptr<Subscription>> listeners;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    listeners = poll->listeners;
+  }
+
+  for (const auto& subscription : listeners) {
+    if (!subscription->active.load()) {
+      continue;
+    }
+    const SubscriptionId id = subscription->id;
+    try {
+      subscription->callback(quote);
+      subscription->callback_error.store(false);
+    } catch (const std::exception& callback_ex) {
+      subscription->callback_error.store(true);
+      LOG_ERROR(std::string("PumpFunClient quote callback error (subscription ") +
+                std::to_string(id) + ", token " + subscription->token_mint + "): " +
+                callback_ex.what());
+    } catch (...) {
+      subscription->callback_error.store(true);
+      LOG_ERROR(std::string("PumpFunClient quote callback error (subscription ") +
+                std::to_string(id) + ", token " + subscription->token_mint +
+                "): unknown exception");
+    }
+  }
+  adaptPollInterval(poll, quote);
+}
+
+void PumpFunClient::startAsyncPoll(const std::shared_ptr<MintPoll>& poll, std::size_t attempt) {
+  if (!running_.load() || !poll->active.load()) {
+    poll->queued.store(false);
+    return;
+  }
+
+  const RequestPriority priority = quotePriority(poll->token_mint);
+  const std::string endpoint = quoteEndpointFor(poll->token_mint);
+  for (const auto& route : routesFor(endpoint)) {
+    const auto breaker = circuitBreakerFor(*route.provider, route.endpoint);
+    if (breaker && !breaker->admits()) {
+      continue;
+    }
+    if (const auto limiter = rateLimiter(*route.provider)) {
+      const auto wait = limiter->tryAcquire(priority);
+      if (!wait) {
+        continue;
+      }
+      if (wait->count() > 0) {
+        scheduleBatchTimer(*wait, [this, poll, attempt]() { startAsyncPoll(poll, attempt); });
+        return;
+      }
+    }
+    // Claimed last, so a deferred or shed poll never holds the half-open probe.
+    if (breaker && !breaker->allowRequest()) {
+      continue;
+    }
+
+    auto get = std::make_shared<AsyncGet>();
+    get->endpoint = endpoint;
+    get->priority = priority;
+    get->hedging = hedgePolicyFor(endpoint);
+    get->completion = [this, poll, attempt](const Route& settled_by,
+                                            const CurlMultiLoop::Result& result) {
+      completeAsyncPoll(poll, attempt, settled_by, result);
+    };
+    if (!submitAsyncGet(get, route)) {
+      poll->queued.store(false);
+    }
+    return;
+  }
+  // Every provider is open or shed; the poll's next tick tries again.
+  poll->queued.store(false);
+}
+
+void PumpFunClient::completeAsyncPoll(const std::shared_ptr<MintPoll>& poll,
+                                      std::size_t attempt,
+                                      const Route& route,
+                                      const CurlMultiLoop::Result& result) {
+  std::lock_guard<std::mutex> poll_lock(poll->poll_mutex);
+  if (!running_.load() || !poll->active.load()) {
+    return;
+  }
+
+  std::string error = result.error;
+  if (error.empty() && result.status_code >= 400) {
+    error = "HTTP error " + std::to_string(result.status_code) + ": " + result.body;
+  }
+
+  TokenQuote quote;
+  if (error.empty()) {
+    try {
+      quote = quoteFromResponse(result.body);
+    } catch (const std::exception& ex) {
+      error = ex.what();
+    }
+  }
+
+  if (!error.empty()) {
+    const std::size_t max_attempts = std::max<std::size_t>(1, max_attempts_.load());
+    const std::string context = "PumpFunClient quote polling error (token " + poll->token_mint;
+    if (attempt >= max_attempts) {
+      LOG_WARN(context + "): " + error);
+      poll->queued.store(false);
+      return;
+    }
+
+    LOG_WARN(context + ", attempt " + std::to_string(attempt) + "/" +
+             std::to_string(max_attempts) + "): " + error);
+    // Retry off a timer instead of sleeping so other subscriptions keep flowing.
+    const auto backoff =
+        asyncRetryDelay(quoteEndpointFor(poll->token_mint), *route.provider, attempt);
+    std::shared_ptr<common::TimerWheel> timers;
+    {
+      std::lock_guard<std::mutex> lock(polling_mutex_);
+      timers = timers_;
+    }
+    poll->retry_timer_id = timers->schedule(backoff, [this, poll, attempt]() {
+      {
+        std::lock_guard<std::mutex> retry_lock(poll->poll_mutex);
+        poll->retry_timer_id = 0;
+      }
+      startAsyncPoll(poll, attempt + 1);
+    });
+    return;
+  }
+
+  poll->queued.store(false);
+  poll->polling_thread.store(std::this_thread::get_id());
+  deliverQuote(poll, quote);
+  poll->polling_thread.store(std::thread::id{});
+}
+
+void PumpFunClient::startAsyncBatch(std::vector<std::shared_ptr<MintPoll>> polls,
+                                    std::size_t attempt) {
+  std::vector<std::shared_ptr<MintPoll>> live;
+  std::vector<std::string> mints;
+  for (auto& poll : polls) {
+    if (running_.load() && poll->active.load()) {
+      mints.push_back(poll->token_mint);
+      live.push_back(std::move(poll));
+    } else {
+      poll->queued.store(false);
+    }
+  }
+  if (live.empty()) {
+    return;
+  }
+
+  const BatchQuoteConfig config = batchQuoteConfig();
+  if (config.endpoint.empty()) {
+    // Batching was switched off while these polls waited.
+    for (const auto& poll : live) {
+      startAsyncPoll(poll, 1);
+    }
+    return;
+  }
+
+  const RequestPriority priority = quotePriority(mints);
+  for (const auto& route : routesFor(config.endpoint)) {
+    const auto breaker = circuitBreakerFor(*route.provider, route.endpoint);
+    if (breaker && !breaker->admits()) {
+      continue;
+    }
+    if (const auto limiter = rateLimiter(*route.provider)) {
+      const auto wait = limiter->tryAcquire(priority);
+      if (!wait) {
+        continue;
+      }
+      if (wait->count() > 0) {
+        scheduleBatchTimer(*wait, [this, live, attempt]() { startAsyncBatch(live, attempt); });
+        return;
+      }
+    }
+    if (breaker && !breaker->allowRequest()) {
+      continue;
+    }
+
+    auto get = std::make_shared<AsyncGet>();
+    get->endpoint = config.endpoint;
+    get->query_params = {{config.query_param, joinMints(mints)}};
+    get->priority = priority;
+    get->hedging = hedgePolicyFor(config.endpoint);
+    get->completion = [this, live, attempt](const Route& settled_by,
+                                            const CurlMultiLoop::Result& result) {
+      completeAsyncBatch(live, attempt, settled_by, result);
+    };
+    if (submitAsyncGet(get, route)) {
+      return;
+    }
+    break;
+  }
+  for (const auto& poll : live) {
+    poll->queued.store(false);
+  }
+}
+
+void PumpFunClient::completeAsyncBatch(const std::vector<std::shared_ptr<MintPoll>>& polls,
+                                       std::size_t attempt,
+                                       const Route& route,
+                                       const CurlMultiLoop::Result& result) {
+  std::string error = result.error;
+  if (error.empty() && result.status_code >= 400) {
+    error = "HTTP error " + std::to_string(result.status_code) + ": " + result.body;
+  }
+
+  std::unordered_map<std::string, TokenQuote> quotes;
+  if (error.empty()) {
+    std::vector<std::string> mints;
+    mints.reserve(polls.size());
+    for (const auto& poll : polls) {
+      mints.push_back(poll->token_mint);
+    }
+    try {
+      quotes = quotesFromBatchResponse(result.body, mints);
+    } catch (const std::exception& ex) {
+      error = ex.what();
+    }
+  }
+
+  if (!error.empty() && running_.load()) {
+    const std::size_t max_attempts = std::max<std::size_t>(1, max_attempts_.load());
+    const std::string context = "PumpFunClient batch quote polling error (" +
+                                std::to_string(polls.size()) + " mints";
+    if (attempt < max_attempts) {
+      LOG_WARN(context + ", attempt " + std::to_string(attempt) + "/" +
+               std::to_string(max_attempts) + "): " + error);
+      scheduleBatchTimer(asyncRetryDelay(batchQuoteConfig().endpoint, *route.provider, attempt),
+                         [this, polls, attempt]() { startAsyncBatch(polls, attempt + 1); });
+      return;
+    }
+    LOG_WARN(context + "): " + error);
+  }
+
+  deliverBatch(polls, quotes);
+}
+
+bool PumpFunClient::submitAsyncGet(const std::shared_ptr<AsyncGet>& get, const Route& route) {
+  if (!startTransfer(get, route, false)) {
+    return false;
+  }
+  if (get->hedging && get->priority == RequestPriority::HeldPosition) {
+    if (const auto delay = get->hedging->onRequest()) {
+      const std::shared_ptr<Provider> original = route.provider;
+      scheduleBatchTimer(*delay, [this, get, original]() { hedgeAsyncGet(get, *original); });
+    }
+  }
+  return true;
+}
+
+bool PumpFunClient::startTransfer(const std::shared_ptr<AsyncGet>& get,
+                                  const Route& route,
+                                  bool hedge) {
+  CurlMultiLoop::Request request;
+  request.url = buildUrl(route.provider->config.base_url, route.endpoint, get->query_params);
+  {
+    std::lock_guard<std::mutex> lock(http_mutex_);
+    request.headers = route.provider->header_list;
+  }
+
+  // Submitted under the request's lock so a racing completion finds the id.
+  std::lock_guard<std::mutex> lock(get->mutex);
+  if (get->settled) {
+    return false;
+  }
+  const std::size_t index = get->transfers.size();
+  const auto started = std::chrono::steady_clock::now();
+  const auto id = multi_loop_->submit(
+      std::move(request),
+      [this, get, route, index, hedge, started](const CurlMultiLoop::Result& result) {
+        finishTransfer(get, route, index, hedge, started, result);
+      });
+  if (id == 0) {
+    return false;
+  }
+  get->transfers.push_back(id);
+  ++get->outstanding;
+  return true;
+}
+
+void PumpFunClient::finishTransfer(const std::shared_ptr<AsyncGet>& get,
+                                   const Route& route,
+                                   std::size_t index,
+                                   bool hedge,
+                                   std::chrono::steady_clock::time_point started,
+                                   const CurlMultiLoop::Result& result) {
+  const auto latency = std::chrono::steady_clock::now() - started;
+  const long status_code = result.error.empty() ? result.status_code : 0;
+  if (recordTiming(*route.provider, route.endpoint, status_code, result.timing)) {
+    LOG_DEBUG("PumpFunClient slow request " +
+              buildUrl(route.provider->config.base_url, route.endpoint, get->query_params) + ": " +
+              describeTiming(status_code, result.timing));
+  }
+  recordResponse(*route.provider, circuitBreakerFor(*route.provider, route.endpoint).get(),
+                 status_code, result.retry_after, latency, result.error);
+
+  // A transient failure leaves the request to its other transfer, if any.
+  const bool transient = status_code == 0 || status_code == 429 || status_code >= 500;
+  std::vector<CurlMultiLoop::TransferId> losers;
+  {
+    std::lock_guard<std::mutex> lock(get->mutex);
+    --get->outstanding;
+    if (get->settled || (transient && get->outstanding > 0)) {
+      return;
+    }
+    get->settled = true;
+    for (std::size_t i = 0; i < get->transfers.size(); ++i) {
+      if (i != index) {
+        losers.push_back(get->transfers[i]);
+      }
+    }
+  }
+  for (const auto id : losers) {
+    multi_loop_->cancel(id);
+  }
+
+  if (get->hedging && status_code < 400 && !transient) {
+    get->hedging->recordLatency(latency);
+    if (hedge) {
+      get->hedging->onHedgeWon();
+    }
+  }
+  get->completion(route, result);
+}
+
+void PumpFunClient::hedgeAsyncGet(const std::shared_ptr<AsyncGet>& get, const Provider& original) {
+  {
+    std::lock_guard<std::mutex> lock(get->mutex);
+    if (get->settled) {
+      return;
+    }
+  }
+  if (!running_.load() || !get->hedging->allowHedge()) {
+    return;
+  }
+  for (const auto& route : hedgeRoutes(get->endpoint, original)) {
+    if (!admitHedge(route, get->priority)) {
+      continue;
+    }
+    if (startTransfer(get, route, true)) {
+      get->hedging->onHedgeSent();
+    }
+    return;
+  }
+}
+
+std::chrono::milliseconds PumpFunClient::asyncRetryDelay(const std::string& endpoint,
+                                                         const Provider& failed,
+                                                         std::size_t attempt) const {
+  // The failed provider is now backing off, so it only stays first when
+  // nothing better is available.
+  const auto routes = routesFor(endpoint);
+  if (!routes.empty() && routes.front().provider.get() != &failed) {
+    return std::chrono::milliseconds(0);
+  }
+  return retryBackoff(attempt);
+}
+
+void PumpFunClient::stopPollWorkers() {
+  std::vector<std::thread> workers;
+  std::shared_ptr<common::TimerWheel> timers;
+  bool owns_timers = false;
+  {
+    std::lock_guard<std::mutex> lock(polling_mutex_);
+    workers.swap(poll_workers_);
+    timers = timers_;
+    owns_timers = owns_timers_;
+  }
+
+  if (owns_timers && timers) {
+    timers->stop();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(poll_queue_mutex_);
+    poll_workers_stopping_ = true;
+    poll_queue_.clear();
+  }
+  poll_queue_condition_.notify_all();
+
+  for (auto& worker : workers) {
+    if (worker.joinable()) {
+      worker.join();
     }
   }
 }
@@ -2,18 +2,38 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <initializer_list>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "common/timer_wheel.h"
+#include "market_data/circuit_breaker.h"
+#include "market_data/curl_multi_loop.h"
+#include "market_data/field_layout_cache.h"
+#include "market_data/hedge_policy.h"
+#include "market_data/http_connection_pool.h"
+#include "market_data/http_metrics.h"
+#include "market_data/mint_key.h"
+#include "market_data/rate_limiter.h"
+#include "market_data/receive_buffer.h"
+#include "market_data/request_coalescer.h"
+#include "market_data/response_cache.h"
+#include "market_data/timestamp.h"
+
 namespace market_data {
 
 class PumpFunClientTestPeer;
@@ -28,7 +48,8 @@ struct TokenMetadata {
   double market_cap = 0.0;
   double liquidity = 0.0;
   std::uint64_t holder_count = 0;
-  std::string last_updated;
+  // Epoch nanoseconds (UTC), parsed once at ingest; 0 when the provider sent none.
+  TimestampNs last_updated_ns = 0;
 };
 
 // Represents a real-time quote for a Pump.fun token.
@@ -38,15 +59,36 @@ struct TokenQuote {
   double price_change_24h = 0.0;
   double volume_24h = 0.0;
   double liquidity = 0.0;
-  std::string timestamp;
+  // Epoch nanoseconds (UTC); 0 when the provider sent none.
+  TimestampNs timestamp_ns = 0;
 };
 
+// Fixed-size, trivially copyable form of a TokenQuote for hot paths such as
+// per-mint conflation tables: 72 bytes, no heap allocation per update.
+struct CompactQuote {
+  MintKey mint;
+  double price = 0.0;
+  double price_change_24h = 0.0;
+  double volume_24h = 0.0;
+  double liquidity = 0.0;
+  TimestampNs timestamp_ns = 0;
+
+  // Returns false, leaving out untouched, if quote.mint is not a mint address.
+  static bool fromQuote(const TokenQuote& quote, CompactQuote& out);
+
+  // mint_text, when given, must be this quote's address; it saves re-encoding.
+  TokenQuote toQuote() const;
+  TokenQuote toQuote(std::string mint_text) const;
+};
+static_assert(std::is_trivially_copyable_v<CompactQuote>, "CompactQuote must stay memcpy-able");
+
 // Represents a historical OHLCV candle for a Pump.fun token.
 struct HistoricalCandle {
   std::string mint;
   std::string timeframe;
-  std::string open_time;
-  std::string close_time;
+  // Epoch nanoseconds (UTC); 0 when the provider sent none.
+  TimestampNs open_time_ns = 0;
+  TimestampNs close_time_ns = 0;
   double open = 0.0;
   double high = 0.0;
   double low = 0.0;
@@ -62,6 +104,7 @@ class PumpFunClient {
  public:
   using SubscriptionId = std::uint64_t;
   using QuoteCallback = std::function<void(const TokenQuote&)>;
+  using CandleCallback = std::function<void(HistoricalCandle&&)>;
   using HttpGetFunction = std::function<std::string(
       const std::string& endpoint,
       const std::vector<std::pair<std::string, std::string>>& query_params,
@@ -72,6 +115,51 @@ class PumpFunClient {
     std::unordered_map<std::string, std::string> headers;
   };
 
+  // Adaptive pacing for polling subscriptions (see setAdaptivePolling).
+  struct AdaptivePollingOptions {
+    // Global quote-poll budget matched to the provider plan. When the adapted
+    // intervals would exceed it, every interval is stretched by the same
+    // factor. A batched poll still counts once per mint.
+    double max_requests_per_second = 10.0;
+    // Pace for mints that just moved or are boosted, and the slowest pace an
+    // idle mint decays to. A listener asking for a faster interval than
+    // min_interval (or a slower one than max_interval) widens the range.
+    std::chrono::milliseconds min_interval{std::chrono::milliseconds(250)};
+    std::chrono::milliseconds max_interval{std::chrono::seconds(30)};
+    // Relative change between consecutive quotes that counts as activity.
+    double price_change_threshold = 0.002;
+    double volume_change_threshold = 0.01;
+  };
+
+  // A fallback market data provider and its endpoint layout (see addProvider).
+  struct ProviderConfig {
+    // Shown in providerHealth(); defaults to base_url.
+    std::string name;
+    std::string base_url;
+    std::string api_key;
+    std::string metadata_endpoint = "/metadata";
+    std::string quote_endpoint = "/quotes";
+    std::string candles_endpoint = "/candles";
+    // Multi-address quote endpoint taking the primary's query parameter (see
+    // setBatchQuoteEndpoint); empty if the provider has none.
+    std::string batch_quote_endpoint;
+  };
+
+  struct ProviderHealth {
+    std::string name;
+    std::string base_url;
+    // Weighted toward the provider's most recent requests. The error rate also
+    // decays while the provider receives no traffic, so it is tried again.
+    double latency_ms = 0.0;
+    double error_rate = 0.0;
+    std::uint64_t requests = 0;
+    std::uint64_t failures = 0;
+    std::uint64_t consecutive_failures = 0;
+    // False while the provider backs off after consecutive failures.
+    bool available = true;
+    std::string last_error;
+  };
+
   PumpFunClient(std::string base_url,
                 std::string api_key = {},
                 std::string metadata_endpoint = "/metadata",
@@ -95,6 +183,15 @@ class PumpFunClient {
       const std::string& token_mint,
       const std::unordered_map<std::string, std::string>& extra_headers = {}) const;
 
+  // Fetches quotes for many mints, keyed by mint. With a batch endpoint configured the
+  // mints are split into chunks of the provider's per-request limit; otherwise each
+  // mint is its own request. Requests run in parallel up to the per-host connection
+  // limit. Mints the provider did not return are absent from the result; throws only
+  // when every request failed.
+  std::unordered_map<std::string, TokenQuote> fetchTokenQuotes(
+      const std::vector<std::string>& token_mints,
+      const std::unordered_map<std::string, std::string>& extra_headers = {}) const;
+
   // Fetches a window of historical OHLCV candles for the provided mint and timeframe.
   std::vector<HistoricalCandle> fetchHistoricalCandles(
       const std::string& token_mint,
@@ -102,8 +199,27 @@ class PumpFunClient {
       int limit = 100,
       const std::unordered_map<std::string, std::string>& extra_headers = {}) const;
 
+  // Like fetchHistoricalCandles, but hands each candle to on_candle as soon as it
+  // arrives instead of buffering the body, so a large backfill holds one candle at
+  // a time. The response is not cached and identical requests are not coalesced.
+  // Failures are retried only until the first candle was delivered. Returns the
+  // number of candles delivered.
+  std::size_t streamHistoricalCandles(
+      const std::string& token_mint,
+      const std::string& timeframe,
+      int limit,
+      const CandleCallback& on_candle,
+      const std::unordered_map<std::string, std::string>& extra_headers = {}) const;
+
   // Registers a polling subscription that periodically pulls quotes and invokes the
-  // callback on the calling thread. Returns a handle that can be used to unsubscribe.
+  // callback. Subscriptions are deduplicated by mint: every listener for a mint shares
+  // one upstream poll, run at the smallest interval any of them requested (or adapted
+  // from it, see setAdaptivePolling), and polling stops when the last listener
+  // unsubscribes. Polls are timers on a shared
+  // common::TimerWheel rather than a thread per subscription. Over cURL, every poll is
+  // multiplexed on a single curl_multi event loop and callbacks run on that loop's
+  // thread, so they must not block; with an injected HttpGetFunction, polls run on a
+  // small worker pool instead. Returns a handle that can be used to unsubscribe.
   SubscriptionId subscribeToQuotes(const std::string& token_mint,
                                    QuoteCallback callback,
                                    std::chrono::milliseconds interval = std::chrono::milliseconds(1500));
@@ -121,39 +237,459 @@ class PumpFunClient {
   void setDefaultHeaders(std::unordered_map<std::string, std::string> headers);
   std::unordered_map<std::string, std::string> defaultHeaders() const;
 
+  // Failed requests are retried up to max_attempts in total. The backoff starts
+  // at initial_backoff and doubles per attempt, with each delay drawn between
+  // half and all of it so callers that failed together do not retry together.
+  // Polls retry from a timer; only synchronous fetches wait out the backoff.
   void setRetryPolicy(std::size_t max_attempts,
                       std::chrono::milliseconds initial_backoff);
 
+  // Gives every endpoint (metadata, quotes, batch quotes, candles) its own
+  // CircuitBreaker: while one is open, requests to it throw CircuitOpenError
+  // (a cached response is still served within the stale-if-error window) and
+  // polls skip their tick without touching the network. Transport errors and
+  // 5xx responses count as failures. Replacing the options resets every
+  // breaker; std::nullopt (the default) disables them.
+  void setCircuitBreaker(std::optional<CircuitBreaker::Options> options);
+  // Breaker state keyed by provider base URL plus endpoint, e.g.
+  // "https://api.example.com/quotes".
+  std::unordered_map<std::string, CircuitBreakerStats> circuitBreakerStats() const;
+
+  // Adds a fallback provider; the constructor's base URL, key and endpoints
+  // form the primary. Each request goes to the provider with the best recent
+  // latency and error rate. An attempt that fails (transport error, 429 or
+  // 5xx) moves to the next provider at once, and the retry backoff applies
+  // only after every provider has failed the request. A provider without the
+  // requested endpoint, e.g. batch quotes, is skipped. Throws
+  // std::invalid_argument for an empty base URL.
+  void addProvider(ProviderConfig provider);
+  // Every provider's routing health, primary first.
+  std::vector<ProviderHealth> providerHealth() const;
+
+  // Hedges quote requests for held positions (boosted mints, see
+  // setPollingBoost): when no response arrived within the policy's latency
+  // percentile, a second request goes to the best other provider (or the same
+  // one, if there is none), the first usable response wins and the other
+  // transfer is cancelled. Hedges respect breakers and rate limits and are
+  // paid from the policy's budget. Single and batch quote requests keep
+  // separate latency windows. Applies to requests made through cURL; polls
+  // hedge from a timer on the event loop. std::nullopt (the default) disables
+  // hedging. Throws std::invalid_argument unless HedgePolicy::validate passes.
+  void setHedging(std::optional<HedgePolicy::Options> options);
+  // Keyed by the quote or batch quote endpoint.
+  std::unordered_map<std::string, HedgingStats> hedgingStats() const;
+
+  // Routes every request through the token-bucket RateLimiter shared by all
+  // clients with the provider's API key (or base URL, without a key). Quotes for boosted
+  // mints go first, then other quotes, candles and metadata; requests that would
+  // wait too long are shed with RateLimitedError (synchronous calls) or skipped
+  // until the next tick (polls). 429 responses slow the bucket down.
+  // std::nullopt removes the limiter.
+  void setRateLimit(std::optional<RateLimiter::Options> options);
+  // Summed over every provider's limiter.
+  RateLimiterStats rateLimiterStats() const;
+
+  // Enables the provider's multi-address quote endpoint, requested as
+  // GET <endpoint>?<query_param>=<mint>,<mint>,... with at most
+  // max_mints_per_request mints. Polling subscriptions that fall due together are
+  // then coalesced into batch polls. An empty endpoint disables batching.
+  void setBatchQuoteEndpoint(std::string endpoint,
+                             std::size_t max_mints_per_request = 100,
+                             std::string query_param = "addresses");
+
+  // Replaces fixed polling intervals with adaptive ones: a poll drops to
+  // min_interval as soon as its price or volume moves past the thresholds, and
+  // doubles its interval after every quiet poll up to max_interval. Polls start at
+  // the interval their listeners requested. Total polls stay within
+  // max_requests_per_second. std::nullopt restores fixed intervals. Throws
+  // std::invalid_argument for a non-positive budget or interval, or
+  // max_interval < min_interval.
+  void setAdaptivePolling(std::optional<AdaptivePollingOptions> options);
+
+  // Keeps a mint at the fast end of the adaptive range regardless of activity,
+  // e.g. while a position in it is open, and gives its quote requests
+  // held-position priority under setRateLimit. May be called before subscribing.
+  void setPollingBoost(const std::string& token_mint, bool boosted);
+
+  // Interval the shared poll for token_mint currently runs at; zero if the mint
+  // is not polled.
+  std::chrono::milliseconds pollInterval(const std::string& token_mint) const;
+
+  // Schedules polling on an externally driven wheel (shared with the engine or
+  // execution algos). Must be called before the first subscription; without it
+  // the client starts a private wheel thread on demand.
+  void setTimerWheel(std::shared_ptr<common::TimerWheel> timers);
+
+  // Number of worker threads that execute due polls when an HttpGetFunction is
+  // injected. Must be called before the first subscription.
+  void setPollingConcurrency(std::size_t workers);
+
+  // Caps concurrent requests (and so open connections) to the API host.
+  void setMaxConnectionsPerHost(std::size_t limit);
+
+  // Connection reuse and handshake timings for requests made through cURL.
+  HttpConnectionStats connectionStats() const;
+
+  // Timing histograms (DNS, connect, TLS, first byte, total), response sizes
+  // and status codes of every request made through cURL, keyed like
+  // circuitBreakerStats().
+  std::unordered_map<std::string, EndpointMetrics> httpMetrics() const;
+
+  // Requests slower than threshold are counted per endpoint and sampled into
+  // the debug log, at most one line per endpoint per second. Zero disables
+  // the check; the default is one second.
+  void setSlowRequestThreshold(std::chrono::milliseconds threshold);
+
+  // Upstream GETs issued versus concurrent identical GETs (same URL and
+  // headers) that shared an in-flight request instead.
+  RequestCoalescingStats coalescingStats() const;
+
+  // Caches responses from endpoints under endpoint_prefix (for example "/metadata") for
+  // ttl; a zero ttl disables caching for them. Expired entries are revalidated with
+  // If-None-Match / If-Modified-Since when the server sent an ETag or Last-Modified.
+  // Defaults: metadata 5 minutes, candles 30 seconds, quotes uncached.
+  void setCacheTtl(const std::string& endpoint_prefix, std::chrono::milliseconds ttl);
+
+  // How long past expiry a cached response is still served when the upstream request
+  // fails (10 minutes by default).
+  void setStaleIfError(std::chrono::milliseconds window);
+
+  // Memory budget for cached responses. Drops the current entries.
+  void setCacheCapacity(std::size_t max_bytes);
+
+  ResponseCacheStats cacheStats() const;
+
+  // Maps a quote payload (REST response or stream update) onto a TokenQuote.
+  static TokenQuote parseTokenQuote(const nlohmann::json& json);
+
+  // Reads the first of keys holding an ISO-8601 string or an epoch number (s, ms, us
+  // or ns) as epoch nanoseconds; 0 when none does.
+  static TimestampNs timestampFromJson(const nlohmann::json& json,
+                                       std::initializer_list<const char*> keys);
+
  private:
   friend class PumpFunClientTestPeer;
 
   struct Subscription {
+    SubscriptionId id = 0;
     std::string token_mint;
     QuoteCallback callback;
     std::chrono::milliseconds interval;
     std::atomic<bool> active{true};
     std::atomic<bool> callback_error{false};
-    std::thread worker;
   };
 
-  TokenMetadata parseTokenMetadata(const nlohmann::json& json) const;
-  TokenQuote parseTokenQuote(const nlohmann::json& json) const;
-  HistoricalCandle parseHistoricalCandle(const nlohmann::json& json,
-                                         const std::string& token_mint,
-                                         const std::string& timeframe) const;
+  // The single upstream poll shared by every subscription to a mint.
+  struct MintPoll {
+    std::string token_mint;
+    // Listeners, effective interval and timer are guarded by subscriptions_mutex_.
+    std::vector<std::shared_ptr<Subscription>> listeners;
+    std::chrono::milliseconds interval{0};
+    // Adaptive interval before the budget stretch; its inverse is this poll's
+    // share of poll_demand_.
+    std::chrono::milliseconds adapted_interval{0};
+    common::TimerWheel::TimerId timer_id = 0;
+    std::atomic<bool> active{true};
+    // Set while a due poll waits in the queue so slow polls are not stacked.
+    std::atomic<bool> queued{false};
+    // Held for the duration of a poll and its fan-out; unsubscribe() takes it to
+    // wait out an in-flight callback.
+    std::mutex poll_mutex;
+    std::atomic<std::thread::id> polling_thread{};
+    // Pending backoff timer for an asynchronous poll that failed; guarded by
+    // poll_mutex.
+    common::TimerWheel::TimerId retry_timer_id = 0;
+    // Previous quote's price and volume for activity detection; guarded by
+    // poll_mutex.
+    double last_price = 0.0;
+    double last_volume = 0.0;
+  };
+
+  struct Provider {
+    // Endpoints normalized, name defaulted. Only the primary's
+    // batch_quote_endpoint changes, under http_mutex_ (setBatchQuoteEndpoint).
+    ProviderConfig config;
+    std::string host_key;
+    // Guarded by http_mutex_. Default headers plus this provider's key.
+    std::shared_ptr<curl_slist> header_list;
+    std::shared_ptr<RateLimiter> rate_limiter;
+    // Routing statistics, guarded by health_mutex.
+    mutable std::mutex health_mutex;
+    ProviderHealth health;
+    std::chrono::steady_clock::time_point updated_at;
+    // Skipped until then unless every provider is backing off.
+    std::chrono::steady_clock::time_point retry_at;
+  };
+
+  // A provider and the request's endpoint in its layout.
+  struct Route {
+    std::shared_ptr<Provider> provider;
+    std::string endpoint;
+  };
+
+  // A GET issued on the event loop, possibly hedged.
+  struct AsyncGet {
+    // In the primary's layout, for routing a hedge.
+    std::string endpoint;
+    std::vector<std::pair<std::string, std::string>> query_params;
+    RequestPriority priority = RequestPriority::Watchlist;
+    // Fed the latency of usable responses; hedges held-position requests.
+    std::shared_ptr<HedgePolicy> hedging;
+    // Runs once, with the response that settled the request.
+    std::function<void(const Route&, const CurlMultiLoop::Result&)> completion;
+    // Transfers of this request and whether one settled it; guarded by mutex.
+    std::mutex mutex;
+    std::vector<CurlMultiLoop::TransferId> transfers;
+    std::size_t outstanding = 0;
+    bool settled = false;
+  };
 
+  struct HttpResponse {
+    long status_code = 200;
+    std::string body;
+    // Collects the body during a cURL transfer; finishCurlGet moves it to body.
+    ReceiveBuffer receive;
+    std::string etag;
+    std::string last_modified;
+  };
+
+  // Takes a response body chunk by chunk in place of HttpResponse::body.
+  struct BodySink {
+    ReceiveBuffer::Consumer consume;
+    // Discards what the chunks of a failed attempt produced, before a retry.
+    std::function<void()> restart;
+    // Whether output that cannot be taken back rules out a retry.
+    std::function<bool()> committed;
+  };
+
+  // Polled together by a worker: one mint, or one batch chunk.
+  struct PollJob {
+    std::vector<std::shared_ptr<MintPoll>> polls;
+    std::size_t attempt = 1;
+  };
+
+  struct BatchQuoteConfig {
+    std::string endpoint;
+    std::size_t max_mints = 100;
+    std::string query_param = "addresses";
+  };
+
+  TokenMetadata parseTokenMetadata(const nlohmann::json& json) const;
+  TokenQuote quoteFromResponse(const std::string& response) const;
+  // Parses a multi-address response: an array of quotes (optionally wrapped in
+  // result/data/quotes) or an object keyed by the requested mints.
+  std::unordered_map<std::string, TokenQuote> quotesFromBatchResponse(
+      const std::string& response,
+      const std::vector<std::string>& token_mints) const;
+  BatchQuoteConfig batchQuoteConfig() const;
+  std::unordered_map<std::string, TokenQuote> fetchQuoteChunk(
+      const std::vector<std::string>& token_mints,
+      const BatchQuoteConfig& config,
+      const std::unordered_map<std::string, std::string>& extra_headers,
+      std::size_t max_attempts = 0) const;
+  std::string quoteEndpointFor(const std::string& token_mint) const;
+  std::string candlesEndpointFor(const std::string& token_mint) const;
+
+  // Against the primary's base URL; also the cache and coalescing key.
   std::string buildUrl(const std::string& endpoint,
                        const std::vector<std::pair<std::string, std::string>>& query_params) const;
+  static std::string buildUrl(const std::string& base_url,
+                              const std::string& endpoint,
+                              const std::vector<std::pair<std::string, std::string>>& query_params);
+  // Joins an identical request already in flight, otherwise issues it with retries.
+  // Joins the first caller's request, so it also shares that caller's priority.
+  // max_attempts of zero follows the retry policy.
   std::string performGet(const std::string& endpoint,
                          const std::vector<std::pair<std::string, std::string>>& query_params,
-                         const std::unordered_map<std::string, std::string>& extra_headers) const;
-  std::string performCurlGet(const std::string& endpoint,
-                             const std::vector<std::pair<std::string, std::string>>& query_params,
-                             const std::unordered_map<std::string, std::string>& extra_headers) const;
+                         const std::unordered_map<std::string, std::string>& extra_headers,
+                         RequestPriority priority,
+                         std::size_t max_attempts = 0) const;
+  // Issues the request (conditionally, when validators are given) and caches the result;
+  // falls back to the stale entry if upstream fails within the stale-if-error window.
+  std::string fetchAndCache(const std::string& key,
+                            const std::string& endpoint,
+                            const std::vector<std::pair<std::string, std::string>>& query_params,
+                            const std::unordered_map<std::string, std::string>& extra_headers,
+                            std::chrono::milliseconds ttl,
+                            const std::optional<CachedResponse>& cached,
+                            RequestPriority priority,
+                            std::size_t max_attempts) const;
+  std::chrono::milliseconds cacheTtlFor(const std::string& endpoint) const;
+  HttpResponse performGetWithRetries(
+      const std::string& endpoint,
+      const std::vector<std::pair<std::string, std::string>>& query_params,
+      const std::unordered_map<std::string, std::string>& extra_headers,
+      const CachedResponse* validators,
+      RequestPriority priority,
+      std::size_t max_attempts,
+      const BodySink* sink = nullptr) const;
+  HttpResponse performCurlGet(Provider& provider,
+                              const std::string& endpoint,
+                              const std::vector<std::pair<std::string, std::string>>& query_params,
+                              const std::unordered_map<std::string, std::string>& extra_headers,
+                              const CachedResponse* validators,
+                              CircuitBreaker* breaker,
+                              const BodySink* sink = nullptr) const;
+  // performCurlGet on route, hedged after delay. endpoint is in the primary's
+  // layout.
+  HttpResponse performHedgedCurlGet(const Route& route,
+                                    std::shared_ptr<CircuitBreaker> breaker,
+                                    const std::string& endpoint,
+                                    const std::vector<std::pair<std::string, std::string>>& query_params,
+                                    const std::unordered_map<std::string, std::string>& extra_headers,
+                                    RequestPriority priority,
+                                    HedgePolicy& hedging,
+                                    std::chrono::milliseconds delay) const;
+  // Points a pooled handle at url, collecting into response.receive (or
+  // passing the body to consumer).
+  static void prepareCurlGet(CURL* curl,
+                             const std::string& url,
+                             curl_slist* headers,
+                             HttpResponse& response,
+                             ReceiveBuffer::Consumer consumer = {});
+  // Records a finished transfer of endpoint (in the provider's layout); throws
+  // for a transport error or an HTTP error, and rethrows what a body consumer
+  // threw.
+  void finishCurlGet(Provider& provider,
+                     const std::string& endpoint,
+                     CircuitBreaker* breaker,
+                     CURL* curl,
+                     CURLcode result,
+                     std::chrono::steady_clock::duration latency,
+                     HttpResponse& response) const;
+  // Jittered exponential backoff before the given (1-based) retry.
+  std::chrono::milliseconds retryBackoff(std::size_t attempt) const;
   static std::string encodeQueryParam(const std::string& value);
 
-  static size_t curlWriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+  // Providers able to serve endpoint (given in the primary's layout), best
+  // first: available ones by latency weighted with error rate, then those
+  // backing off.
+  std::vector<Route> routesFor(const std::string& endpoint) const;
+  std::shared_ptr<RateLimiter> rateLimiter(const Provider& provider) const;
+  // The policy for the quote or batch quote endpoint that endpoint (in the
+  // primary's layout) falls under; null for other endpoints or while hedging
+  // is disabled.
+  std::shared_ptr<HedgePolicy> hedgePolicyFor(const std::string& endpoint) const;
+  // Where a hedge of a request to original may go: other available providers
+  // best first, then original itself.
+  std::vector<Route> hedgeRoutes(const std::string& endpoint, const Provider& original) const;
+  // Claims the route's breaker and a rate-limit token without waiting.
+  bool admitHedge(const Route& route, RequestPriority priority) const;
+  // Held-position priority for boosted mints, watchlist otherwise.
+  RequestPriority quotePriority(const std::string& token_mint) const;
+  RequestPriority quotePriority(const std::vector<std::string>& token_mints) const;
+  // Requires http_mutex_. The provider's base URL plus the configured endpoint
+  // that endpoint (in the provider's layout) falls under, e.g.
+  // "https://api.example.com/quotes" for a per-mint quote path.
+  std::string endpointKeyLocked(const Provider& provider, const std::string& endpoint) const;
+  // Adds a finished transfer to the endpoint's metrics. True when it is a
+  // slow request sampled for the debug log.
+  bool recordTiming(const Provider& provider,
+                    const std::string& endpoint,
+                    long status_code,
+                    const HttpTiming& timing) const;
+  // The breaker for the provider endpoint that endpoint (in the provider's
+  // layout) falls under, created on first use; null while breakers are
+  // disabled.
+  std::shared_ptr<CircuitBreaker> circuitBreakerFor(const Provider& provider,
+                                                    const std::string& endpoint) const;
+  // Feeds a response back to the provider's health and rate limiter and to the
+  // breaker. A zero status means no response arrived.
+  void recordResponse(Provider& provider,
+                      CircuitBreaker* breaker,
+                      long status_code,
+                      std::chrono::milliseconds retry_after,
+                      std::chrono::steady_clock::duration latency,
+                      const std::string& error) const;
+
+  // Collects ETag and Last-Modified into an HttpResponse.
+  static size_t curlHeaderCallback(char* buffer, size_t size, size_t nitems, void* userp);
+  // The provider's cached default list, or one built for extra headers and
+  // cache validators.
+  std::shared_ptr<curl_slist> requestHeaders(
+      const Provider& provider,
+      const std::unordered_map<std::string, std::string>& extra_headers,
+      const CachedResponse* validators) const;
+  // Builds provider's header list for default headers merged with extra_headers.
+  std::shared_ptr<curl_slist> buildHeaderList(
+      const Provider& provider,
+      const std::unordered_map<std::string, std::string>& extra_headers) const;
+  // Adds the provider's API key (dropping the primary's from a fallback).
+  std::shared_ptr<curl_slist> headerListFor(const Provider& provider,
+                                            std::unordered_map<std::string, std::string> headers) const;
+  // Requires http_mutex_. Rebuilds the cached lists used by requests without
+  // extra headers.
+  void refreshDefaultHeaderListLocked();
   void drainSubscriptions();
+  void retirePoll(const std::shared_ptr<MintPoll>& poll);
+  // Waits out a fan-out that may be running the subscription's callback.
+  void waitForDelivery(const std::shared_ptr<MintPoll>& poll);
+  // Requires subscriptions_mutex_. Re-arms the poll timer when its interval
+  // changed; returns the replaced timer for the caller to cancel once the lock
+  // is released.
+  common::TimerWheel::TimerId rearmPollLocked(const std::shared_ptr<MintPoll>& poll,
+                                              common::TimerWheel& timers);
+  // Requires subscriptions_mutex_. Smallest interval any listener requested.
+  std::chrono::milliseconds requestedIntervalLocked(const MintPoll& poll) const;
+  // Requires subscriptions_mutex_. The requested interval, or with adaptive
+  // polling the adapted one stretched to fit the budget.
+  std::chrono::milliseconds pollIntervalLocked(const MintPoll& poll) const;
+  // Requires subscriptions_mutex_. Updates the adapted interval and poll_demand_.
+  void setAdaptedIntervalLocked(MintPoll& poll, std::chrono::milliseconds interval);
+  // Requires subscriptions_mutex_. Restarts adaptation from the requested
+  // interval (the fast end for boosted mints).
+  void resetAdaptedIntervalLocked(MintPoll& poll);
+  // Requires poll.poll_mutex. Re-paces the poll from the activity in quote.
+  void adaptPollInterval(const std::shared_ptr<MintPoll>& poll, const TokenQuote& quote);
+
+  std::shared_ptr<common::TimerWheel> ensurePollingStarted();
+  void enqueuePoll(const std::shared_ptr<MintPoll>& poll);
+  // Issues the polls coalesced since the last flush as batch requests.
+  void flushBatchedPolls();
+  void pollWorkerLoop();
+  // Queues polls for the worker pool.
+  void enqueuePollJob(std::vector<std::shared_ptr<MintPoll>> polls, std::size_t attempt);
+  // One attempt each; a failure re-queues the poll from a backoff timer.
+  void pollMint(const std::shared_ptr<MintPoll>& poll, std::size_t attempt);
+  void pollBatch(const std::vector<std::shared_ptr<MintPoll>>& polls, std::size_t attempt);
+  // Delivers each poll's quote from a batch result and releases the polls.
+  void deliverBatch(const std::vector<std::shared_ptr<MintPoll>>& polls,
+                    const std::unordered_map<std::string, TokenQuote>& quotes);
+  void startAsyncBatch(std::vector<std::shared_ptr<MintPoll>> polls, std::size_t attempt);
+  void completeAsyncBatch(const std::vector<std::shared_ptr<MintPoll>>& polls,
+                          std::size_t attempt,
+                          const Route& route,
+                          const CurlMultiLoop::Result& result);
+  // Schedules a wheel timer that drainSubscriptions() cancels on shutdown.
+  void scheduleBatchTimer(std::chrono::milliseconds delay, std::function<void()> callback);
+  // Requires poll.poll_mutex. Fans the quote out to every active listener,
+  // records callback errors per subscription and re-paces an adaptive poll.
+  void deliverQuote(const std::shared_ptr<MintPoll>& poll, const TokenQuote& quote);
+  void startAsyncPoll(const std::shared_ptr<MintPoll>& poll, std::size_t attempt);
+  void completeAsyncPoll(const std::shared_ptr<MintPoll>& poll,
+                         std::size_t attempt,
+                         const Route& route,
+                         const CurlMultiLoop::Result& result);
+  // Issues get on route and, for a hedged request, arms its hedge timer.
+  // Returns false if the event loop is not running.
+  bool submitAsyncGet(const std::shared_ptr<AsyncGet>& get, const Route& route);
+  // One transfer of get; false if get settled meanwhile or the loop stopped.
+  bool startTransfer(const std::shared_ptr<AsyncGet>& get, const Route& route, bool hedge);
+  // Records the response; the first usable one (or the last failure) settles
+  // get and cancels its other transfer.
+  void finishTransfer(const std::shared_ptr<AsyncGet>& get,
+                      const Route& route,
+                      std::size_t index,
+                      bool hedge,
+                      std::chrono::steady_clock::time_point started,
+                      const CurlMultiLoop::Result& result);
+  void hedgeAsyncGet(const std::shared_ptr<AsyncGet>& get, const Provider& original);
+  // Zero backoff when another provider is ready to take the retry of a
+  // request for endpoint (in the primary's layout).
+  std::chrono::milliseconds asyncRetryDelay(const std::string& endpoint,
+                                            const Provider& failed,
+                                            std::size_t attempt) const;
+  void stopPollWorkers();
 
   std::string base_url_;
   std::string api_key_;
@@ -170,11 +706,60 @@ class PumpFunClient {
   bool curl_initialized_ = false;
 
   mutable std::mutex http_mutex_;
+  // The primary first, then fallbacks in the order they were added. Header
+  // lists are shared with in-flight requests so a header change never frees a
+  // list that a transfer is still using.
+  std::vector<std::shared_ptr<Provider>> providers_;
+  std::unique_ptr<HttpConnectionPool> connection_pool_;
+  BatchQuoteConfig batch_quotes_;
+  std::atomic<std::size_t> max_connections_per_host_{4};
+  mutable RequestCoalescer request_coalescer_;
+  // Guarded by http_mutex_; applied to providers added later.
+  std::optional<RateLimiter::Options> rate_limit_options_;
+  // Guarded by http_mutex_; breakers are keyed by configured endpoint.
+  std::optional<CircuitBreaker::Options> circuit_breaker_options_;
+  mutable std::unordered_map<std::string, std::shared_ptr<CircuitBreaker>> circuit_breakers_;
+  // Guarded by http_mutex_; policies are keyed by quote endpoint.
+  std::optional<HedgePolicy::Options> hedging_options_;
+  mutable std::unordered_map<std::string, std::shared_ptr<HedgePolicy>> hedge_policies_;
+  // Endpoint prefix -> TTL; guarded by http_mutex_.
+  std::vector<std::pair<std::string, std::chrono::milliseconds>> cache_ttls_;
+  std::atomic<long long> stale_if_error_ms_{600000};
+  mutable ResponseCache response_cache_;
+  mutable HttpMetrics http_metrics_;
+  // Field layouts detected from the quote and candle endpoints' responses.
+  mutable FieldLayoutCache quote_layout_;
+  mutable FieldLayoutCache candle_layout_;
 
   std::atomic<bool> running_{true};
   std::atomic<SubscriptionId> next_subscription_id_{1};
   mutable std::mutex subscriptions_mutex_;
   std::unordered_map<SubscriptionId, std::shared_ptr<Subscription>> subscriptions_;
+  std::unordered_map<std::string, std::shared_ptr<MintPoll>> mint_polls_;
+  // Adaptive pacing state, guarded by subscriptions_mutex_.
+  std::optional<AdaptivePollingOptions> adaptive_polling_;
+  std::unordered_set<std::string> boosted_mints_;
+  // Polls per second the adapted intervals add up to.
+  double poll_demand_ = 0.0;
+
+  std::mutex polling_mutex_;
+  std::shared_ptr<common::TimerWheel> timers_;
+  bool owns_timers_ = false;
+  std::size_t poll_worker_count_ = 4;
+  std::vector<std::thread> poll_workers_;
+  // Drives cURL polls (and the private wheel, if any) from one thread. Set once
+  // under polling_mutex_ before the first subscription is armed.
+  std::unique_ptr<CurlMultiLoop> multi_loop_;
+
+  std::mutex poll_queue_mutex_;
+  std::condition_variable poll_queue_condition_;
+  std::deque<PollJob> poll_queue_;
+  bool poll_workers_stopping_ = false;
+
+  std::mutex batch_mutex_;
+  std::vector<std::shared_ptr<MintPoll>> batch_pending_;
+  bool batch_flush_scheduled_ = false;
+  std::unordered_set<common::TimerWheel::TimerId> batch_timers_;
 };
 
 }  // namespace market_data
@@ -0,0 +1,917 @@
+#include "market_data/pumpfun_stream_client.h"
+
+#include "common/logging.h"
+#include "market_data/websocket_protocol.h"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace market_data {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kReadChunkBytes = 64 * 1024;
+// Reads per wakeup before subscription changes and pings are re-examined.
+constexpr int kReadsPerWakeup = 16;
+constexpr std::size_t kMaxHandshakeBytes = 16 * 1024;
+
+std::string lowerCase(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return value;
+}
+
+std::string sslErrorString() {
+  const unsigned long code = ERR_get_error();
+  if (code == 0) {
+    return std::strerror(errno);
+  }
+  char buffer[256];
+  ERR_error_string_n(code, buffer, sizeof(buffer));
+  return buffer;
+}
+
+void appendJsonString(std::string& out, const std::string& value) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  out += '"';
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out += "\\u00";
+      out += kHex[(c >> 4) & 0xF];
+      out += kHex[c & 0xF];
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+int millisUntil(Clock::time_point deadline) {
+  const auto remaining =
+      std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+  return static_cast<int>(std::clamp<long long>(remaining, 0, INT_MAX));
+}
+
+// Blocks until fd is ready for events or throws once deadline passes.
+void waitForSocket(int fd, short events, Clock::time_point deadline, const char* stage) {
+  while (true) {
+    const int timeout = millisUntil(deadline);
+    if (timeout == 0) {
+      throw std::runtime_error(std::string("Timed out during WebSocket ") + stage);
+    }
+    pollfd descriptor{fd, events, 0};
+    const int ready = ::poll(&descriptor, 1, timeout);
+    if (ready > 0) {
+      return;
+    }
+    if (ready < 0 && errno != EINTR) {
+      throw std::runtime_error(std::string("poll failed during WebSocket ") + stage + ": " +
+                               std::strerror(errno));
+    }
+  }
+}
+
+int connectSocket(const std::string& host, const std::string& port, Clock::time_point deadline) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  const int status = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses);
+  if (status != 0) {
+    throw std::runtime_error("Failed to resolve " + host + ": " + ::gai_strerror(status));
+  }
+  std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> guard(addresses, &::freeaddrinfo);
+
+  std::string last_error = "no addresses";
+  for (addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+    const int fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0) {
+      last_error = std::strerror(errno);
+      continue;
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    if (::connect(fd, address->ai_addr, address->ai_addrlen) != 0 && errno != EINPROGRESS) {
+      last_error = std::strerror(errno);
+      ::close(fd);
+      continue;
+    }
+    try {
+      waitForSocket(fd, POLLOUT, deadline, "connect");
+    } catch (const std::exception& ex) {
+      last_error = ex.what();
+      ::close(fd);
+      continue;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+      last_error = std::strerror(error);
+      ::close(fd);
+      continue;
+    }
+
+    const int no_delay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    return fd;
+  }
+  throw std::runtime_error("Failed to connect to " + host + ":" + port + ": " + last_error);
+}
+}  // namespace
+
+// Non-blocking socket, optionally wrapped in TLS, with an outbound buffer that
+// is flushed as the socket becomes writable.
+class PumpFunStreamClient::Connection {
+ public:
+  Connection(int fd, SSL_CTX* context, SSL* ssl) : fd_(fd), context_(context), ssl_(ssl) {}
+
+  ~Connection() {
+    if (ssl_ != nullptr) {
+      SSL_free(ssl_);
+    }
+    if (context_ != nullptr) {
+      SSL_CTX_free(context_);
+    }
+    ::close(fd_);
+  }
+
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+
+  int fd() const { return fd_; }
+
+  // Returns the number of bytes read, zero when the socket would block.
+  // Throws when the peer closed the connection or the read failed.
+  std::size_t read(char* buffer, std::size_t size) {
+    if (ssl_ == nullptr) {
+      while (true) {
+        const ssize_t n = ::recv(fd_, buffer, size, 0);
+        if (n > 0) {
+          return static_cast<std::size_t>(n);
+        }
+        if (n == 0) {
+          throw std::runtime_error("WebSocket connection closed by peer");
+        }
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          return 0;
+        }
+        throw std::runtime_error(std::string("WebSocket read failed: ") + std::strerror(errno));
+      }
+    }
+
+    read_wants_write_ = false;
+    const int n = SSL_read(ssl_, buffer, static_cast<int>(std::min<std::size_t>(size, INT_MAX)));
+    if (n > 0) {
+      return static_cast<std::size_t>(n);
+    }
+    switch (SSL_get_error(ssl_, n)) {
+      case SSL_ERROR_WANT_READ:
+        return 0;
+      case SSL_ERROR_WANT_WRITE:
+        read_wants_write_ = true;
+        return 0;
+      case SSL_ERROR_ZERO_RETURN:
+        throw std::runtime_error("WebSocket connection closed by peer");
+      default:
+        throw std::runtime_error("WebSocket TLS read failed: " + sslErrorString());
+    }
+  }
+
+  void queue(const std::string& bytes) { outbound_ += bytes; }
+
+  // Writes as much queued output as the socket accepts.
+  void flush() {
+    while (!outbound_.empty()) {
+      std::size_t written = 0;
+      if (ssl_ == nullptr) {
+        const ssize_t n = ::send(fd_, outbound_.data(), outbound_.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+          }
+          throw std::runtime_error(std::string("WebSocket write failed: ") + std::strerror(errno));
+        }
+        written = static_cast<std::size_t>(n);
+      } else {
+        const int n = SSL_write(ssl_, outbound_.data(),
+                                static_cast<int>(std::min<std::size_t>(outbound_.size(), INT_MAX)));
+        if (n <= 0) {
+          const int error = SSL_get_error(ssl_, n);
+          if (error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_WANT_READ) {
+            return;
+          }
+          throw std::runtime_error("WebSocket TLS write failed: " + sslErrorString());
+        }
+        written = static_cast<std::size_t>(n);
+      }
+      outbound_.erase(0, written);
+    }
+  }
+
+  bool wantsWrite() const { return !outbound_.empty() || read_wants_write_; }
+
+  // TLS may hold decrypted bytes that poll() cannot see.
+  bool hasBufferedInput() const { return ssl_ != nullptr && SSL_pending(ssl_) > 0; }
+
+  // Runs the TLS handshake to completion.
+  void handshake(Clock::time_point deadline) {
+    if (ssl_ == nullptr) {
+      return;
+    }
+    while (true) {
+      const int result = SSL_connect(ssl_);
+      if (result == 1) {
+        return;
+      }
+      const int error = SSL_get_error(ssl_, result);
+      if (error == SSL_ERROR_WANT_READ) {
+        waitForSocket(fd_, POLLIN, deadline, "TLS handshake");
+      } else if (error == SSL_ERROR_WANT_WRITE) {
+        waitForSocket(fd_, POLLOUT, deadline, "TLS handshake");
+      } else {
+        throw std::runtime_error("WebSocket TLS handshake failed: " + sslErrorString());
+      }
+    }
+  }
+
+  // Bytes that arrived after the HTTP upgrade response.
+  std::string leftover;
+
+ private:
+  int fd_;
+  SSL_CTX* context_;
+  SSL* ssl_;
+  std::string outbound_;
+  bool read_wants_write_ = false;
+};
+
+PumpFunStreamClient::PumpFunStreamClient(std::string url, std::string api_key)
+    : PumpFunStreamClient(std::move(url), std::move(api_key), Options{}) {}
+
+PumpFunStreamClient::PumpFunStreamClient(std::string url, std::string api_key, Options options)
+    : endpoint_(parseEndpoint(url)), api_key_(std::move(api_key)), options_(std::move(options)) {
+  if (options_.max_keys_per_message == 0) {
+    throw std::invalid_argument("max_keys_per_message must be greater than zero");
+  }
+  if (options_.ping_interval.count() <= 0) {
+    throw std::invalid_argument("ping_interval must be positive");
+  }
+  if (::pipe(wake_pipe_) != 0) {
+    throw std::runtime_error(std::string("Failed to create stream wake pipe: ") +
+                             std::strerror(errno));
+  }
+  for (int fd : wake_pipe_) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+}
+
+PumpFunStreamClient::~PumpFunStreamClient() {
+  stop();
+  ::close(wake_pipe_[0]);
+  ::close(wake_pipe_[1]);
+}
+
+void PumpFunStreamClient::start() {
+  bool expected = false;
+  if (!running_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  dispatch_thread_ = std::thread(&PumpFunStreamClient::dispatchLoop, this);
+  io_thread_ = std::thread(&PumpFunStreamClient::ioLoop, this);
+}
+
+void PumpFunStreamClient::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+
+  wakeIoThread();
+  {
+    std::lock_guard<std::mutex> lock(dispatch_mutex_);
+  }
+  dispatch_condition_.notify_all();
+
+  if (io_thread_.joinable()) {
+    io_thread_.join();
+  }
+  if (dispatch_thread_.joinable()) {
+    dispatch_thread_.join();
+  }
+
+  std::lock_guard<std::mutex> lock(dispatch_mutex_);
+  pending_quotes_.clear();
+  dirty_mints_.clear();
+}
+
+bool PumpFunStreamClient::isRunning() const {
+  return running_.load();
+}
+
+bool PumpFunStreamClient::isConnected() const {
+  return connected_.load();
+}
+
+PumpFunStreamClient::SubscriptionId PumpFunStreamClient::subscribeToQuotes(
+    const std::string& token_mint,
+    QuoteCallback callback) {
+  if (token_mint.empty()) {
+    throw std::invalid_argument("token_mint must not be empty");
+  }
+  if (!callback) {
+    throw std::invalid_argument("callback must be valid");
+  }
+
+  auto subscription = std::make_shared<Subscription>();
+  subscription->key = MintKey::fromBase58(token_mint);
+  subscription->id = next_subscription_id_.fetch_add(1);
+  subscription->token_mint = token_mint;
+  subscription->callback = std::move(callback);
+
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    auto& shared = mints_[subscription->key];
+    if (shared.empty() && pending_unsubscribe_.erase(subscription->key) == 0) {
+      pending_subscribe_.insert(subscription->key);
+    }
+    shared.push_back(subscription);
+    subscriptions_.emplace(subscription->id, subscription);
+  }
+
+  wakeIoThread();
+  return subscription->id;
+}
+
+void PumpFunStreamClient::unsubscribe(SubscriptionId id) {
+  std::shared_ptr<Subscription> subscription;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    auto it = subscriptions_.find(id);
+    if (it == subscriptions_.end()) {
+      return;
+    }
+    subscription = it->second;
+    subscriptions_.erase(it);
+
+    auto mint_it = mints_.find(subscription->key);
+    if (mint_it != mints_.end()) {
+      auto& shared = mint_it->second;
+      shared.erase(std::remove(shared.begin(), shared.end(), subscription), shared.end());
+      if (shared.empty()) {
+        mints_.erase(mint_it);
+        if (pending_subscribe_.erase(subscription->key) == 0) {
+          pending_unsubscribe_.insert(subscription->key);
+        }
+      }
+    }
+  }
+
+  subscription->active.store(false);
+  wakeIoThread();
+
+  if (dispatch_thread_id_.load() != std::this_thread::get_id()) {
+    // Waits out a callback that is already running.
+    std::lock_guard<std::mutex> lock(subscription->callback_mutex);
+  }
+}
+
+bool PumpFunStreamClient::subscriptionHadCallbackError(SubscriptionId id) const {
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  auto it = subscriptions_.find(id);
+  return it != subscriptions_.end() && it->second->callback_error.load();
+}
+
+StreamStats PumpFunStreamClient::stats() const {
+  StreamStats stats;
+  stats.connects = connects_.load();
+  stats.reconnects = stats.connects > 0 ? stats.connects - 1 : 0;
+  stats.messages_received = messages_received_.load();
+  stats.bytes_received = bytes_received_.load();
+  stats.quotes_delivered = quotes_delivered_.load();
+  stats.quotes_conflated = quotes_conflated_.load();
+  return stats;
+}
+
+PumpFunStreamClient::Endpoint PumpFunStreamClient::parseEndpoint(const std::string& url) {
+  Endpoint endpoint;
+  std::string rest;
+  const std::string lowered = lowerCase(url);
+  if (lowered.rfind("wss://", 0) == 0) {
+    endpoint.tls = true;
+    rest = url.substr(6);
+  } else if (lowered.rfind("ws://", 0) == 0) {
+    rest = url.substr(5);
+  } else {
+    throw std::invalid_argument("Stream URL must start with ws:// or wss://: " + url);
+  }
+
+  const auto path_start = rest.find('/');
+  std::string authority = rest.substr(0, path_start);
+  endpoint.target = path_start == std::string::npos ? "/" : rest.substr(path_start);
+
+  std::string port;
+  if (!authority.empty() && authority.front() == '[') {
+    const auto close = authority.find(']');
+    if (close == std::string::npos) {
+      throw std::invalid_argument("Malformed IPv6 host in stream URL: " + url);
+    }
+    endpoint.host = authority.substr(1, close - 1);
+    if (close + 1 < authority.size() && authority[close + 1] == ':') {
+      port = authority.substr(close + 2);
+    }
+  } else {
+    const auto colon = authority.rfind(':');
+    endpoint.host = authority.substr(0, colon);
+    if (colon != std::string::npos) {
+      port = authority.substr(colon + 1);
+    }
+  }
+  if (endpoint.host.empty()) {
+    throw std::invalid_argument("Stream URL has no host: " + url);
+  }
+  endpoint.port = port.empty() ? (endpoint.tls ? "443" : "80") : port;
+  return endpoint;
+}
+
+void PumpFunStreamClient::ioLoop() {
+  // A peer reset during SSL_write would otherwise raise SIGPIPE.
+  sigset_t blocked;
+  sigemptyset(&blocked);
+  sigaddset(&blocked, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &blocked, nullptr);
+
+  auto delay = options_.initial_reconnect_delay;
+  while (running_.load()) {
+    std::unique_ptr<Connection> connection;
+    try {
+      connection = connect();
+    } catch (const std::exception& ex) {
+      LOG_WARN(std::string("Pump.fun stream connect failed: ") + ex.what());
+    }
+
+    if (connection) {
+      connected_.store(true);
+      if (connects_.fetch_add(1) > 0) {
+        LOG_INFO("Pump.fun stream reconnected to " + endpoint_.host);
+      }
+      delay = options_.initial_reconnect_delay;
+      try {
+        runConnection(*connection);
+      } catch (const std::exception& ex) {
+        LOG_WARN(std::string("Pump.fun stream connection lost: ") + ex.what());
+      }
+      connected_.store(false);
+      connection.reset();
+    }
+
+    if (!waitBeforeReconnect(delay)) {
+      break;
+    }
+    delay = std::min(delay * 2, options_.max_reconnect_delay);
+  }
+}
+
+std::unique_ptr<PumpFunStreamClient::Connection> PumpFunStreamClient::connect() {
+  const auto deadline = Clock::now() + options_.connect_timeout;
+  const int fd = connectSocket(endpoint_.host, endpoint_.port, deadline);
+
+  SSL_CTX* context = nullptr;
+  SSL* ssl = nullptr;
+  if (endpoint_.tls) {
+    context = SSL_CTX_new(TLS_client_method());
+    if (context == nullptr) {
+      ::close(fd);
+      throw std::runtime_error("Failed to create TLS context: " + sslErrorString());
+    }
+    SSL_CTX_set_default_verify_paths(context);
+    SSL_CTX_set_verify(context, SSL_VERIFY_PEER, nullptr);
+    SSL_CTX_set_mode(context, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+    ssl = SSL_new(context);
+    if (ssl == nullptr) {
+      SSL_CTX_free(context);
+      ::close(fd);
+      throw std::runtime_error("Failed to create TLS session: " + sslErrorString());
+    }
+    SSL_set_fd(ssl, fd);
+    SSL_set_tlsext_host_name(ssl, endpoint_.host.c_str());
+    SSL_set1_host(ssl, endpoint_.host.c_str());
+  }
+  auto connection = std::make_unique<Connection>(fd, context, ssl);
+  connection->handshake(deadline);
+
+  const std::string key = websocket::generateHandshakeKey();
+  const bool default_port = endpoint_.port == (endpoint_.tls ? "443" : "80");
+  std::string request = "GET " + endpoint_.target + " HTTP/1.1\r\n";
+  request += "Host: " + endpoint_.host + (default_port ? "" : ":" + endpoint_.port) + "\r\n";
+  request += "Upgrade: websocket\r\nConnection: Upgrade\r\n";
+  request += "Sec-WebSocket-Key: " + key + "\r\nSec-WebSocket-Version: 13\r\n";
+  if (!api_key_.empty() && options_.headers.find("x-api-key") == options_.headers.end()) {
+    request += "x-api-key: " + api_key_ + "\r\n";
+  }
+  for (const auto& [name, value] : options_.headers) {
+    request += name + ": " + value + "\r\n";
+  }
+  request += "\r\n";
+
+  connection->queue(request);
+  connection->flush();
+  while (connection->wantsWrite()) {
+    waitForSocket(connection->fd(), POLLOUT, deadline, "upgrade");
+    connection->flush();
+  }
+
+  std::string response;
+  char chunk[4096];
+  std::size_t header_end = std::string::npos;
+  while (header_end == std::string::npos) {
+    if (!connection->hasBufferedInput()) {
+      waitForSocket(connection->fd(), POLLIN, deadline, "upgrade");
+    }
+    response.append(chunk, connection->read(chunk, sizeof(chunk)));
+    if (response.size() > kMaxHandshakeBytes) {
+      throw std::runtime_error("WebSocket upgrade response too large");
+    }
+    header_end = response.find("\r\n\r\n");
+  }
+
+  const std::string head = lowerCase(response.substr(0, header_end));
+  if (head.rfind("http/1.1 101", 0) != 0) {
+    throw std::runtime_error("WebSocket upgrade rejected: " +
+                             response.substr(0, response.find("\r\n")));
+  }
+  const std::string accept_header = "\r\nsec-websocket-accept:";
+  const auto accept_pos = head.find(accept_header);
+  if (accept_pos == std::string::npos) {
+    throw std::runtime_error("WebSocket upgrade response missing Sec-WebSocket-Accept");
+  }
+  const auto value_start = accept_pos + accept_header.size();
+  const auto value_end = response.find("\r\n", value_start);
+  std::string accept = response.substr(value_start, value_end - value_start);
+  accept.erase(0, accept.find_first_not_of(" \t"));
+  accept.erase(accept.find_last_not_of(" \t") + 1);
+  if (accept != websocket::acceptKeyFor(key)) {
+    throw std::runtime_error("WebSocket upgrade returned an invalid Sec-WebSocket-Accept");
+  }
+
+  connection->leftover = response.substr(header_end + 4);
+  return connection;
+}
+
+void PumpFunStreamClient::runConnection(Connection& connection) {
+  websocket::FrameParser parser(options_.max_message_bytes);
+  parser.append(connection.leftover.data(), connection.leftover.size());
+  connection.leftover.clear();
+
+  std::string message;
+  bool in_message = false;
+  auto last_inbound = Clock::now();
+  bool ping_sent = false;
+  std::vector<char> buffer(kReadChunkBytes);
+
+  for (const auto& text : takeSubscriptionMessages(true)) {
+    connection.queue(websocket::encodeFrame(websocket::Opcode::Text, text, true));
+  }
+
+  while (running_.load()) {
+    for (const auto& text : takeSubscriptionMessages(false)) {
+      connection.queue(websocket::encodeFrame(websocket::Opcode::Text, text, true));
+    }
+    connection.flush();
+
+    const auto idle_deadline =
+        last_inbound + (ping_sent ? options_.ping_interval * 2 : options_.ping_interval);
+    pollfd descriptors[2] = {
+        {connection.fd(), static_cast<short>(POLLIN | (connection.wantsWrite() ? POLLOUT : 0)), 0},
+        {wake_pipe_[0], POLLIN, 0},
+    };
+    const int timeout = connection.hasBufferedInput() ? 0 : millisUntil(idle_deadline);
+    if (::poll(descriptors, 2, timeout) < 0 && errno != EINTR) {
+      throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+    }
+
+    if ((descriptors[1].revents & POLLIN) != 0) {
+      char drain[64];
+      while (::read(wake_pipe_[0], drain, sizeof(drain)) > 0) {
+      }
+    }
+
+    if ((descriptors[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0 ||
+        connection.hasBufferedInput()) {
+      for (int reads = 0; reads < kReadsPerWakeup; ++reads) {
+        const std::size_t n = connection.read(buffer.data(), buffer.size());
+        if (n == 0) {
+          break;
+        }
+        bytes_received_.fetch_add(n, std::memory_order_relaxed);
+        parser.append(buffer.data(), n);
+      }
+
+      while (auto frame = parser.next()) {
+        last_inbound = Clock::now();
+        ping_sent = false;
+        switch (frame->opcode) {
+          case websocket::Opcode::Text:
+          case websocket::Opcode::Binary:
+            if (in_message) {
+              throw std::runtime_error("WebSocket data frame interrupted a fragmented message");
+            }
+            if (frame->fin) {
+              handleMessage(frame->payload);
+            } else {
+              message = std::move(frame->payload);
+              in_message = true;
+            }
+            break;
+          case websocket::Opcode::Continuation:
+            if (!in_message) {
+              throw std::runtime_error("Unexpected WebSocket continuation frame");
+            }
+            if (message.size() + frame->payload.size() > options_.max_message_bytes) {
+              throw std::runtime_error("Fragmented WebSocket message exceeds the limit");
+            }
+            message += frame->payload;
+            if (frame->fin) {
+              in_message = false;
+              handleMessage(message);
+              message.clear();
+            }
+            break;
+          case websocket::Opcode::Ping:
+            connection.queue(websocket::encodeFrame(websocket::Opcode::Pong, frame->payload, true));
+            break;
+          case websocket::Opcode::Pong:
+            break;
+          case websocket::Opcode::Close:
+            connection.queue(websocket::encodeFrame(websocket::Opcode::Close, {}, true));
+            connection.flush();
+            throw std::runtime_error("WebSocket closed by server");
+        }
+      }
+    }
+
+    const auto idle = Clock::now() - last_inbound;
+    if (idle >= options_.ping_interval * 2) {
+      throw std::runtime_error("WebSocket connection timed out");
+    }
+    if (!ping_sent && idle >= options_.ping_interval) {
+      connection.queue(websocket::encodeFrame(websocket::Opcode::Ping, {}, true));
+      ping_sent = true;
+    }
+  }
+
+  // Best-effort close handshake on shutdown.
+  connection.queue(websocket::encodeFrame(websocket::Opcode::Close, {}, true));
+  connection.flush();
+}
+
+void PumpFunStreamClient::handleMessage(const std::string& text) {
+  messages_received_.fetch_add(1, std::memory_order_relaxed);
+
+  nlohmann::json json;
+  try {
+    json = nlohmann::json::parse(text);
+  } catch (const nlohmann::json::exception& ex) {
+    LOG_WARN(std::string("Ignoring malformed Pump.fun stream message: ") + ex.what());
+    return;
+  }
+  if (!json.is_object()) {
+    return;
+  }
+  if (json.contains("error")) {
+    const nlohmann::json error = json["error"];
+    LOG_WARN("Pump.fun stream error: " +
+             (error.is_object() ? error.value("message", "unknown") : json.value("error", "unknown")));
+    return;
+  }
+
+  const std::string channel = json.value("channel", json.value("type", ""));
+  const bool is_trade = channel == "trades" || channel == "trade";
+  if (!is_trade && channel != "quotes" && channel != "quote") {
+    return;
+  }
+
+  const nlohmann::json& data = json.contains("data") ? json["data"] : json;
+  const auto handle = [this, is_trade](const nlohmann::json& entry) {
+    if (!entry.is_object()) {
+      return;
+    }
+    if (is_trade) {
+      handleTrade(entry);
+    } else {
+      handleQuote(entry);
+    }
+  };
+  try {
+    if (data.is_array()) {
+      for (const auto& entry : data) {
+        handle(entry);
+      }
+    } else {
+      handle(data);
+    }
+  } catch (const nlohmann::json::exception& ex) {
+    LOG_WARN(std::string("Ignoring malformed Pump.fun ") + channel + " update: " + ex.what());
+  }
+}
+
+void PumpFunStreamClient::handleQuote(const nlohmann::json& data) {
+  CompactQuote quote;
+  if (!CompactQuote::fromQuote(PumpFunClient::parseTokenQuote(data), quote) ||
+      !isSubscribed(quote.mint)) {
+    return;
+  }
+  last_quotes_[quote.mint] = quote;
+  publish(quote);
+}
+
+void PumpFunStreamClient::handleTrade(const nlohmann::json& data) {
+  MintKey mint;
+  const double price = data.value("price", data.value("priceUsd", 0.0));
+  if (price <= 0.0 || !MintKey::tryParse(data.value("mint", ""), mint) || !isSubscribed(mint)) {
+    return;
+  }
+
+  CompactQuote& quote = last_quotes_[mint];
+  quote.mint = mint;
+  quote.price = price;
+  quote.timestamp_ns = PumpFunClient::timestampFromJson(data, {"timestamp", "time"});
+  publish(quote);
+}
+
+bool PumpFunStreamClient::isSubscribed(const MintKey& mint) const {
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  return mints_.find(mint) != mints_.end();
+}
+
+void PumpFunStreamClient::publish(const CompactQuote& quote) {
+  {
+    std::lock_guard<std::mutex> lock(dispatch_mutex_);
+    auto [it, inserted] = pending_quotes_.try_emplace(quote.mint, quote);
+    if (!inserted) {
+      it->second = quote;
+      quotes_conflated_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    dirty_mints_.push_back(quote.mint);
+  }
+  dispatch_condition_.notify_one();
+}
+
+void PumpFunStreamClient::dispatchLoop() {
+  dispatch_thread_id_.store(std::this_thread::get_id());
+
+  while (true) {
+    CompactQuote update;
+    {
+      std::unique_lock<std::mutex> lock(dispatch_mutex_);
+      dispatch_condition_.wait(lock, [this]() { return !running_.load() || !dirty_mints_.empty(); });
+      if (!running_.load()) {
+        break;
+      }
+      auto it = pending_quotes_.find(dirty_mints_.front());
+      dirty_mints_.pop_front();
+      update = it->second;
+      pending_quotes_.erase(it);
+    }
+
+    std::vector<std::shared_ptr<Subscription>> targets;
+    {
+      std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+      auto it = mints_.find(update.mint);
+      if (it != mints_.end()) {
+        targets = it->second;
+      }
+    }
+    if (targets.empty()) {
+      continue;
+    }
+
+    // Subscribers share the address text they subscribed with.
+    const TokenQuote quote = update.toQuote(targets.front()->token_mint);
+
+    for (const auto& subscription : targets) {
+      std::lock_guard<std::mutex> lock(subscription->callback_mutex);
+      if (!subscription->active.load()) {
+        continue;
+      }
+      try {
+        subscription->callback(quote);
+        quotes_delivered_.fetch_add(1, std::memory_order_relaxed);
+      } catch (const std::exception& ex) {
+        subscription->callback_error.store(true);
+        LOG_ERROR("Pump.fun stream callback error for " + subscription->token_mint + ": " +
+                  ex.what());
+      } catch (...) {
+        subscription->callback_error.store(true);
+        LOG_ERROR("Pump.fun stream callback error for " + subscription->token_mint +
+                  ": unknown exception");
+      }
+    }
+  }
+}
+
+std::vector<std::string> PumpFunStreamClient::takeSubscriptionMessages(bool resubscribe_all) {
+  std::vector<MintKey> subscribe;
+  std::vector<MintKey> unsubscribe;
+  {
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    if (resubscribe_all) {
+      subscribe.reserve(mints_.size());
+      for (const auto& [mint, shared] : mints_) {
+        (void)shared;
+        subscribe.push_back(mint);
+      }
+      for (auto it = last_quotes_.begin(); it != last_quotes_.end();) {
+        it = mints_.count(it->first) > 0 ? std::next(it) : last_quotes_.erase(it);
+      }
+    } else {
+      subscribe.assign(pending_subscribe_.begin(), pending_subscribe_.end());
+      unsubscribe.assign(pending_unsubscribe_.begin(), pending_unsubscribe_.end());
+    }
+    pending_subscribe_.clear();
+    pending_unsubscribe_.clear();
+  }
+
+  for (const auto& mint : unsubscribe) {
+    last_quotes_.erase(mint);
+  }
+
+  auto messages = buildMessages("subscribe", subscribe);
+  auto removals = buildMessages("unsubscribe", unsubscribe);
+  messages.insert(messages.end(), std::make_move_iterator(removals.begin()),
+                  std::make_move_iterator(removals.end()));
+  return messages;
+}
+
+std::vector<std::string> PumpFunStreamClient::buildMessages(
+    const char* method,
+    const std::vector<MintKey>& keys) const {
+  std::vector<std::string> messages;
+  for (std::size_t begin = 0; begin < keys.size(); begin += options_.max_keys_per_message) {
+    const std::size_t end = std::min(keys.size(), begin + options_.max_keys_per_message);
+    std::string message = std::string("{\"method\":\"") + method +
+                          "\",\"channels\":[\"quotes\",\"trades\"],\"keys\":[";
+    for (std::size_t i = begin; i < end; ++i) {
+      if (i > begin) {
+        message += ',';
+      }
+      appendJsonString(message, keys[i].toBase58());
+    }
+    message += "]}";
+    messages.push_back(std::move(message));
+  }
+  return messages;
+}
+
+void PumpFunStreamClient::wakeIoThread() {
+  const char byte = 1;
+  // A full pipe already guarantees a wakeup.
+  [[maybe_unused]] const ssize_t written = ::write(wake_pipe_[1], &byte, 1);
+}
+
+bool PumpFunStreamClient::waitBeforeReconnect(std::chrono::milliseconds delay) {
+  const auto deadline = Clock::now() + delay;
+  while (running_.load()) {
+    const int timeout = millisUntil(deadline);
+    if (timeout == 0) {
+      return true;
+    }
+    pollfd descriptor{wake_pipe_[0], POLLIN, 0};
+    if (::poll(&descriptor, 1, timeout) > 0) {
+      char drain[64];
+      while (::read(wake_pipe_[0], drain, sizeof(drain)) > 0) {
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace market_data
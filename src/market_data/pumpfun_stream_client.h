@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "market_data/mint_key.h"
+#include "market_data/pumpfun_client.h"
+
+namespace market_data {
+
+struct StreamStats {
+  std::uint64_t connects = 0;
+  std::uint64_t reconnects = 0;
+  std::uint64_t messages_received = 0;
+  std::uint64_t bytes_received = 0;
+  std::uint64_t quotes_delivered = 0;
+  // Updates overwritten by a newer one for the same mint before a slow
+  // consumer got to them.
+  std::uint64_t quotes_conflated = 0;
+};
+
+// PumpFunStreamClient streams quotes and trades for many mints over a single
+// WebSocket (ws:// or wss://) connection and delivers them as TokenQuotes
+// through the same QuoteCallback contract as PumpFunClient::subscribeToQuotes.
+//
+// Wire protocol (JSON text frames):
+//   client -> {"method":"subscribe"|"unsubscribe","channels":["quotes","trades"],"keys":[mints]}
+//   server -> {"channel":"quotes","data":{quote}} or {"channel":"trades","data":{trade}}
+// where data may also be an array. Quote payloads use the REST quote fields;
+// trades update the price and timestamp of the last known quote for the mint.
+//
+// One I/O thread owns the socket: it connects, reconnects with exponential
+// backoff, resubscribes every mint after a reconnect and keeps the connection
+// alive with pings. Callbacks run on a separate dispatch thread. Pending
+// updates are conflated per mint, so a slow consumer always sees the latest
+// quote and memory stays bounded by the number of subscribed mints.
+class PumpFunStreamClient {
+ public:
+  using SubscriptionId = PumpFunClient::SubscriptionId;
+  using QuoteCallback = PumpFunClient::QuoteCallback;
+
+  struct Options {
+    std::chrono::milliseconds connect_timeout{std::chrono::seconds(5)};
+    // A ping is sent after this much idle time; the connection is recycled if
+    // nothing arrives for two intervals.
+    std::chrono::milliseconds ping_interval{std::chrono::seconds(15)};
+    std::chrono::milliseconds initial_reconnect_delay{std::chrono::milliseconds(250)};
+    std::chrono::milliseconds max_reconnect_delay{std::chrono::seconds(10)};
+    std::size_t max_message_bytes = std::size_t{1} << 20;
+    // Mints per subscribe/unsubscribe message.
+    std::size_t max_keys_per_message = 100;
+    std::unordered_map<std::string, std::string> headers;
+  };
+
+  PumpFunStreamClient(std::string url, std::string api_key = {});
+  PumpFunStreamClient(std::string url, std::string api_key, Options options);
+  ~PumpFunStreamClient();
+
+  PumpFunStreamClient(const PumpFunStreamClient&) = delete;
+  PumpFunStreamClient& operator=(const PumpFunStreamClient&) = delete;
+
+  // Starts the I/O and dispatch threads. Connection failures are retried in
+  // the background; isConnected() reports the current state.
+  void start();
+  void stop();
+  bool isRunning() const;
+  bool isConnected() const;
+
+  // Subscriptions may be added before or after start(). Several subscriptions
+  // for the same mint share one wire subscription. Throws std::invalid_argument
+  // unless token_mint is a base58 mint address.
+  SubscriptionId subscribeToQuotes(const std::string& token_mint, QuoteCallback callback);
+
+  // Removes a subscription and waits for an in-flight callback to finish
+  // (unless called from the callback itself).
+  void unsubscribe(SubscriptionId id);
+
+  bool subscriptionHadCallbackError(SubscriptionId id) const;
+
+  StreamStats stats() const;
+
+ private:
+  struct Subscription {
+    SubscriptionId id = 0;
+    std::string token_mint;
+    MintKey key;
+    QuoteCallback callback;
+    std::atomic<bool> active{true};
+    std::atomic<bool> callback_error{false};
+    std::mutex callback_mutex;
+  };
+
+  struct Endpoint {
+    bool tls = false;
+    std::string host;
+    std::string port;
+    std::string target;
+  };
+
+  class Connection;
+
+  static Endpoint parseEndpoint(const std::string& url);
+
+  void ioLoop();
+  void dispatchLoop();
+  std::unique_ptr<Connection> connect();
+  void runConnection(Connection& connection);
+  void handleMessage(const std::string& text);
+  void handleQuote(const nlohmann::json& data);
+  void handleTrade(const nlohmann::json& data);
+  bool isSubscribed(const MintKey& mint) const;
+  void publish(const CompactQuote& quote);
+  // Drains queued subscription changes into outbound text frames.
+  std::vector<std::string> takeSubscriptionMessages(bool resubscribe_all);
+  std::vector<std::string> buildMessages(const char* method,
+                                         const std::vector<MintKey>& keys) const;
+  void wakeIoThread();
+  bool waitBeforeReconnect(std::chrono::milliseconds delay);
+
+  const Endpoint endpoint_;
+  const std::string api_key_;
+  const Options options_;
+
+  std::atomic<bool> running_{false};
+  std::atomic<bool> connected_{false};
+  std::thread io_thread_;
+  std::thread dispatch_thread_;
+  // Self-pipe that interrupts the I/O thread's poll().
+  int wake_pipe_[2] = {-1, -1};
+
+  std::atomic<SubscriptionId> next_subscription_id_{1};
+  mutable std::mutex subscriptions_mutex_;
+  std::unordered_map<SubscriptionId, std::shared_ptr<Subscription>> subscriptions_;
+  // Mint -> subscriptions sharing its wire subscription.
+  std::unordered_map<MintKey, std::vector<std::shared_ptr<Subscription>>> mints_;
+  std::unordered_set<MintKey> pending_subscribe_;
+  std::unordered_set<MintKey> pending_unsubscribe_;
+
+  // Conflated updates awaiting dispatch; bounded by the number of mints.
+  // Mints are decoded once per update and the tables hold fixed-size
+  // entries, so conflation does not touch the heap.
+  std::mutex dispatch_mutex_;
+  std::condition_variable dispatch_condition_;
+  std::unordered_map<MintKey, CompactQuote> pending_quotes_;
+  std::deque<MintKey> dirty_mints_;
+  std::atomic<std::thread::id> dispatch_thread_id_{};
+
+  // Touched only by the I/O thread; seeds trades with the last full quote.
+  std::unordered_map<MintKey, CompactQuote> last_quotes_;
+
+  std::atomic<std::uint64_t> connects_{0};
+  std::atomic<std::uint64_t> messages_received_{0};
+  std::atomic<std::uint64_t> bytes_received_{0};
+  std::atomic<std::uint64_t> quotes_delivered_{0};
+  std::atomic<std::uint64_t> quotes_conflated_{0};
+};
+
+}  // namespace market_data
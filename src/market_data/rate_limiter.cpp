@@ -0,0 +1,182 @@
+#include "market_data/rate_limiter.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace market_data {
+namespace {
+
+// Share of the burst each step down the priority ladder leaves in reserve.
+constexpr double kReservePerClass = 0.1;
+// After a 429 the rate never drops below this share of the configured one.
+constexpr double kMinRateShare = 0.05;
+// Share of the configured rate each success restores.
+constexpr double kRecoveryShare = 0.05;
+constexpr std::chrono::seconds kDefaultRetryAfter{1};
+
+}  // namespace
+
+RateLimiter::RateLimiter(Options options) : options_(options) {
+  validate(options_);
+  rate_ = options_.requests_per_second;
+  tokens_ = options_.burst;
+  refilled_at_ = Clock::now();
+  paused_until_ = refilled_at_;
+}
+
+std::shared_ptr<RateLimiter> RateLimiter::forKey(const std::string& key, const Options& options) {
+  static std::mutex registry_mutex;
+  static std::unordered_map<std::string, std::weak_ptr<RateLimiter>> registry;
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto& slot = registry[key];
+  if (auto existing = slot.lock()) {
+    existing->setOptions(options);
+    return existing;
+  }
+  auto limiter = std::make_shared<RateLimiter>(options);
+  slot = limiter;
+  // Forget limiters whose clients are all gone.
+  for (auto it = registry.begin(); it != registry.end();) {
+    it = it->second.expired() ? registry.erase(it) : std::next(it);
+  }
+  return limiter;
+}
+
+void RateLimiter::validate(const Options& options) const {
+  if (!(options.requests_per_second > 0.0) || !(options.burst >= 1.0)) {
+    throw std::invalid_argument("Rate limit needs requests_per_second > 0 and burst >= 1");
+  }
+}
+
+void RateLimiter::setOptions(const Options& options) {
+  validate(options);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refillLocked(Clock::now());
+    // A rate still recovering from 429s does not jump back up.
+    const bool recovering = rate_ < options_.requests_per_second;
+    options_ = options;
+    rate_ = recovering ? std::min(rate_, options_.requests_per_second)
+                       : options_.requests_per_second;
+    tokens_ = std::min(tokens_, options_.burst);
+  }
+  condition_.notify_all();
+}
+
+RateLimiter::Options RateLimiter::options() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return options_;
+}
+
+bool RateLimiter::acquire(RequestPriority priority) {
+  const auto index = static_cast<std::size_t>(priority);
+  bool granted = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto deadline = Clock::now() + options_.max_wait[index];
+    ++waiting_[index];
+    while (true) {
+      const auto now = Clock::now();
+      refillLocked(now);
+      const auto wait = waitLocked(index, now);
+      if (wait <= Clock::duration::zero()) {
+        tokens_ -= 1.0;
+        ++stats_.granted[index];
+        granted = true;
+        break;
+      }
+      if (now + wait > deadline) {
+        ++stats_.shed[index];
+        break;
+      }
+      condition_.wait_until(lock, now + wait);
+    }
+    --waiting_[index];
+  }
+  // Lower classes held back by this waiter may proceed now.
+  condition_.notify_all();
+  return granted;
+}
+
+std::optional<std::chrono::milliseconds> RateLimiter::tryAcquire(RequestPriority priority) {
+  const auto index = static_cast<std::size_t>(priority);
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+  refillLocked(now);
+  const auto wait = waitLocked(index, now);
+  if (wait <= Clock::duration::zero()) {
+    tokens_ -= 1.0;
+    ++stats_.granted[index];
+    return std::chrono::milliseconds(0);
+  }
+  if (wait > options_.max_wait[index]) {
+    ++stats_.shed[index];
+    return std::nullopt;
+  }
+  return std::max(std::chrono::milliseconds(1),
+                  std::chrono::ceil<std::chrono::milliseconds>(wait));
+}
+
+void RateLimiter::onRateLimited(std::chrono::milliseconds retry_after) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+  refillLocked(now);
+  ++stats_.rate_limited_responses;
+  tokens_ = 0.0;
+  paused_until_ = std::max(paused_until_,
+                           now + (retry_after.count() > 0 ? retry_after : kDefaultRetryAfter));
+  rate_ = std::max(rate_ / 2.0, options_.requests_per_second * kMinRateShare);
+}
+
+void RateLimiter::onSuccess() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (rate_ < options_.requests_per_second) {
+    refillLocked(Clock::now());
+    rate_ = std::min(options_.requests_per_second,
+                     rate_ + options_.requests_per_second * kRecoveryShare);
+  }
+}
+
+RateLimiterStats RateLimiter::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RateLimiterStats stats = stats_;
+  stats.requests_per_second = rate_;
+  return stats;
+}
+
+void RateLimiter::refillLocked(Clock::time_point now) {
+  // Nothing accrues while paused by a Retry-After.
+  const auto from = std::max(refilled_at_, paused_until_);
+  if (now > from) {
+    tokens_ = std::min(options_.burst,
+                       tokens_ + std::chrono::duration<double>(now - from).count() * rate_);
+  }
+  refilled_at_ = std::max(refilled_at_, now);
+}
+
+double RateLimiter::reserveLocked(std::size_t index) const {
+  // Capped so that every class can still fill up to a whole token.
+  return std::min(static_cast<double>(index) * kReservePerClass * options_.burst,
+                  options_.burst - 1.0);
+}
+
+RateLimiter::Clock::duration RateLimiter::waitLocked(std::size_t index,
+                                                     Clock::time_point now) const {
+  Clock::duration wait = paused_until_ > now ? paused_until_ - now : Clock::duration::zero();
+  const double missing = 1.0 + reserveLocked(index) - tokens_;
+  if (missing > 0.0) {
+    wait += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(missing / rate_));
+  }
+  for (std::size_t higher = 0; higher < index; ++higher) {
+    if (waiting_[higher] > 0) {
+      // Let the waiting class go first, then look again.
+      return std::max(wait, std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(1.0 / rate_)));
+    }
+  }
+  return wait;
+}
+
+}  // namespace market_data
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace market_data {
+
+// Request classes, highest priority first.
+enum class RequestPriority : std::uint8_t {
+  // Quotes for mints with an open position.
+  HeldPosition = 0,
+  // Every other quote.
+  Watchlist,
+  Candles,
+  Metadata,
+};
+
+inline constexpr std::size_t kRequestPriorityCount = 4;
+
+// Thrown when the rate limiter sheds a request instead of queueing it.
+class RateLimitedError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+struct RateLimiterStats {
+  // Indexed by RequestPriority.
+  std::array<std::uint64_t, kRequestPriorityCount> granted{};
+  std::array<std::uint64_t, kRequestPriorityCount> shed{};
+  // 429 responses reported by clients.
+  std::uint64_t rate_limited_responses = 0;
+  // Current refill rate, below the configured one while recovering from 429s.
+  double requests_per_second = 0.0;
+};
+
+// RateLimiter is a token bucket shared by every client that uses one API key.
+// A request may not take a token while a higher class is waiting, and lower
+// classes leave part of the burst in reserve, so a metadata scan cannot starve
+// quotes for held positions. A request whose wait would exceed its class's
+// max_wait is shed instead of queued. A 429 empties the bucket, pauses it for
+// the response's Retry-After and halves the rate; each later success restores
+// 5% of the configured rate.
+class RateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    double requests_per_second = 10.0;
+    // Bucket capacity, i.e. the largest burst.
+    double burst = 10.0;
+    // Longest a request of each class queues before it is shed, indexed by
+    // RequestPriority.
+    std::array<std::chrono::milliseconds, kRequestPriorityCount> max_wait{
+        std::chrono::seconds(5), std::chrono::seconds(2), std::chrono::seconds(1),
+        std::chrono::milliseconds(500)};
+  };
+
+  // Throws std::invalid_argument unless the rate and burst are positive.
+  explicit RateLimiter(Options options);
+
+  // The limiter shared by every client using key. The first caller creates it
+  // with options; later callers' options replace the current ones.
+  static std::shared_ptr<RateLimiter> forKey(const std::string& key, const Options& options);
+
+  void setOptions(const Options& options);
+  Options options() const;
+
+  // Blocks until a token is granted. Returns false if the request was shed.
+  bool acquire(RequestPriority priority);
+
+  // Non-blocking acquire for event-loop callers. Returns zero when a token was
+  // granted, otherwise how long to wait before trying again, or std::nullopt
+  // when the request is shed because that wait exceeds its class's max_wait.
+  std::optional<std::chrono::milliseconds> tryAcquire(RequestPriority priority);
+
+  // Reports a 429 response; a zero retry_after pauses for one second.
+  void onRateLimited(std::chrono::milliseconds retry_after);
+  // Reports a response that was not rate limited.
+  void onSuccess();
+
+  RateLimiterStats stats() const;
+
+ private:
+  void validate(const Options& options) const;
+  void refillLocked(Clock::time_point now);
+  // Tokens a class must leave in the bucket for the classes above it.
+  double reserveLocked(std::size_t index) const;
+  // Zero when the class can take a token now.
+  Clock::duration waitLocked(std::size_t index, Clock::time_point now) const;
+
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  Options options_;
+  double rate_;
+  double tokens_;
+  Clock::time_point refilled_at_;
+  Clock::time_point paused_until_;
+  std::array<std::size_t, kRequestPriorityCount> waiting_{};
+  RateLimiterStats stats_;
+};
+
+}  // namespace market_data
@@ -0,0 +1,92 @@
+#include "market_data/receive_buffer.h"
+
+#include <string_view>
+#include <utility>
+
+namespace market_data {
+namespace {
+
+// Whether the response was sent compressed (curl_easy_header needs 7.84).
+bool isContentEncoded(CURL* handle) {
+#if LIBCURL_VERSION_NUM >= 0x075400
+  curl_header* header = nullptr;
+  if (curl_easy_header(handle, "Content-Encoding", 0, CURLH_HEADER, -1, &header) ==
+      CURLHE_OK) {
+    return std::string_view(header->value) != "identity";
+  }
+  return false;
+#else
+  (void)handle;
+  return false;
+#endif
+}
+
+}  // namespace
+
+void ReceiveBuffer::attach(CURL* handle, Consumer consumer) {
+  handle_ = handle;
+  data_.clear();
+  sized_ = false;
+  consumer_ = std::move(consumer);
+  streaming_ = false;
+  consumer_error_ = nullptr;
+  curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &ReceiveBuffer::onWrite);
+  curl_easy_setopt(handle, CURLOPT_WRITEDATA, this);
+}
+
+std::string ReceiveBuffer::take() {
+  std::string body = std::move(data_);
+  data_.clear();
+  return body;
+}
+
+void ReceiveBuffer::recycle(std::string storage) {
+  if (storage.capacity() > kMaxRetainedBytes) {
+    data_ = std::string();
+    return;
+  }
+  storage.clear();
+  data_ = std::move(storage);
+}
+
+void ReceiveBuffer::rethrowConsumerError() const {
+  if (consumer_error_) {
+    std::rethrow_exception(consumer_error_);
+  }
+}
+
+size_t ReceiveBuffer::onWrite(char* contents, size_t size, size_t nmemb, void* userp) {
+  auto* buffer = static_cast<ReceiveBuffer*>(userp);
+  const size_t total_size = size * nmemb;
+  if (!buffer->sized_) {
+    // The headers, and with them Content-Length, are in by the first chunk.
+    buffer->sized_ = true;
+    long status_code = 0;
+    curl_easy_getinfo(buffer->handle_, CURLINFO_RESPONSE_CODE, &status_code);
+    buffer->streaming_ = buffer->consumer_ && status_code < 400;
+    // Content-Length counts encoded bytes, which says little about the
+    // decoded size of a compressed body.
+    curl_off_t length = -1;
+    if (!buffer->streaming_ && !isContentEncoded(buffer->handle_) &&
+        curl_easy_getinfo(buffer->handle_, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) ==
+            CURLE_OK &&
+        length > 0 && static_cast<std::size_t>(length) <= kMaxPresizeBytes) {
+      buffer->data_.reserve(static_cast<std::size_t>(length));
+    }
+  }
+  if (buffer->streaming_) {
+    // Exceptions must not unwind through libcurl; returning short aborts the
+    // transfer instead.
+    try {
+      buffer->consumer_(std::string_view(contents, total_size));
+    } catch (...) {
+      buffer->consumer_error_ = std::current_exception();
+      return 0;
+    }
+    return total_size;
+  }
+  buffer->data_.append(contents, total_size);
+  return total_size;
+}
+
+}  // namespace market_data
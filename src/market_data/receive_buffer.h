@@ -0,0 +1,62 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace market_data {
+
+// ReceiveBuffer collects the response body of a cURL easy handle. When the
+// first chunk of a transfer arrives it reserves the announced Content-Length,
+// so a large body is allocated once instead of growing chunk by chunk. A
+// buffer whose body is read in place is recycled for the handle's next
+// transfer, so a handle serving a stream of small polls stops allocating.
+// With a consumer attached, a successful response's body is passed on chunk
+// by chunk (already decompressed) instead of being collected.
+class ReceiveBuffer {
+ public:
+  // Takes one chunk of the body. It may throw; the transfer is then aborted
+  // and the exception kept for rethrowConsumerError().
+  using Consumer = std::function<void(std::string_view chunk)>;
+
+  // Larger Content-Length values are not trusted for presizing.
+  static constexpr std::size_t kMaxPresizeBytes = 64 * 1024 * 1024;
+  // Storage above this size is released by recycle() rather than kept.
+  static constexpr std::size_t kMaxRetainedBytes = 1024 * 1024;
+
+  // Empties the buffer and points handle's write callback at it. The buffer
+  // must stay at the same address until the transfer completes. Error
+  // responses (status 400 and up) are collected even with a consumer, for the
+  // error message.
+  void attach(CURL* handle, Consumer consumer = {});
+
+  const std::string& data() const { return data_; }
+
+  // Moves the body out; its storage goes with it.
+  std::string take();
+  // Takes back storage lent out with take(), for the next transfer. Keeps it
+  // unless it grew beyond kMaxRetainedBytes.
+  void recycle(std::string storage);
+
+  // Whether the consumer threw during the current transfer.
+  bool consumerFailed() const { return static_cast<bool>(consumer_error_); }
+  // Rethrows what the consumer threw, if anything.
+  void rethrowConsumerError() const;
+
+ private:
+  static size_t onWrite(char* contents, size_t size, size_t nmemb, void* userp);
+
+  CURL* handle_ = nullptr;
+  std::string data_;
+  bool sized_ = false;
+  Consumer consumer_;
+  // Set on the first chunk: whether this response goes to the consumer.
+  bool streaming_ = false;
+  std::exception_ptr consumer_error_;
+};
+
+}  // namespace market_data
@@ -0,0 +1,55 @@
+#include "market_data/request_coalescer.h"
+
+#include <exception>
+#include <utility>
+
+namespace market_data {
+
+std::string RequestCoalescer::run(const std::string& key, const Fetch& fetch) {
+  std::promise<std::string> promise;
+  std::shared_future<std::string> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = in_flight_.find(key);
+    if (it != in_flight_.end()) {
+      ++stats_.coalesced_requests;
+      ++it->second.waiters;
+      pending = it->second.result;
+    } else {
+      ++stats_.upstream_requests;
+      in_flight_.emplace(key, Flight{promise.get_future().share(), 0});
+    }
+  }
+  if (pending.valid()) {
+    // Rethrows the leader's exception, if any.
+    return pending.get();
+  }
+
+  // The key is released before waiters wake so a caller arriving after the
+  // result is published starts a fresh request instead of reusing it.
+  const auto release = [this, &key]() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = in_flight_.find(key);
+    const std::size_t waiters = it->second.waiters;
+    in_flight_.erase(it);
+    return waiters;
+  };
+  try {
+    std::string result = fetch();
+    if (release() > 0) {
+      promise.set_value(result);
+    }
+    return result;
+  } catch (...) {
+    release();
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+
+RequestCoalescingStats RequestCoalescer::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace market_data
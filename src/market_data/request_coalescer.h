@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace market_data {
+
+struct RequestCoalescingStats {
+  // Calls that went upstream.
+  std::uint64_t upstream_requests = 0;
+  // Calls answered by joining a request that was already in flight, i.e.
+  // upstream requests saved.
+  std::uint64_t coalesced_requests = 0;
+};
+
+// RequestCoalescer ("singleflight") collapses concurrent identical requests:
+// the first caller for a key runs the fetch and every caller that arrives
+// while it is in flight waits for and shares its result, or its exception.
+// Results are not cached; a key is forgotten as soon as its fetch completes.
+class RequestCoalescer {
+ public:
+  using Fetch = std::function<std::string()>;
+
+  std::string run(const std::string& key, const Fetch& fetch);
+
+  RequestCoalescingStats stats() const;
+
+ private:
+  struct Flight {
+    std::shared_future<std::string> result;
+    // Callers waiting on result; without any, the leader keeps the result
+    // instead of copying it into the future.
+    std::size_t waiters = 0;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Flight> in_flight_;
+  RequestCoalescingStats stats_;
+};
+
+}  // namespace market_data
@@ -0,0 +1,134 @@
+#include "market_data/response_cache.h"
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace market_data {
+namespace {
+// Rough per-entry bookkeeping cost: list node, index node and string headers.
+constexpr std::size_t kEntryOverheadBytes = 160;
+}  // namespace
+
+double ResponseCacheStats::hitRate() const {
+  const std::uint64_t lookups = hits + misses;
+  if (lookups == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+ResponseCache::ResponseCache(std::size_t max_bytes, std::size_t shards)
+    : max_shard_bytes_(0) {
+  if (shards == 0) {
+    throw std::invalid_argument("ResponseCache needs at least one shard");
+  }
+  shards_.reserve(shards);
+  for (std::size_t i = 0; i < shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+  max_shard_bytes_.store(max_bytes / shards);
+}
+
+std::optional<CachedResponse> ResponseCache::lookup(const std::string& key,
+                                                    std::chrono::steady_clock::time_point now) {
+  Shard& shard = shardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    ++shard.misses;
+    return std::nullopt;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  if (now < it->second->response.expires_at) {
+    ++shard.hits;
+  } else {
+    ++shard.misses;
+  }
+  return it->second->response;
+}
+
+void ResponseCache::store(const std::string& key, CachedResponse response) {
+  const std::size_t bytes = entryBytes(key, response);
+  Shard& shard = shardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    shard.bytes -= it->second->bytes;
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+  }
+  if (bytes > max_shard_bytes_.load()) {
+    // Larger than the whole shard; caching it would only flush everything else.
+    return;
+  }
+  shard.lru.push_front(Entry{key, std::move(response), bytes});
+  shard.index.emplace(key, shard.lru.begin());
+  shard.bytes += bytes;
+  evictLocked(shard);
+}
+
+void ResponseCache::refresh(const std::string& key,
+                            std::chrono::steady_clock::time_point expires_at) {
+  Shard& shard = shardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    return;
+  }
+  it->second->response.expires_at = expires_at;
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  ++shard.revalidations;
+}
+
+void ResponseCache::recordStaleServed() {
+  ++stale_served_;
+}
+
+void ResponseCache::reset(std::size_t max_bytes) {
+  max_shard_bytes_.store(max_bytes / shards_.size());
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->lru.clear();
+    shard->index.clear();
+    shard->bytes = 0;
+  }
+}
+
+ResponseCacheStats ResponseCache::stats() const {
+  ResponseCacheStats stats;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    stats.hits += shard->hits;
+    stats.misses += shard->misses;
+    stats.revalidations += shard->revalidations;
+    stats.evictions += shard->evictions;
+    stats.entries += shard->index.size();
+    stats.bytes += shard->bytes;
+  }
+  stats.stale_served = stale_served_.load();
+  return stats;
+}
+
+std::size_t ResponseCache::entryBytes(const std::string& key, const CachedResponse& response) {
+  // The key is stored twice: in the entry and in the index.
+  return 2 * key.size() + response.body.size() + response.etag.size() +
+         response.last_modified.size() + kEntryOverheadBytes;
+}
+
+ResponseCache::Shard& ResponseCache::shardFor(const std::string& key) {
+  return *shards_[std::hash<std::string>{}(key) % shards_.size()];
+}
+
+void ResponseCache::evictLocked(Shard& shard) {
+  const std::size_t limit = max_shard_bytes_.load();
+  while (shard.bytes > limit && !shard.lru.empty()) {
+    const Entry& victim = shard.lru.back();
+    shard.bytes -= victim.bytes;
+    shard.index.erase(victim.key);
+    shard.lru.pop_back();
+    ++shard.evictions;
+  }
+}
+
+}  // namespace market_data
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace market_data {
+
+struct ResponseCacheStats {
+  // Lookups answered from a fresh entry.
+  std::uint64_t hits = 0;
+  // Lookups that went upstream: no entry, or an expired one.
+  std::uint64_t misses = 0;
+  // Expired entries the server confirmed unchanged (304 Not Modified).
+  std::uint64_t revalidations = 0;
+  // Expired entries served because the upstream request failed.
+  std::uint64_t stale_served = 0;
+  std::uint64_t evictions = 0;
+  std::size_t entries = 0;
+  // Approximate memory held by cached keys, bodies and validators.
+  std::size_t bytes = 0;
+
+  double hitRate() const;
+};
+
+// A cached GET response together with the validators needed to revalidate it.
+struct CachedResponse {
+  std::string body;
+  std::string etag;
+  std::string last_modified;
+  std::chrono::steady_clock::time_point expires_at{};
+};
+
+// ResponseCache is a size-bounded LRU keyed by request (URL and headers). Keys
+// are spread over independently locked shards so concurrent fetches of
+// different mints rarely contend; each shard evicts its least recently used
+// entries once it exceeds its share of the byte budget. Expired entries are
+// kept (until evicted) so they can be revalidated or served when upstream is
+// down.
+class ResponseCache {
+ public:
+  explicit ResponseCache(std::size_t max_bytes = 16 * 1024 * 1024, std::size_t shards = 16);
+
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  // Returns the entry for key, fresh or not, and counts a hit when it has not
+  // expired at now and a miss otherwise.
+  std::optional<CachedResponse> lookup(const std::string& key,
+                                       std::chrono::steady_clock::time_point now);
+
+  void store(const std::string& key, CachedResponse response);
+
+  // Extends an entry the server reported unchanged.
+  void refresh(const std::string& key, std::chrono::steady_clock::time_point expires_at);
+
+  void recordStaleServed();
+
+  // Drops every entry and resizes the byte budget.
+  void reset(std::size_t max_bytes);
+
+  ResponseCacheStats stats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    CachedResponse response;
+    std::size_t bytes = 0;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used first.
+    std::list<Entry> lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::size_t bytes = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t revalidations = 0;
+    std::uint64_t evictions = 0;
+  };
+
+  static std::size_t entryBytes(const std::string& key, const CachedResponse& response);
+
+  Shard& shardFor(const std::string& key);
+  // Requires shard.mutex.
+  void evictLocked(Shard& shard);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<std::size_t> max_shard_bytes_;
+  std::atomic<std::uint64_t> stale_served_{0};
+};
+
+}  // namespace market_data
@@ -0,0 +1,624 @@
+#include "market_data/response_parser.h"
+
+#include "market_data/json_cursor.h"
+#include "market_data/timestamp.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+
+namespace market_data {
+namespace {
+
+constexpr std::size_t kMaxAliases = 3;
+
+// One output field and the keys it may arrive under, most preferred first.
+template <typename Record>
+struct FieldSpec {
+  std::array<std::string_view, kMaxAliases> aliases;
+  std::string Record::*text = nullptr;
+  double Record::*number = nullptr;
+  // ISO-8601 string or epoch number, stored as epoch nanoseconds.
+  TimestampNs Record::*time = nullptr;
+};
+
+const std::array<FieldSpec<TokenQuote>, 6> kQuoteFields = {{
+    {{"mint", "address"}, &TokenQuote::mint, nullptr},
+    {{"price", "priceUsd", "usdPrice"}, nullptr, &TokenQuote::price},
+    {{"priceChange24h", "price_change_24h", "priceChange"}, nullptr, &TokenQuote::price_change_24h},
+    {{"volume24h", "volume_24h", "volume"}, nullptr, &TokenQuote::volume_24h},
+    {{"liquidity", "liquidityUsd"}, nullptr, &TokenQuote::liquidity},
+    {{"timestamp", "updatedAt", "time"}, nullptr, nullptr, &TokenQuote::timestamp_ns},
+}};
+
+const std::array<FieldSpec<HistoricalCandle>, 8> kCandleFields = {{
+    {{"open_time", "startTime", "time"}, nullptr, nullptr, &HistoricalCandle::open_time_ns},
+    {{"close_time", "closeTime", "endTime"}, nullptr, nullptr, &HistoricalCandle::close_time_ns},
+    {{"open"}, nullptr, &HistoricalCandle::open},
+    {{"high"}, nullptr, &HistoricalCandle::high},
+    {{"low"}, nullptr, &HistoricalCandle::low},
+    {{"close"}, nullptr, &HistoricalCandle::close},
+    {{"volume", "volumeUsd"}, nullptr, &HistoricalCandle::volume},
+    {{"quote_volume", "quoteVolume"}, nullptr, &HistoricalCandle::quote_volume},
+}};
+
+// Consumes the value at the cursor, storing it in the field when it has a
+// usable type (timestamps must also parse). Returns whether it was stored.
+template <typename Record>
+bool readField(JsonCursor& cursor,
+               const FieldSpec<Record>& spec,
+               Record& record,
+               std::string& scratch) {
+  const JsonCursor::Kind kind = cursor.peek();
+  if (kind == JsonCursor::Kind::Number && (spec.number || spec.time)) {
+    if (spec.number) {
+      record.*spec.number = cursor.readNumber();
+      return true;
+    }
+    TimestampNs timestamp = 0;
+    if (parseTimestamp(cursor.readNumberText(), timestamp) && timestamp != 0) {
+      record.*spec.time = timestamp;
+      return true;
+    }
+    return false;
+  }
+  if (kind == JsonCursor::Kind::String && (spec.text || spec.time)) {
+    const std::string_view text = cursor.readString(scratch);
+    if (spec.text) {
+      record.*spec.text = std::string(text);
+      return true;
+    }
+    TimestampNs timestamp = 0;
+    if (parseTimestamp(text, timestamp) && timestamp != 0) {
+      record.*spec.time = timestamp;
+      return true;
+    }
+    return false;
+  }
+  cursor.skipValue();
+  return false;
+}
+
+// Reads the object at the cursor into record in one pass. Like the DOM path,
+// only the first occurrence of a key counts, a value of the wrong type is
+// ignored, and the most preferred alias that holds a usable value wins.
+// Returns the alias each field was taken from (kMaxAliases when absent).
+template <typename Record, std::size_t N>
+std::array<std::size_t, N> readFields(JsonCursor& cursor,
+                                      const std::array<FieldSpec<Record>, N>& fields,
+                                      Record& record) {
+  std::array<std::size_t, N> best;
+  best.fill(kMaxAliases);
+  std::array<std::uint8_t, N> seen{};
+  std::string key_scratch;
+  std::string value_scratch;
+  std::string_view key;
+
+  cursor.enterObject();
+  while (cursor.nextMember(key, key_scratch)) {
+    std::size_t field = 0;
+    std::size_t alias = kMaxAliases;
+    for (; field < N; ++field) {
+      const auto& aliases = fields[field].aliases;
+      alias = 0;
+      while (alias < kMaxAliases && !aliases[alias].empty() && aliases[alias] != key) {
+        ++alias;
+      }
+      if (alias < kMaxAliases && !aliases[alias].empty()) {
+        break;
+      }
+    }
+
+    const auto bit = static_cast<std::uint8_t>(1U << alias);
+    if (field == N || (seen[field] & bit) != 0 || alias > best[field]) {
+      cursor.skipValue();
+      continue;
+    }
+    seen[field] |= bit;
+    if (readField(cursor, fields[field], record, value_scratch)) {
+      best[field] = alias;
+    }
+  }
+  return best;
+}
+
+std::size_t layoutAlias(std::uint32_t layout, std::size_t field) {
+  return (layout >> (2 * field)) & FieldLayoutCache::kAbsent;
+}
+
+template <std::size_t N>
+std::uint32_t packLayout(const std::array<std::size_t, N>& aliases) {
+  static_assert(2 * N < 31, "layout does not fit the packed representation");
+  std::uint32_t layout = 0;
+  for (std::size_t field = 0; field < N; ++field) {
+    const std::size_t alias = aliases[field] < kMaxAliases ? aliases[field] : FieldLayoutCache::kAbsent;
+    layout |= static_cast<std::uint32_t>(alias) << (2 * field);
+  }
+  return layout;
+}
+
+// Fast path: each key is only compared with the alias its field used in the
+// detected layout. Returns false, leaving record partly filled, when the
+// record does not fit the layout.
+template <typename Record, std::size_t N>
+bool readFieldsWithLayout(JsonCursor& cursor,
+                          const std::array<FieldSpec<Record>, N>& fields,
+                          std::uint32_t layout,
+                          Record& record) {
+  // The key each field is expected under; empty for fields absent at detection.
+  std::array<std::string_view, N> names{};
+  std::uint32_t expected = 0;
+  for (std::size_t field = 0; field < N; ++field) {
+    const std::size_t alias = layoutAlias(layout, field);
+    if (alias != FieldLayoutCache::kAbsent) {
+      names[field] = fields[field].aliases[alias];
+      expected |= 1U << field;
+    }
+  }
+  const bool has_absent = expected != (1U << N) - 1;
+
+  std::uint32_t found = 0;
+  std::string key_scratch;
+  std::string value_scratch;
+  std::string_view key;
+  cursor.enterObject();
+  while (cursor.nextMember(key, key_scratch)) {
+    std::size_t field = 0;
+    while (field < N && names[field] != key) {
+      ++field;
+    }
+    if (field == N) {
+      if (has_absent) {
+        for (std::size_t absent = 0; absent < N; ++absent) {
+          if (names[absent].empty()) {
+            for (const auto name : fields[absent].aliases) {
+              if (!name.empty() && name == key) {
+                // A field missing when the layout was detected has appeared.
+                return false;
+              }
+            }
+          }
+        }
+      }
+      cursor.skipValue();
+      continue;
+    }
+    if ((found & (1U << field)) != 0) {
+      cursor.skipValue();
+      continue;
+    }
+
+    if (!readField(cursor, fields[field], record, value_scratch)) {
+      return false;
+    }
+    found |= 1U << field;
+  }
+  return found == expected;
+}
+
+template <typename Record, std::size_t N>
+void readRecord(JsonCursor& cursor,
+                const std::array<FieldSpec<Record>, N>& fields,
+                FieldLayoutCache* cache,
+                Record& record) {
+  if (cache == nullptr) {
+    readFields(cursor, fields, record);
+    return;
+  }
+  const std::uint32_t layout = cache->layout();
+  if ((layout & FieldLayoutCache::kDetected) != 0) {
+    JsonCursor start = cursor;
+    if (readFieldsWithLayout(cursor, fields, layout, record)) {
+      return;
+    }
+    // Full detection assigns every field the fast path may have set.
+    cursor = start;
+  }
+  cache->update(packLayout(readFields(cursor, fields, record)));
+}
+
+// Keys a candle array may be nested under, outermost first.
+constexpr std::array<std::string_view, 3> kCandleWrappers = {"result", "data", "candles"};
+
+bool isJsonSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// A cursor on the value of key when the cursor is on an object that has it.
+std::optional<JsonCursor> memberOf(JsonCursor cursor, std::string_view key) {
+  if (cursor.peek() != JsonCursor::Kind::Object) {
+    return std::nullopt;
+  }
+  std::string scratch;
+  std::string_view name;
+  cursor.enterObject();
+  while (cursor.nextMember(name, scratch)) {
+    if (name == key) {
+      return cursor;
+    }
+    cursor.skipValue();
+  }
+  return std::nullopt;
+}
+
+// Rejects malformed documents up front, as a full parse would.
+JsonCursor validatedRoot(std::string_view payload) {
+  JsonCursor root(payload);
+  JsonCursor scan = root;
+  scan.skipValue();
+  scan.expectEnd();
+  return root;
+}
+
+}  // namespace
+
+TokenQuote parseQuoteResponse(std::string_view payload, FieldLayoutCache* layout) {
+  TokenQuote quote;
+  if (payload.empty()) {
+    return quote;
+  }
+
+  JsonCursor cursor = validatedRoot(payload);
+  if (auto result = memberOf(cursor, "result")) {
+    cursor = *result;
+  }
+  if (auto data = memberOf(cursor, "data"); data && data->peek() == JsonCursor::Kind::Object) {
+    cursor = *data;
+  }
+  if (cursor.peek() == JsonCursor::Kind::Array) {
+    JsonCursor first = cursor;
+    first.enterArray();
+    if (first.nextElement()) {
+      cursor = first;
+    }
+  }
+  if (cursor.peek() == JsonCursor::Kind::Object) {
+    readRecord(cursor, kQuoteFields, layout, quote);
+  }
+  return quote;
+}
+
+std::unordered_map<std::string, TokenQuote> parseBatchQuoteResponse(
+    std::string_view payload,
+    const std::vector<std::string>& token_mints,
+    FieldLayoutCache* layout) {
+  std::unordered_map<std::string, TokenQuote> quotes;
+  if (payload.empty()) {
+    return quotes;
+  }
+
+  JsonCursor cursor = validatedRoot(payload);
+  for (const std::string_view wrapper : {"result", "data", "quotes"}) {
+    if (auto inner = memberOf(cursor, wrapper)) {
+      cursor = *inner;
+    }
+  }
+
+  const auto readQuote = [&](JsonCursor& at) {
+    TokenQuote quote;
+    if (at.peek() == JsonCursor::Kind::Object) {
+      readRecord(at, kQuoteFields, layout, quote);
+    } else {
+      at.skipValue();
+    }
+    return quote;
+  };
+
+  switch (cursor.peek()) {
+    case JsonCursor::Kind::Array:
+      cursor.enterArray();
+      while (cursor.nextElement()) {
+        TokenQuote quote = readQuote(cursor);
+        if (!quote.mint.empty()) {
+          std::string mint = quote.mint;
+          quotes.insert_or_assign(std::move(mint), std::move(quote));
+        }
+      }
+      break;
+    case JsonCursor::Kind::Object: {
+      const std::unordered_set<std::string_view> requested(token_mints.begin(), token_mints.end());
+      std::string scratch;
+      std::string_view key;
+      cursor.enterObject();
+      while (cursor.nextMember(key, scratch)) {
+        if (requested.count(key) == 0) {
+          cursor.skipValue();
+          continue;
+        }
+        std::string mint(key);
+        TokenQuote quote = readQuote(cursor);
+        if (quote.mint.empty()) {
+          quote.mint = mint;
+        }
+        quotes.insert_or_assign(std::move(mint), std::move(quote));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return quotes;
+}
+
+std::vector<HistoricalCandle> parseCandlesResponse(std::string_view payload,
+                                                   const std::string& token_mint,
+                                                   const std::string& timeframe,
+                                                   FieldLayoutCache* layout) {
+  std::vector<HistoricalCandle> candles;
+  if (payload.empty()) {
+    // An empty body reads as an empty object: one candle with defaults.
+    payload = "{}";
+  }
+
+  JsonCursor cursor = validatedRoot(payload);
+  for (const std::string_view wrapper : kCandleWrappers) {
+    if (auto inner = memberOf(cursor, wrapper)) {
+      cursor = *inner;
+    }
+  }
+
+  const auto readCandle = [&](JsonCursor& at) {
+    HistoricalCandle candle;
+    candle.mint = token_mint;
+    candle.timeframe = timeframe;
+    if (at.peek() == JsonCursor::Kind::Object) {
+      readRecord(at, kCandleFields, layout, candle);
+    } else {
+      at.skipValue();
+    }
+    candles.push_back(std::move(candle));
+  };
+
+  switch (cursor.peek()) {
+    case JsonCursor::Kind::Array:
+      cursor.enterArray();
+      while (cursor.nextElement()) {
+        readCandle(cursor);
+      }
+      break;
+    case JsonCursor::Kind::Null:
+      break;
+    default:
+      readCandle(cursor);
+      break;
+  }
+  return candles;
+}
+
+CandleStreamParser::CandleStreamParser(std::string token_mint,
+                                       std::string timeframe,
+                                       CandleCallback on_candle,
+                                       FieldLayoutCache* layout)
+    : mint_(std::move(token_mint)),
+      timeframe_(std::move(timeframe)),
+      on_candle_(std::move(on_candle)),
+      layout_(layout) {}
+
+void CandleStreamParser::feed(std::string_view chunk) {
+  for (const char c : chunk) {
+    step(c);
+  }
+}
+
+void CandleStreamParser::finish() {
+  switch (mode_) {
+    case Mode::kSearching:
+    case Mode::kBuffering:
+      for (auto& candle : parseCandlesResponse(buffer_, mint_, timeframe_, layout_)) {
+        deliver(std::move(candle));
+      }
+      break;
+    case Mode::kStreaming:
+      throw JsonParseError("Candle response ended inside the candle array");
+    case Mode::kDone:
+      if (!stack_.empty()) {
+        throw JsonParseError("Candle response ended before its closing bracket");
+      }
+      break;
+  }
+  buffer_.clear();
+}
+
+void CandleStreamParser::reset() {
+  mode_ = Mode::kSearching;
+  stack_.clear();
+  buffer_.clear();
+  in_string_ = false;
+  escaped_ = false;
+  reading_key_ = false;
+  key_.clear();
+  pending_wrapper_ = -1;
+  expect_value_ = true;
+  root_closed_ = false;
+  array_depth_ = 0;
+  capturing_ = false;
+  delivered_ = 0;
+}
+
+void CandleStreamParser::step(char c) {
+  const auto keep = [this](char kept) {
+    if (mode_ == Mode::kSearching || mode_ == Mode::kBuffering || capturing_) {
+      buffer_.push_back(kept);
+    }
+  };
+
+  if (in_string_) {
+    if (escaped_) {
+      escaped_ = false;
+    } else if (c == '\\') {
+      escaped_ = true;
+    } else if (c == '"') {
+      in_string_ = false;
+    }
+    if (reading_key_) {
+      if (in_string_) {
+        key_.push_back(c);
+      } else {
+        reading_key_ = false;
+        const Frame& frame = stack_.back();
+        for (std::size_t wrapper = static_cast<std::size_t>(frame.next_wrapper);
+             wrapper < kCandleWrappers.size(); ++wrapper) {
+          if (key_ == kCandleWrappers[wrapper]) {
+            pending_wrapper_ = static_cast<int>(wrapper + 1);
+            break;
+          }
+        }
+      }
+    }
+    keep(c);
+    return;
+  }
+  if (isJsonSpace(c)) {
+    keep(c);
+    return;
+  }
+  if (root_closed_) {
+    throw JsonParseError("Unexpected data after candle response");
+  }
+
+  if (mode_ == Mode::kStreaming && stack_.size() == array_depth_) {
+    // Between elements of the candle array. Containers are emitted when they
+    // close; anything else ends at the next separator.
+    if (capturing_ && (c == ',' || c == ']')) {
+      emitElement();
+    }
+    if (!capturing_ && c != ',' && c != ']') {
+      capturing_ = true;
+      buffer_.clear();
+    }
+  }
+
+  switch (c) {
+    case '{':
+    case '[':
+      beginValue(c);
+      break;
+    case '}':
+    case ']':
+      closeContainer(c);
+      break;
+    case '"':
+      in_string_ = true;
+      if (!stack_.empty() && stack_.back().object && stack_.back().expect_key) {
+        // Only keys of objects on the way to the candle array are looked at.
+        reading_key_ = mode_ == Mode::kSearching && stack_.back().next_wrapper >= 0;
+        key_.clear();
+        pending_wrapper_ = -1;
+      } else {
+        beginValue(c);
+      }
+      break;
+    case ':':
+      if (stack_.empty() || !stack_.back().object || !stack_.back().expect_key) {
+        throw JsonParseError("Unexpected ':' in candle response");
+      }
+      stack_.back().expect_key = false;
+      expect_value_ = true;
+      break;
+    case ',':
+      if (stack_.empty()) {
+        throw JsonParseError("Unexpected ',' in candle response");
+      }
+      if (stack_.back().object) {
+        stack_.back().expect_key = true;
+      } else {
+        expect_value_ = true;
+      }
+      break;
+    default:
+      // Only the first character of a literal starts a value.
+      if (expect_value_) {
+        beginValue(c);
+      }
+      break;
+  }
+  keep(c);
+
+  if (capturing_ && stack_.size() == array_depth_ && (c == '}' || c == ']')) {
+    emitElement();
+  }
+}
+
+void CandleStreamParser::beginValue(char c) {
+  expect_value_ = false;
+  // How many wrappers are behind this value when it is on the way to the
+  // candle array; -1 otherwise.
+  int stage = -1;
+  if (stack_.empty()) {
+    stage = 0;
+  } else if (pending_wrapper_ >= 0) {
+    stage = pending_wrapper_;
+    pending_wrapper_ = -1;
+    // Later keys of the enclosing object no longer matter.
+    stack_.back().next_wrapper = -1;
+  }
+
+  if (stage >= 0 && mode_ == Mode::kSearching) {
+    if (c == '[') {
+      // The candle array: from here on only the current element is kept.
+      mode_ = Mode::kStreaming;
+      buffer_.clear();
+      stack_.push_back(Frame{false, false, -1});
+      array_depth_ = stack_.size();
+      expect_value_ = true;
+      return;
+    }
+    if (c != '{' || static_cast<std::size_t>(stage) == kCandleWrappers.size()) {
+      // A single candle, null or a scalar, which finish() parses whole.
+      mode_ = Mode::kBuffering;
+      stage = -1;
+    }
+  } else {
+    stage = -1;
+  }
+
+  if (c == '{' || c == '[') {
+    stack_.push_back(Frame{c == '{', true, stage});
+    expect_value_ = c == '[';
+  }
+}
+
+void CandleStreamParser::closeContainer(char c) {
+  if (stack_.empty() || stack_.back().object != (c == '}')) {
+    throw JsonParseError(std::string("Unexpected '") + c + "' in candle response");
+  }
+  const Frame frame = stack_.back();
+  stack_.pop_back();
+  expect_value_ = false;
+
+  if (mode_ == Mode::kSearching && frame.next_wrapper >= 0) {
+    // An object on the way to the candle array ended without leading to one.
+    mode_ = Mode::kBuffering;
+  } else if (mode_ == Mode::kStreaming && stack_.size() < array_depth_) {
+    mode_ = Mode::kDone;
+    buffer_.clear();
+  }
+  if (stack_.empty()) {
+    root_closed_ = true;
+  }
+}
+
+void CandleStreamParser::emitElement() {
+  capturing_ = false;
+  HistoricalCandle candle;
+  candle.mint = mint_;
+  candle.timeframe = timeframe_;
+  JsonCursor cursor(buffer_);
+  if (cursor.peek() == JsonCursor::Kind::Object) {
+    readRecord(cursor, kCandleFields, layout_, candle);
+  } else {
+    cursor.skipValue();
+  }
+  cursor.expectEnd();
+  buffer_.clear();
+  deliver(std::move(candle));
+}
+
+void CandleStreamParser::deliver(HistoricalCandle&& candle) {
+  ++delivered_;
+  on_candle_(std::move(candle));
+}
+
+}  // namespace market_data
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "market_data/field_layout_cache.h"
+#include "market_data/pumpfun_client.h"
+
+namespace market_data {
+
+// On-demand parsers for the REST response shapes PumpFunClient understands.
+// They read fields straight from the payload into the result structs without
+// building a DOM, accepting the same wrappers, field aliases and defaults as
+// the nlohmann-based parseTokenQuote path. Malformed JSON raises
+// JsonParseError.
+
+// A quote object, optionally wrapped in "result" and/or an object "data"; an
+// array yields its first element.
+TokenQuote parseQuoteResponse(std::string_view payload, FieldLayoutCache* layout = nullptr);
+
+// A multi-mint quote response, keyed by mint: an array of quotes (entries
+// without a mint are dropped) or an object keyed by mint, of which only
+// token_mints are read and whose quotes default to their key's mint. Either
+// may be wrapped in "result", "data" and/or "quotes".
+std::unordered_map<std::string, TokenQuote> parseBatchQuoteResponse(
+    std::string_view payload,
+    const std::vector<std::string>& token_mints,
+    FieldLayoutCache* layout = nullptr);
+
+// An array of candles (or a single candle), optionally wrapped in "result",
+// "data" and/or "candles".
+std::vector<HistoricalCandle> parseCandlesResponse(std::string_view payload,
+                                                   const std::string& token_mint,
+                                                   const std::string& timeframe,
+                                                   FieldLayoutCache* layout = nullptr);
+
+// Incremental parseCandlesResponse for a body that arrives in chunks, e.g.
+// from a cURL write callback. Once the candle array is reached, each candle is
+// handed to the callback as soon as its last byte arrives, so only one candle
+// is held at a time however long the history is. The array is found through
+// the same result/data/candles wrappers, taking the first of them that
+// appears. Bodies without a candle array (a single candle, null, an empty
+// body) are kept whole and parsed by finish(). Malformed JSON raises
+// JsonParseError from feed() or finish(); candles delivered before the error
+// stay delivered.
+class CandleStreamParser {
+ public:
+  using CandleCallback = std::function<void(HistoricalCandle&&)>;
+
+  CandleStreamParser(std::string token_mint,
+                     std::string timeframe,
+                     CandleCallback on_candle,
+                     FieldLayoutCache* layout = nullptr);
+
+  void feed(std::string_view chunk);
+  // Call once the body is complete; throws if it ended early.
+  void finish();
+  // Forgets a partially fed body, to start over with a new one.
+  void reset();
+
+  std::size_t candlesDelivered() const { return delivered_; }
+  // Bytes held back: the current candle, or the body so far while no candle
+  // array has been found.
+  std::size_t bufferedBytes() const { return buffer_.size(); }
+
+ private:
+  enum class Mode {
+    // No candle array yet; the body is kept in case it has none.
+    kSearching,
+    // Inside the candle array; buffer_ holds the current element.
+    kStreaming,
+    // Past the candle array; the rest is only checked for balance.
+    kDone,
+    // The body has no candle array; finish() parses it whole.
+    kBuffering,
+  };
+
+  struct Frame {
+    bool object = false;
+    // Objects: the next string is a key.
+    bool expect_key = true;
+    // Index of the first wrapper key still looked for in this object, or -1
+    // when the object is not on the path to the candle array.
+    int next_wrapper = -1;
+  };
+
+  void step(char c);
+  void beginValue(char c);
+  void closeContainer(char c);
+  void emitElement();
+  void deliver(HistoricalCandle&& candle);
+
+  std::string mint_;
+  std::string timeframe_;
+  CandleCallback on_candle_;
+  FieldLayoutCache* layout_;
+
+  Mode mode_ = Mode::kSearching;
+  std::vector<Frame> stack_;
+  std::string buffer_;
+  bool in_string_ = false;
+  bool escaped_ = false;
+  bool reading_key_ = false;
+  std::string key_;
+  // Wrapper stage the next value takes, after a matched wrapper key; -1 if none.
+  int pending_wrapper_ = -1;
+  bool expect_value_ = true;
+  bool root_closed_ = false;
+  // stack_ depth directly inside the candle array.
+  std::size_t array_depth_ = 0;
+  bool capturing_ = false;
+  std::size_t delivered_ = 0;
+};
+
+}  // namespace market_data
@@ -0,0 +1,282 @@
+#include "market_data/timestamp.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace market_data {
+namespace {
+
+constexpr std::int64_t kNanosPerSecond = 1'000'000'000;
+constexpr std::int64_t kMaxTimestampNs = std::numeric_limits<TimestampNs>::max();
+constexpr std::int64_t kMinTimestampNs = std::numeric_limits<TimestampNs>::min();
+
+// Epoch values below these magnitudes are seconds, milliseconds and
+// microseconds respectively; anything larger is nanoseconds. The ranges do
+// not overlap in practice, but int64 nanoseconds end at 2262-04-11, so the
+// top of each range is rejected rather than converted.
+constexpr double kMaxEpochSeconds = 1e11;
+constexpr double kMaxEpochMillis = 1e14;
+constexpr double kMaxEpochMicros = 1e17;
+
+bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Reads exactly count digits at pos.
+bool readDigits(std::string_view text, std::size_t& pos, std::size_t count, int& value) {
+  if (pos + count > text.size()) {
+    return false;
+  }
+  value = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    const char c = text[pos + i];
+    if (!isDigit(c)) {
+      return false;
+    }
+    value = value * 10 + (c - '0');
+  }
+  pos += count;
+  return true;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm).
+std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+  year -= month <= 2 ? 1 : 0;
+  const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const auto year_of_era = static_cast<unsigned>(year - era * 400);
+  const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+}
+
+void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day) {
+  days += 719468;
+  const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const auto day_of_era = static_cast<unsigned>(days - era * 146097);
+  const unsigned year_of_era =
+      (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  const unsigned day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const unsigned mp = (5 * day_of_year + 2) / 153;
+  day = day_of_year - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year = static_cast<std::int64_t>(year_of_era) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+unsigned daysInMonth(int year, int month) {
+  static constexpr unsigned kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  return month == 2 && leap ? 29 : kDays[month - 1];
+}
+
+bool parseIso8601(std::string_view text, TimestampNs& out) {
+  std::size_t pos = 0;
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  if (!readDigits(text, pos, 4, year) || pos >= text.size() || text[pos++] != '-' ||
+      !readDigits(text, pos, 2, month) || pos >= text.size() || text[pos++] != '-' ||
+      !readDigits(text, pos, 2, day)) {
+    return false;
+  }
+  if (month < 1 || month > 12 || day < 1 || static_cast<unsigned>(day) > daysInMonth(year, month)) {
+    return false;
+  }
+
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  std::int64_t fraction_ns = 0;
+  std::int64_t offset_seconds = 0;
+  if (pos < text.size()) {
+    if (text[pos] != 'T' && text[pos] != 't' && text[pos] != ' ') {
+      return false;
+    }
+    ++pos;
+    if (!readDigits(text, pos, 2, hour) || pos >= text.size() || text[pos++] != ':' ||
+        !readDigits(text, pos, 2, minute)) {
+      return false;
+    }
+    if (pos < text.size() && text[pos] == ':') {
+      ++pos;
+      if (!readDigits(text, pos, 2, second)) {
+        return false;
+      }
+    }
+    // Leap seconds (":60") fold into the next second.
+    if (hour > 23 || minute > 59 || second > 60) {
+      return false;
+    }
+
+    if (pos < text.size() && (text[pos] == '.' || text[pos] == ',')) {
+      ++pos;
+      std::int64_t scale = kNanosPerSecond;
+      const std::size_t digits_begin = pos;
+      while (pos < text.size() && isDigit(text[pos])) {
+        if (scale > 1) {
+          scale /= 10;
+          fraction_ns += (text[pos] - '0') * scale;
+        }
+        ++pos;
+      }
+      if (pos == digits_begin) {
+        return false;
+      }
+    }
+
+    if (pos < text.size()) {
+      const char zone = text[pos++];
+      if (zone == 'Z' || zone == 'z') {
+        // UTC.
+      } else if (zone == '+' || zone == '-') {
+        int offset_hours = 0;
+        int offset_minutes = 0;
+        if (!readDigits(text, pos, 2, offset_hours)) {
+          return false;
+        }
+        if (pos < text.size() && text[pos] == ':') {
+          ++pos;
+        }
+        if (pos < text.size() && !readDigits(text, pos, 2, offset_minutes)) {
+          return false;
+        }
+        if (offset_hours > 23 || offset_minutes > 59) {
+          return false;
+        }
+        offset_seconds = (offset_hours * 3600 + offset_minutes * 60) * (zone == '-' ? -1 : 1);
+      } else {
+        return false;
+      }
+    }
+    if (pos != text.size()) {
+      return false;
+    }
+  }
+
+  const std::int64_t seconds = daysFromCivil(year, static_cast<unsigned>(month),
+                                             static_cast<unsigned>(day)) *
+                                   86400 +
+                               hour * 3600 + minute * 60 + second - offset_seconds;
+  // int64 nanoseconds span 1677-09-21 to 2262-04-11.
+  if (seconds > (kMaxTimestampNs - fraction_ns) / kNanosPerSecond ||
+      seconds < kMinTimestampNs / kNanosPerSecond) {
+    return false;
+  }
+  out = seconds * kNanosPerSecond + fraction_ns;
+  return true;
+}
+
+bool parseEpochText(std::string_view text, TimestampNs& out) {
+  // Integer and fraction are converted exactly; a double would round
+  // nanosecond epochs.
+  std::size_t pos = 0;
+  std::int64_t whole = 0;
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), whole);
+  if (error != std::errc() || whole < 0) {
+    return false;
+  }
+  pos = static_cast<std::size_t>(end - text.data());
+
+  const auto magnitude = static_cast<double>(whole);
+  std::int64_t unit_ns = 1;
+  if (magnitude < kMaxEpochSeconds) {
+    unit_ns = kNanosPerSecond;
+  } else if (magnitude < kMaxEpochMillis) {
+    unit_ns = 1'000'000;
+  } else if (magnitude < kMaxEpochMicros) {
+    unit_ns = 1'000;
+  }
+
+  std::int64_t fraction_ns = 0;
+  if (pos < text.size() && text[pos] == '.') {
+    ++pos;
+    const std::size_t digits_begin = pos;
+    std::int64_t scale = unit_ns;
+    while (pos < text.size() && isDigit(text[pos])) {
+      if (scale > 1) {
+        scale /= 10;
+        fraction_ns += (text[pos] - '0') * scale;
+      }
+      ++pos;
+    }
+    if (pos == digits_begin) {
+      return false;
+    }
+  }
+  if (pos != text.size()) {
+    return false;
+  }
+  if (whole > (kMaxTimestampNs - fraction_ns) / unit_ns) {
+    return false;
+  }
+  out = whole * unit_ns + fraction_ns;
+  return true;
+}
+
+}  // namespace
+
+bool parseTimestamp(std::string_view text, TimestampNs& out) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+    text.remove_suffix(1);
+  }
+  // ISO dates start with a four digit year followed by '-'.
+  if (text.size() >= 10 && text[4] == '-') {
+    return parseIso8601(text, out);
+  }
+  return parseEpochText(text, out);
+}
+
+TimestampNs timestampFromEpoch(double value) {
+  if (!std::isfinite(value) || value <= 0.0) {
+    return 0;
+  }
+  double nanos = value;
+  if (value < kMaxEpochSeconds) {
+    nanos = value * 1e9;
+  } else if (value < kMaxEpochMillis) {
+    nanos = value * 1e6;
+  } else if (value < kMaxEpochMicros) {
+    nanos = value * 1e3;
+  }
+  // Beyond int64 nanoseconds; llround would be undefined.
+  if (nanos >= 9.2e18) {
+    return 0;
+  }
+  return static_cast<TimestampNs>(std::llround(nanos));
+}
+
+std::string formatTimestamp(TimestampNs timestamp) {
+  if (timestamp == 0) {
+    return {};
+  }
+  std::int64_t seconds = timestamp / kNanosPerSecond;
+  std::int64_t nanos = timestamp % kNanosPerSecond;
+  if (nanos < 0) {
+    nanos += kNanosPerSecond;
+    --seconds;
+  }
+  std::int64_t days = seconds / 86400;
+  std::int64_t second_of_day = seconds % 86400;
+  if (second_of_day < 0) {
+    second_of_day += 86400;
+    --days;
+  }
+  std::int64_t year = 0;
+  unsigned month = 0;
+  unsigned day = 0;
+  civilFromDays(days, year, month, day);
+
+  char buffer[40];
+  std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02uT%02lld:%02lld:%02lld.%03lldZ",
+                static_cast<long long>(year), month, day,
+                static_cast<long long>(second_of_day / 3600),
+                static_cast<long long>(second_of_day / 60 % 60),
+                static_cast<long long>(second_of_day % 60), static_cast<long long>(nanos / 1'000'000));
+  return buffer;
+}
+
+}  // namespace market_data
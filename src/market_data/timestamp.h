@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace market_data {
+
+// Nanoseconds since the Unix epoch (UTC). 0 means unknown.
+using TimestampNs = std::int64_t;
+
+// Parses the timestamp formats providers send, once at ingest:
+//  * ISO-8601 / RFC 3339: "2026-10-18T12:00:00Z", "2026-10-18 12:00:00.123456+02:00",
+//    "2026-10-18T12:00:00" (UTC assumed) or a bare date "2026-10-18";
+//  * epoch numbers as text, in seconds, milliseconds, microseconds or
+//    nanoseconds (picked by magnitude), optionally with a fraction.
+// Returns false, leaving out untouched, when text is neither.
+bool parseTimestamp(std::string_view text, TimestampNs& out);
+
+// Converts an epoch number of unknown unit (seconds, ms, us or ns, picked by
+// magnitude) to nanoseconds.
+TimestampNs timestampFromEpoch(double value);
+
+// "2026-10-18T12:00:00.123Z" (millisecond precision); empty for 0.
+std::string formatTimestamp(TimestampNs timestamp);
+
+}  // namespace market_data
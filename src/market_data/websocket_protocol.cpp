@@ -0,0 +1,191 @@
+#include "market_data/websocket_protocol.h"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+
+#include <array>
+#include <stdexcept>
+
+namespace market_data {
+namespace websocket {
+namespace {
+constexpr char kHandshakeGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+// Compact the receive buffer once this much of it has been consumed.
+constexpr std::size_t kCompactThreshold = 64 * 1024;
+
+std::string base64(const unsigned char* data, std::size_t size) {
+  std::string encoded(4 * ((size + 2) / 3), '\0');
+  const int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(&encoded[0]), data,
+                                      static_cast<int>(size));
+  encoded.resize(static_cast<std::size_t>(written));
+  return encoded;
+}
+
+void randomBytes(unsigned char* out, std::size_t size) {
+  if (RAND_bytes(out, static_cast<int>(size)) != 1) {
+    throw std::runtime_error("Failed to generate random bytes for WebSocket");
+  }
+}
+
+bool isControl(Opcode opcode) {
+  return (static_cast<std::uint8_t>(opcode) & 0x8) != 0;
+}
+
+bool isKnown(std::uint8_t opcode) {
+  switch (opcode) {
+    case 0x0:
+    case 0x1:
+    case 0x2:
+    case 0x8:
+    case 0x9:
+    case 0xA:
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
+std::string encodeFrame(Opcode opcode, const std::string& payload, bool mask, bool fin) {
+  std::string frame;
+  frame.reserve(payload.size() + 14);
+  frame.push_back(static_cast<char>((fin ? 0x80 : 0x00) | static_cast<std::uint8_t>(opcode)));
+
+  const std::uint8_t mask_bit = mask ? 0x80 : 0x00;
+  const std::size_t size = payload.size();
+  if (size < 126) {
+    frame.push_back(static_cast<char>(mask_bit | size));
+  } else if (size <= 0xFFFF) {
+    frame.push_back(static_cast<char>(mask_bit | 126));
+    frame.push_back(static_cast<char>((size >> 8) & 0xFF));
+    frame.push_back(static_cast<char>(size & 0xFF));
+  } else {
+    frame.push_back(static_cast<char>(mask_bit | 127));
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      frame.push_back(static_cast<char>((static_cast<std::uint64_t>(size) >> shift) & 0xFF));
+    }
+  }
+
+  if (!mask) {
+    frame += payload;
+    return frame;
+  }
+
+  std::array<unsigned char, 4> key{};
+  randomBytes(key.data(), key.size());
+  frame.append(reinterpret_cast<const char*>(key.data()), key.size());
+  const std::size_t start = frame.size();
+  frame += payload;
+  for (std::size_t i = 0; i < size; ++i) {
+    frame[start + i] = static_cast<char>(frame[start + i] ^ key[i & 3]);
+  }
+  return frame;
+}
+
+std::string generateHandshakeKey() {
+  std::array<unsigned char, 16> nonce{};
+  randomBytes(nonce.data(), nonce.size());
+  return base64(nonce.data(), nonce.size());
+}
+
+std::string acceptKeyFor(const std::string& key) {
+  const std::string input = key + kHandshakeGuid;
+  std::array<unsigned char, SHA_DIGEST_LENGTH> digest{};
+  SHA1(reinterpret_cast<const unsigned char*>(input.data()), input.size(), digest.data());
+  return base64(digest.data(), digest.size());
+}
+
+FrameParser::FrameParser(std::size_t max_payload_bytes) : max_payload_bytes_(max_payload_bytes) {}
+
+void FrameParser::append(const char* data, std::size_t size) {
+  if (offset_ >= kCompactThreshold && offset_ * 2 >= buffer_.size()) {
+    buffer_.erase(0, offset_);
+    offset_ = 0;
+  }
+  buffer_.append(data, size);
+}
+
+std::optional<Frame> FrameParser::next() {
+  const std::size_t available = buffer_.size() - offset_;
+  if (available < 2) {
+    return std::nullopt;
+  }
+
+  const auto* bytes = reinterpret_cast<const unsigned char*>(buffer_.data() + offset_);
+  const bool fin = (bytes[0] & 0x80) != 0;
+  if ((bytes[0] & 0x70) != 0) {
+    throw std::runtime_error("WebSocket frame uses reserved bits");
+  }
+  const std::uint8_t raw_opcode = bytes[0] & 0x0F;
+  if (!isKnown(raw_opcode)) {
+    throw std::runtime_error("WebSocket frame has unknown opcode " + std::to_string(raw_opcode));
+  }
+  const auto opcode = static_cast<Opcode>(raw_opcode);
+  const bool masked = (bytes[1] & 0x80) != 0;
+
+  std::size_t header = 2;
+  std::uint64_t length = bytes[1] & 0x7F;
+  if (length == 126) {
+    header += 2;
+    if (available < header) {
+      return std::nullopt;
+    }
+    length = (static_cast<std::uint64_t>(bytes[2]) << 8) | bytes[3];
+  } else if (length == 127) {
+    header += 8;
+    if (available < header) {
+      return std::nullopt;
+    }
+    length = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+      length = (length << 8) | bytes[2 + i];
+    }
+  }
+
+  if (isControl(opcode) && (!fin || length > 125)) {
+    throw std::runtime_error("WebSocket control frame is fragmented or oversized");
+  }
+  if (length > max_payload_bytes_) {
+    throw std::runtime_error("WebSocket frame of " + std::to_string(length) +
+                             " bytes exceeds the limit");
+  }
+
+  const std::size_t mask_offset = header;
+  if (masked) {
+    header += 4;
+  }
+  if (available < header + length) {
+    return std::nullopt;
+  }
+
+  Frame frame;
+  frame.opcode = opcode;
+  frame.fin = fin;
+  frame.payload.assign(buffer_, offset_ + header, static_cast<std::size_t>(length));
+  if (masked) {
+    const unsigned char* key = bytes + mask_offset;
+    for (std::size_t i = 0; i < frame.payload.size(); ++i) {
+      frame.payload[i] = static_cast<char>(frame.payload[i] ^ key[i & 3]);
+    }
+  }
+
+  offset_ += header + static_cast<std::size_t>(length);
+  if (offset_ == buffer_.size()) {
+    buffer_.clear();
+    offset_ = 0;
+  }
+  return frame;
+}
+
+std::size_t FrameParser::buffered() const {
+  return buffer_.size() - offset_;
+}
+
+void FrameParser::reset() {
+  buffer_.clear();
+  offset_ = 0;
+}
+
+}  // namespace websocket
+}  // namespace market_data
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace market_data {
+namespace websocket {
+
+// RFC 6455 framing shared by PumpFunStreamClient and the WebSocket test server.
+
+enum class Opcode : std::uint8_t {
+  Continuation = 0x0,
+  Text = 0x1,
+  Binary = 0x2,
+  Close = 0x8,
+  Ping = 0x9,
+  Pong = 0xA,
+};
+
+struct Frame {
+  Opcode opcode = Opcode::Text;
+  bool fin = true;
+  std::string payload;
+};
+
+// Serialises a single frame. Clients must mask every frame they send; servers
+// must not.
+std::string encodeFrame(Opcode opcode, const std::string& payload, bool mask, bool fin = true);
+
+// Random base64 nonce for the Sec-WebSocket-Key handshake header.
+std::string generateHandshakeKey();
+
+// Expected Sec-WebSocket-Accept value for a handshake key.
+std::string acceptKeyFor(const std::string& key);
+
+// FrameParser incrementally decodes frames from a byte stream. Payloads are
+// unmasked in place. Throws std::runtime_error on protocol violations or when a
+// frame exceeds max_payload_bytes.
+class FrameParser {
+ public:
+  explicit FrameParser(std::size_t max_payload_bytes = std::size_t{1} << 20);
+
+  void append(const char* data, std::size_t size);
+
+  // Returns the next complete frame, or nullopt when more bytes are needed.
+  std::optional<Frame> next();
+
+  std::size_t buffered() const;
+  void reset();
+
+ private:
+  std::size_t max_payload_bytes_;
+  std::string buffer_;
+  std::size_t offset_ = 0;
+};
+
+}  // namespace websocket
+}  // namespace market_data
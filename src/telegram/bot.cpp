@@ -42,6 +42,9 @@ TelegramBot::TelegramBot(const std::string& token,
         request.symbol = trade.symbol;
         request.quantity = trade.amount;
         request.limitPrice = trade.limit_price;
+        if (!trade.client_order_id.empty()) {
+            request.clientOrderId = trade.client_order_id;
+        }
 
         trading::OrderReceipt receipt;
         if (trade.side == "sell") {
@@ -216,6 +219,7 @@ void TelegramBot::handleBuy(const TgBot::Message::Ptr& message) {
         trade.limit_price = parsed.order.limitPrice;
         trade.side = "buy";
         trade.otp_code = parsed.otp;
+        trade.client_order_id = clientOrderIdFor(message);
 
         client_.handle_trade_request(trade);
     } catch (const std::exception& ex) {
@@ -241,6 +245,7 @@ void TelegramBot::handleSell(const TgBot::Message::Ptr& message) {
         trade.limit_price = parsed.order.limitPrice;
         trade.side = "sell";
         trade.otp_code = parsed.otp;
+        trade.client_order_id = clientOrderIdFor(message);
 
         client_.handle_trade_request(trade);
     } catch (const std::exception& ex) {
@@ -290,6 +295,12 @@ void TelegramBot::handlePlainText(const TgBot::Message::Ptr& message) {
                    "Hi there! Use /help to discover supported commands.");
 }
 
+std::string TelegramBot::clientOrderIdFor(const TgBot::Message::Ptr& message) {
+    // Message ids are unique per chat, so a redelivered or retried update maps
+    // to the same client order id.
+    return "tg-" + std::to_string(message->chat->id) + "-" + std::to_string(message->messageId);
+}
+
 std::vector<std::string> TelegramBot::tokenize(const std::string& text) {
     std::istringstream stream(text);
     std::vector<std::string> tokens;
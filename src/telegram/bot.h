@@ -51,6 +51,7 @@ private:
     void handleUnknown(const TgBot::Message::Ptr& message);
     void handlePlainText(const TgBot::Message::Ptr& message);
 
+    static std::string clientOrderIdFor(const TgBot::Message::Ptr& message);
     static std::vector<std::string> tokenize(const std::string& text);
     static std::optional<double> parseDouble(const std::string& token);
 
@@ -17,6 +17,9 @@ struct TradeRequest {
     std::string side;
     std::string otp_code;
     std::optional<double> limit_price;
+    // Derived from the originating update so redelivered commands are deduped
+    // by the engine.
+    std::string client_order_id;
 };
 
 // TelegramClient receives updates from the Telegram gateway and performs
@@ -0,0 +1,290 @@
+#include "testing/mock_http_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace testing {
+namespace {
+constexpr int kAcceptPollMillis = 50;
+constexpr std::size_t kMaxHeaderBytes = 64 * 1024;
+
+std::string lowerCase(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+std::string trim(const std::string& value) {
+    const auto begin = value.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return {};
+    }
+    const auto end = value.find_last_not_of(" \t\r");
+    return value.substr(begin, end - begin + 1);
+}
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200:
+            return "OK";
+        case 304:
+            return "Not Modified";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 429:
+            return "Too Many Requests";
+        case 500:
+            return "Internal Server Error";
+        case 502:
+            return "Bad Gateway";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return "Status";
+    }
+}
+
+bool writeAll(int fd, const std::string& data) {
+    std::size_t written = 0;
+    while (written < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+}  // namespace
+
+MockHttpServer::MockHttpServer(Handler handler) : handler_(std::move(handler)) {
+    if (!handler_) {
+        throw std::invalid_argument("MockHttpServer handler must be valid");
+    }
+}
+
+MockHttpServer::~MockHttpServer() {
+    stop();
+}
+
+void MockHttpServer::start(std::uint16_t port) {
+    if (running_.load()) {
+        return;
+    }
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        throw std::runtime_error(std::string("MockHttpServer socket failed: ") + std::strerror(errno));
+    }
+    const int reuse = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd_, 64) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        throw std::runtime_error("MockHttpServer bind failed: " + error);
+    }
+
+    socklen_t length = sizeof(address);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    running_.store(true);
+    acceptor_ = std::thread(&MockHttpServer::acceptLoop, this);
+}
+
+void MockHttpServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (acceptor_.joinable()) {
+        acceptor_.join();
+    }
+    ::close(listenFd_);
+    listenFd_ = -1;
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        for (auto& connection : connections_) {
+            // Unblocks the reader; the serving thread owns and closes the fd.
+            if (connection->fd >= 0) {
+                ::shutdown(connection->fd, SHUT_RDWR);
+            }
+        }
+        connections.swap(connections_);
+    }
+    for (auto& connection : connections) {
+        if (connection->thread.joinable()) {
+            connection->thread.join();
+        }
+    }
+}
+
+std::uint16_t MockHttpServer::port() const {
+    return port_;
+}
+
+std::string MockHttpServer::baseUrl() const {
+    return "http://127.0.0.1:" + std::to_string(port_);
+}
+
+std::size_t MockHttpServer::acceptedConnections() const {
+    return acceptedConnections_.load();
+}
+
+std::size_t MockHttpServer::requestsServed() const {
+    return requestsServed_.load();
+}
+
+void MockHttpServer::acceptLoop() {
+    while (running_.load()) {
+        pollfd descriptor{listenFd_, POLLIN, 0};
+        const int ready = ::poll(&descriptor, 1, kAcceptPollMillis);
+        if (ready <= 0) {
+            continue;
+        }
+
+        const int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        const int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        ++acceptedConnections_;
+
+        // Registered before the thread starts so closeConnection() always finds it.
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        reapClosedConnectionsLocked();
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->thread = std::thread(&MockHttpServer::serveConnection, this, fd);
+        connections_.push_back(std::move(connection));
+    }
+}
+
+void MockHttpServer::serveConnection(int fd) {
+    std::string buffer;
+    char chunk[4096];
+
+    while (running_.load()) {
+        std::size_t headerEnd = buffer.find("\r\n\r\n");
+        while (headerEnd == std::string::npos) {
+            const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0 || buffer.size() > kMaxHeaderBytes) {
+                closeConnection(fd);
+                return;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(n));
+            headerEnd = buffer.find("\r\n\r\n");
+        }
+
+        Request request;
+        std::istringstream head(buffer.substr(0, headerEnd));
+        std::string line;
+        std::getline(head, line);
+        std::istringstream requestLine(line);
+        requestLine >> request.method >> request.target;
+        while (std::getline(head, line)) {
+            const auto colon = line.find(':');
+            if (colon != std::string::npos) {
+                request.headers[lowerCase(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+            }
+        }
+
+        std::size_t bodyLength = 0;
+        auto lengthIt = request.headers.find("content-length");
+        if (lengthIt != request.headers.end()) {
+            bodyLength = static_cast<std::size_t>(std::stoul(lengthIt->second));
+        }
+        while (buffer.size() < headerEnd + 4 + bodyLength) {
+            const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                closeConnection(fd);
+                return;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(n));
+        }
+        buffer.erase(0, headerEnd + 4 + bodyLength);
+
+        Response response = handler_(request);
+        if (response.delay.count() > 0) {
+            std::this_thread::sleep_for(response.delay);
+        }
+
+        auto connectionIt = request.headers.find("connection");
+        const bool closeAfter =
+            connectionIt != request.headers.end() && lowerCase(connectionIt->second) == "close";
+
+        std::ostringstream out;
+        out << "HTTP/1.1 " << response.status << " " << reasonPhrase(response.status) << "\r\n";
+        if (response.headers.find("Content-Type") == response.headers.end()) {
+            out << "Content-Type: application/json\r\n";
+        }
+        for (const auto& [name, value] : response.headers) {
+            out << name << ": " << value << "\r\n";
+        }
+        out << "Content-Length: " << response.body.size() << "\r\n";
+        out << "Connection: " << (closeAfter ? "close" : "keep-alive") << "\r\n\r\n";
+        out << response.body;
+
+        ++requestsServed_;
+        if (!writeAll(fd, out.str()) || closeAfter) {
+            break;
+        }
+    }
+
+    closeConnection(fd);
+}
+
+void MockHttpServer::reapClosedConnectionsLocked() {
+    // A closed connection's thread has nothing left to do but return, so a
+    // long-running server does not pile up finished threads.
+    auto closed = std::stable_partition(connections_.begin(), connections_.end(),
+                                        [](const std::unique_ptr<Connection>& connection) {
+                                            return connection->fd >= 0;
+                                        });
+    for (auto it = closed; it != connections_.end(); ++it) {
+        if ((*it)->thread.joinable()) {
+            (*it)->thread.join();
+        }
+    }
+    connections_.erase(closed, connections_.end());
+}
+
+void MockHttpServer::closeConnection(int fd) {
+    // Closing under the lock keeps stop() from shutting down a recycled fd.
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    for (auto& connection : connections_) {
+        if (connection->fd == fd) {
+            connection->fd = -1;
+        }
+    }
+    ::close(fd);
+}
+
+}  // namespace testing
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace testing {
+
+// MockHttpServer is a minimal HTTP/1.1 server bound to 127.0.0.1, on an
+// ephemeral port unless one is requested. It honours keep-alive so tests can observe connection reuse,
+// and answers every request through a caller-supplied handler.
+class MockHttpServer {
+public:
+    struct Request {
+        std::string method;
+        std::string target;
+        // Header names are lower-cased.
+        std::unordered_map<std::string, std::string> headers;
+    };
+
+    struct Response {
+        int status{200};
+        std::string body;
+        std::unordered_map<std::string, std::string> headers;
+        // Delay before the response is written, to simulate a slow upstream.
+        std::chrono::milliseconds delay{0};
+    };
+
+    using Handler = std::function<Response(const Request&)>;
+
+    explicit MockHttpServer(Handler handler);
+    ~MockHttpServer();
+
+    MockHttpServer(const MockHttpServer&) = delete;
+    MockHttpServer& operator=(const MockHttpServer&) = delete;
+
+    // Binds the given port (0 picks an ephemeral one) and starts accepting
+    // connections. Throws std::runtime_error if the socket cannot be bound.
+    void start(std::uint16_t port = 0);
+    void stop();
+
+    std::uint16_t port() const;
+    std::string baseUrl() const;
+
+    std::size_t acceptedConnections() const;
+    std::size_t requestsServed() const;
+
+private:
+    struct Connection {
+        int fd{-1};
+        std::thread thread;
+    };
+
+    void acceptLoop();
+    void serveConnection(int fd);
+    void closeConnection(int fd);
+    // Requires connectionsMutex_.
+    void reapClosedConnectionsLocked();
+
+    Handler handler_;
+    int listenFd_{-1};
+    std::uint16_t port_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread acceptor_;
+
+    mutable std::mutex connectionsMutex_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    std::atomic<std::size_t> acceptedConnections_{0};
+    std::atomic<std::size_t> requestsServed_{0};
+};
+
+}  // namespace testing
@@ -0,0 +1,539 @@
+#include "testing/mock_pumpfun_api.h"
+
+#include "market_data/json_cursor.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace testing {
+namespace {
+constexpr int kMaxCandles = 1000;
+
+std::string percentDecode(const std::string& value) {
+    std::string decoded;
+    decoded.reserve(value.size());
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '%' && i + 2 < value.size() &&
+            std::isxdigit(static_cast<unsigned char>(value[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+            decoded.push_back(static_cast<char>(std::stoi(value.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else if (value[i] == '+') {
+            decoded.push_back(' ');
+        } else {
+            decoded.push_back(value[i]);
+        }
+    }
+    return decoded;
+}
+
+std::string pathOf(const std::string& target) {
+    return target.substr(0, target.find('?'));
+}
+
+std::unordered_map<std::string, std::string> queryOf(const std::string& target) {
+    std::unordered_map<std::string, std::string> query;
+    const auto questionMark = target.find('?');
+    if (questionMark == std::string::npos) {
+        return query;
+    }
+    std::istringstream pairs(target.substr(questionMark + 1));
+    std::string pair;
+    while (std::getline(pairs, pair, '&')) {
+        const auto equals = pair.find('=');
+        if (equals == std::string::npos) {
+            query[percentDecode(pair)] = "";
+        } else {
+            query[percentDecode(pair.substr(0, equals))] = percentDecode(pair.substr(equals + 1));
+        }
+    }
+    return query;
+}
+
+// The mint when path is "<endpoint>/<mint>", empty otherwise.
+std::string mintUnder(const std::string& path, const std::string& endpoint) {
+    if (endpoint.empty() || path.size() <= endpoint.size() + 1 ||
+        path.compare(0, endpoint.size(), endpoint) != 0 || path[endpoint.size()] != '/') {
+        return {};
+    }
+    const std::string mint = path.substr(endpoint.size() + 1);
+    return mint.find('/') == std::string::npos ? percentDecode(mint) : std::string{};
+}
+
+// "30s", "5m", "1h", "1d"; one minute when unparseable.
+std::int64_t timeframeSeconds(const std::string& timeframe) {
+    std::size_t digits = 0;
+    while (digits < timeframe.size() && std::isdigit(static_cast<unsigned char>(timeframe[digits]))) {
+        ++digits;
+    }
+    if (digits == 0 || digits + 1 != timeframe.size()) {
+        return 60;
+    }
+    const std::int64_t count = std::stoll(timeframe.substr(0, digits));
+    switch (std::tolower(static_cast<unsigned char>(timeframe.back()))) {
+        case 's':
+            return count;
+        case 'm':
+            return count * 60;
+        case 'h':
+            return count * 3600;
+        case 'd':
+            return count * 86400;
+        default:
+            return 60;
+    }
+}
+
+std::int64_t nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+MockHttpServer::Response jsonResponse(int status, std::string body) {
+    MockHttpServer::Response response;
+    response.status = status;
+    response.body = std::move(body);
+    return response;
+}
+
+void appendJsonString(std::ostringstream& out, const std::string& value) {
+    out << '"';
+    for (const char c : value) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(c) << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+// Writes one flat JSON object, fields in call order.
+class JsonObjectWriter {
+public:
+    JsonObjectWriter() {
+        out_ << std::setprecision(12) << '{';
+    }
+
+    JsonObjectWriter& field(const char* name, const std::string& value) {
+        key(name);
+        appendJsonString(out_, value);
+        return *this;
+    }
+
+    JsonObjectWriter& field(const char* name, double value) {
+        key(name);
+        out_ << value;
+        return *this;
+    }
+
+    JsonObjectWriter& field(const char* name, std::int64_t value) {
+        key(name);
+        out_ << value;
+        return *this;
+    }
+
+    std::string str() const {
+        return out_.str() + '}';
+    }
+
+private:
+    void key(const char* name) {
+        if (!first_) {
+            out_ << ',';
+        }
+        first_ = false;
+        out_ << '"' << name << "\":";
+    }
+
+    std::ostringstream out_;
+    bool first_{true};
+};
+
+std::size_t appendBody(char* data, std::size_t size, std::size_t count, void* userdata) {
+    static_cast<std::string*>(userdata)->append(data, size * count);
+    return size * count;
+}
+}  // namespace
+
+MockPumpFunApi::MockPumpFunApi(Options options)
+    : options_(std::move(options)), random_(options_.seed) {
+    if (!(options_.errorRate >= 0.0 && options_.errorRate <= 1.0)) {
+        throw std::invalid_argument("MockPumpFunApi error rate must be between 0 and 1");
+    }
+    if (!options_.replayFile.empty()) {
+        loadReplay(options_.replayFile);
+    }
+    if (!options_.recordFile.empty()) {
+        recordStream_.open(options_.recordFile, std::ios::app);
+        if (!recordStream_) {
+            throw std::runtime_error("MockPumpFunApi cannot open record file " + options_.recordFile);
+        }
+    }
+    if (!options_.upstreamUrl.empty() && curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
+        throw std::runtime_error("MockPumpFunApi failed to initialize cURL");
+    }
+}
+
+MockPumpFunApi::~MockPumpFunApi() {
+    if (!options_.upstreamUrl.empty()) {
+        curl_global_cleanup();
+    }
+}
+
+MockHttpServer::Handler MockPumpFunApi::handler() {
+    return [this](const MockHttpServer::Request& request) { return handle(request); };
+}
+
+std::size_t MockPumpFunApi::replayEntries() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return replayEntries_;
+}
+
+MockPumpFunApi::Stats MockPumpFunApi::stats() const {
+    Stats stats;
+    stats.requests = requests_.load();
+    stats.injectedErrors = injectedErrors_.load();
+    stats.replayed = replayed_.load();
+    stats.recorded = recorded_.load();
+    stats.upstreamFailures = upstreamFailures_.load();
+    return stats;
+}
+
+MockHttpServer::Response MockPumpFunApi::handle(const MockHttpServer::Request& request) {
+    ++requests_;
+
+    std::chrono::milliseconds delay = options_.latency;
+    bool injectError = false;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (options_.latencyJitter.count() > 0) {
+            delay += std::chrono::milliseconds(static_cast<std::int64_t>(
+                std::llround(uniformLocked(0.0, static_cast<double>(options_.latencyJitter.count())))));
+        }
+        injectError = options_.errorRate > 0.0 && uniformLocked(0.0, 1.0) < options_.errorRate;
+    }
+
+    MockHttpServer::Response response;
+    if (injectError) {
+        ++injectedErrors_;
+        response = jsonResponse(options_.errorStatus, R"({"error":"injected failure"})");
+    } else if (request.method != "GET") {
+        response = jsonResponse(405, R"({"error":"only GET is supported"})");
+    } else if (!options_.upstreamUrl.empty()) {
+        response = forward(request);
+    } else if (!replay(request.target, response)) {
+        response = synthetic(request.target);
+    }
+    response.delay += delay;
+    return response;
+}
+
+void MockPumpFunApi::loadReplay(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("MockPumpFunApi cannot read replay file " + path);
+    }
+    std::string line;
+    std::size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::string target;
+        RecordedResponse response;
+        try {
+            market_data::JsonCursor cursor(line);
+            cursor.enterObject();
+            std::string_view key;
+            std::string keyScratch;
+            std::string scratch;
+            while (cursor.nextMember(key, keyScratch)) {
+                if (key == "target") {
+                    target = std::string(cursor.readString(scratch));
+                } else if (key == "status") {
+                    response.status = static_cast<int>(cursor.readNumber());
+                } else if (key == "body") {
+                    response.body = std::string(cursor.readString(scratch));
+                } else {
+                    cursor.skipValue();
+                }
+            }
+            cursor.expectEnd();
+        } catch (const market_data::JsonParseError& ex) {
+            throw std::runtime_error("MockPumpFunApi replay file " + path + " line " +
+                                     std::to_string(lineNumber) + ": " + ex.what());
+        }
+        if (target.empty()) {
+            throw std::runtime_error("MockPumpFunApi replay file " + path + " line " +
+                                     std::to_string(lineNumber) + " has no target");
+        }
+        replayByTarget_[target].responses.push_back(response);
+        replayByPath_[pathOf(target)].responses.push_back(std::move(response));
+        ++replayEntries_;
+    }
+}
+
+bool MockPumpFunApi::replay(const std::string& target, MockHttpServer::Response& response) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    auto entries = replayByTarget_.find(target);
+    if (entries == replayByTarget_.end()) {
+        entries = replayByPath_.find(pathOf(target));
+        if (entries == replayByPath_.end()) {
+            return false;
+        }
+    }
+    ReplayEntries& replay = entries->second;
+    const RecordedResponse& recorded = replay.responses[replay.next];
+    replay.next = (replay.next + 1) % replay.responses.size();
+    response = jsonResponse(recorded.status, recorded.body);
+    ++replayed_;
+    return true;
+}
+
+MockHttpServer::Response MockPumpFunApi::forward(const MockHttpServer::Request& request) {
+    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(), &curl_easy_cleanup);
+    if (!curl) {
+        ++upstreamFailures_;
+        return jsonResponse(502, R"({"error":"upstream unavailable"})");
+    }
+
+    std::unordered_map<std::string, std::string> headers;
+    const auto apiKey = request.headers.find("x-api-key");
+    if (apiKey != request.headers.end()) {
+        headers["X-API-Key"] = apiKey->second;
+    }
+    for (const auto& [name, value] : options_.upstreamHeaders) {
+        headers[name] = value;
+    }
+    std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> headerList(nullptr,
+                                                                           &curl_slist_free_all);
+    headerList.reset(curl_slist_append(nullptr, "Accept: application/json"));
+    for (const auto& [name, value] : headers) {
+        const std::string line = name + ": " + value;
+        headerList.reset(curl_slist_append(headerList.release(), line.c_str()));
+    }
+
+    std::string base = options_.upstreamUrl;
+    if (!base.empty() && base.back() == '/') {
+        base.pop_back();
+    }
+    const std::string url = base + request.target;
+    std::string body;
+    curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, headerList.get());
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, &appendBody);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl.get(), CURLOPT_TIMEOUT_MS,
+                     static_cast<long>(options_.upstreamTimeout.count()));
+    curl_easy_setopt(curl.get(), CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl.get(), CURLOPT_ACCEPT_ENCODING, "");
+
+    const CURLcode result = curl_easy_perform(curl.get());
+    if (result != CURLE_OK) {
+        ++upstreamFailures_;
+        return jsonResponse(
+            502, JsonObjectWriter()
+                     .field("error", std::string("upstream request failed: ") +
+                                         curl_easy_strerror(result))
+                     .str());
+    }
+    long status = 0;
+    curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &status);
+
+    MockHttpServer::Response response = jsonResponse(static_cast<int>(status), std::move(body));
+    record(request.target, response);
+    return response;
+}
+
+void MockPumpFunApi::record(const std::string& target, const MockHttpServer::Response& response) {
+    if (!recordStream_.is_open()) {
+        return;
+    }
+    const std::string line = JsonObjectWriter()
+                                 .field("target", target)
+                                 .field("status", static_cast<std::int64_t>(response.status))
+                                 .field("body", response.body)
+                                 .str();
+
+    std::lock_guard<std::mutex> lock(recordMutex_);
+    recordStream_ << line << '\n';
+    // Flushed per response so a recording survives the process being killed.
+    recordStream_.flush();
+    ++recorded_;
+}
+
+MockHttpServer::Response MockPumpFunApi::synthetic(const std::string& target) {
+    const std::string path = pathOf(target);
+
+    if (!options_.batchQuoteEndpoint.empty() && path == options_.batchQuoteEndpoint) {
+        const auto query = queryOf(target);
+        const auto mints = query.find(options_.batchQueryParam);
+        if (mints == query.end() || mints->second.empty()) {
+            return jsonResponse(400, R"({"error":"missing )" + options_.batchQueryParam + R"("})");
+        }
+        std::string body = "[";
+        std::istringstream list(mints->second);
+        std::string mint;
+        bool first = true;
+        while (std::getline(list, mint, ',')) {
+            if (mint.empty()) {
+                continue;
+            }
+            body += first ? "" : ",";
+            body += quoteJson(mint);
+            first = false;
+        }
+        body += "]";
+        return jsonResponse(200, std::move(body));
+    }
+    if (auto mint = mintUnder(path, options_.quoteEndpoint); !mint.empty()) {
+        return jsonResponse(200, quoteJson(mint));
+    }
+    if (auto mint = mintUnder(path, options_.metadataEndpoint); !mint.empty()) {
+        return jsonResponse(200, metadataJson(mint));
+    }
+    if (auto mint = mintUnder(path, options_.candlesEndpoint); !mint.empty()) {
+        const auto query = queryOf(target);
+        const auto timeframe = query.find("timeframe");
+        const auto limit = query.find("limit");
+        int count = 100;
+        if (limit != query.end()) {
+            try {
+                count = std::stoi(limit->second);
+            } catch (const std::exception&) {
+                count = 0;
+            }
+        }
+        if (count <= 0) {
+            return jsonResponse(400, R"({"error":"invalid limit"})");
+        }
+        return jsonResponse(200, candlesJson(mint,
+                                             timeframe == query.end() ? "1m" : timeframe->second,
+                                             std::min(count, kMaxCandles)));
+    }
+    return jsonResponse(404, R"({"error":"not found"})");
+}
+
+std::string MockPumpFunApi::quoteJson(const std::string& mint) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    Walk& walk = walkLocked(mint);
+    walk.price *= 1.0 + uniformLocked(-0.01, 0.01);
+    walk.volume += walk.price * uniformLocked(0.0, 500.0);
+    walk.liquidity *= 1.0 + uniformLocked(-0.002, 0.002);
+    return JsonObjectWriter()
+        .field("mint", mint)
+        .field("price", walk.price)
+        .field("priceChange24h", (walk.price - walk.openPrice) / walk.openPrice * 100.0)
+        .field("volume24h", walk.volume)
+        .field("liquidity", walk.liquidity)
+        .field("timestamp", nowMillis())
+        .str();
+}
+
+std::string MockPumpFunApi::metadataJson(const std::string& mint) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    const Walk& walk = walkLocked(mint);
+    const std::string symbol = mint.substr(0, std::min<std::size_t>(mint.size(), 4));
+    return JsonObjectWriter()
+        .field("mint", mint)
+        .field("name", "Mock " + symbol)
+        .field("symbol", symbol)
+        .field("description", std::string("Synthetic token served by the mock Pump.fun API"))
+        .field("image", "https://example.invalid/" + mint + ".png")
+        .field("marketCap", walk.price * 1e9)
+        .field("liquidity", walk.liquidity)
+        .field("holderCount", static_cast<std::int64_t>(std::hash<std::string>{}(mint) % 5000 + 10))
+        .field("updatedAt", nowMillis())
+        .str();
+}
+
+std::string MockPumpFunApi::candlesJson(const std::string& mint,
+                                        const std::string& timeframe,
+                                        int limit) {
+    const std::int64_t stepMillis = timeframeSeconds(timeframe) * 1000;
+    const std::int64_t lastOpen = nowMillis() / stepMillis * stepMillis;
+
+    std::vector<std::string> candles;
+    candles.reserve(static_cast<std::size_t>(limit));
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    // Walks backwards from the current price so the newest candle closes at it.
+    double close = walkLocked(mint).price;
+    for (int i = 0; i < limit; ++i) {
+        const double open = close / (1.0 + uniformLocked(-0.02, 0.02));
+        const double high = std::max(open, close) * (1.0 + uniformLocked(0.0, 0.01));
+        const double low = std::min(open, close) * (1.0 - uniformLocked(0.0, 0.01));
+        const double volume = uniformLocked(100.0, 10000.0);
+        const std::int64_t openTime = lastOpen - i * stepMillis;
+        candles.push_back(JsonObjectWriter()
+                              .field("open_time", openTime)
+                              .field("close_time", openTime + stepMillis - 1)
+                              .field("open", open)
+                              .field("high", high)
+                              .field("low", low)
+                              .field("close", close)
+                              .field("volume", volume)
+                              .field("quote_volume", volume * (open + close) / 2.0)
+                              .str());
+        close = open;
+    }
+    std::string body = "[";
+    for (auto it = candles.rbegin(); it != candles.rend(); ++it) {
+        body += it == candles.rbegin() ? "" : ",";
+        body += *it;
+    }
+    body += "]";
+    return body;
+}
+
+MockPumpFunApi::Walk& MockPumpFunApi::walkLocked(const std::string& mint) {
+    auto it = walks_.find(mint);
+    if (it == walks_.end()) {
+        // Seeded per mint so a mint starts at the same price in every run.
+        std::mt19937_64 mintRandom(options_.seed ^ std::hash<std::string>{}(mint));
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        Walk walk;
+        walk.price = 1e-5 * std::pow(10.0, 3.0 * unit(mintRandom));
+        walk.openPrice = walk.price;
+        walk.volume = 1e4 + 1e6 * unit(mintRandom);
+        walk.liquidity = 5e3 + 5e5 * unit(mintRandom);
+        it = walks_.emplace(mint, walk).first;
+    }
+    return it->second;
+}
+
+double MockPumpFunApi::uniformLocked(double low, double high) {
+    return std::uniform_real_distribution<double>(low, high)(random_);
+}
+
+}  // namespace testing
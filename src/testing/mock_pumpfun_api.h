@@ -0,0 +1,141 @@
+#pragma once
+
+#include "testing/mock_http_server.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace testing {
+
+// MockPumpFunApi answers Pump.fun market data requests for MockHttpServer so
+// PumpFunClient can be exercised end to end (real cURL transfers, threading,
+// timeouts) without network access. Each request is answered in one of three
+// ways:
+//   - synthetic: quotes, batch quotes, metadata and candles generated from a
+//     seeded random walk per mint;
+//   - replay: responses read from a recording, matched by request target;
+//   - record: forwarded to a real upstream, with every response appended to a
+//     recording that a later run can replay.
+// Latency, jitter and injected errors apply on top of all three.
+class MockPumpFunApi {
+public:
+    struct Options {
+        // Endpoint layout, matching PumpFunClient's defaults.
+        std::string quoteEndpoint = "/quotes";
+        std::string batchQuoteEndpoint = "/quotes/batch";
+        std::string batchQueryParam = "addresses";
+        std::string metadataEndpoint = "/metadata";
+        std::string candlesEndpoint = "/candles";
+
+        // Every response is delayed by latency plus a uniform draw from
+        // [0, latencyJitter].
+        std::chrono::milliseconds latency{0};
+        std::chrono::milliseconds latencyJitter{0};
+        // Fraction of requests, 0 to 1, answered with errorStatus instead.
+        double errorRate = 0.0;
+        int errorStatus = 503;
+        std::uint64_t seed = 1;
+
+        // Recording to answer from. Requests it does not cover get synthetic
+        // payloads.
+        std::string replayFile;
+        // When set, requests are forwarded to this base URL and every upstream
+        // response is appended to recordFile (if set).
+        std::string upstreamUrl;
+        std::string recordFile;
+        // Sent with every upstream request, e.g. {"X-API-Key", "..."}. The
+        // client's own X-API-Key header is forwarded unless overridden here.
+        std::unordered_map<std::string, std::string> upstreamHeaders;
+        std::chrono::milliseconds upstreamTimeout{std::chrono::seconds(10)};
+    };
+
+    struct Stats {
+        std::size_t requests{0};
+        std::size_t injectedErrors{0};
+        std::size_t replayed{0};
+        std::size_t recorded{0};
+        // Upstream requests that failed before a response arrived.
+        std::size_t upstreamFailures{0};
+    };
+
+    // Throws std::invalid_argument for an error rate outside [0, 1] and
+    // std::runtime_error if the replay file cannot be read or the record file
+    // cannot be opened.
+    explicit MockPumpFunApi(Options options);
+    ~MockPumpFunApi();
+
+    MockPumpFunApi(const MockPumpFunApi&) = delete;
+    MockPumpFunApi& operator=(const MockPumpFunApi&) = delete;
+
+    // Thread-safe; MockHttpServer calls it from every connection thread.
+    MockHttpServer::Response handle(const MockHttpServer::Request& request);
+    // Handler forwarding to handle(); the MockPumpFunApi must outlive it.
+    MockHttpServer::Handler handler();
+
+    // Number of responses loaded from the replay file.
+    std::size_t replayEntries() const;
+    Stats stats() const;
+
+private:
+    struct RecordedResponse {
+        int status{200};
+        std::string body;
+    };
+
+    struct ReplayEntries {
+        std::vector<RecordedResponse> responses;
+        // Repeated requests cycle through the recorded responses.
+        std::size_t next{0};
+    };
+
+    struct Walk {
+        double price{0.0};
+        // Price when the mint was first requested, for the 24h change.
+        double openPrice{0.0};
+        double volume{0.0};
+        double liquidity{0.0};
+    };
+
+    void loadReplay(const std::string& path);
+    bool replay(const std::string& target, MockHttpServer::Response& response);
+    MockHttpServer::Response forward(const MockHttpServer::Request& request);
+    void record(const std::string& target, const MockHttpServer::Response& response);
+
+    MockHttpServer::Response synthetic(const std::string& target);
+    std::string quoteJson(const std::string& mint);
+    std::string metadataJson(const std::string& mint);
+    std::string candlesJson(const std::string& mint, const std::string& timeframe, int limit);
+    // Both require stateMutex_.
+    Walk& walkLocked(const std::string& mint);
+    double uniformLocked(double low, double high);
+
+    const Options options_;
+
+    // Guards the random engine, the walks and the replay cursors.
+    mutable std::mutex stateMutex_;
+    std::mt19937_64 random_;
+    std::unordered_map<std::string, Walk> walks_;
+    // Keyed by full target, and by path alone for targets whose query changed.
+    std::unordered_map<std::string, ReplayEntries> replayByTarget_;
+    std::unordered_map<std::string, ReplayEntries> replayByPath_;
+    std::size_t replayEntries_{0};
+
+    std::mutex recordMutex_;
+    std::ofstream recordStream_;
+
+    std::atomic<std::size_t> requests_{0};
+    std::atomic<std::size_t> injectedErrors_{0};
+    std::atomic<std::size_t> replayed_{0};
+    std::atomic<std::size_t> recorded_{0};
+    std::atomic<std::size_t> upstreamFailures_{0};
+};
+
+}  // namespace testing
@@ -0,0 +1,127 @@
+// Serves the Pump.fun market data API from MockPumpFunApi for offline load
+// tests. See "Offline load testing" in docs/runbook.md.
+
+#include "testing/mock_http_server.h"
+#include "testing/mock_pumpfun_api.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+void printUsage(const char* program) {
+    std::cerr
+        << "Usage: " << program << " [options]\n"
+        << "  --port N             port on 127.0.0.1 (default 8080, 0 picks one)\n"
+        << "  --latency-ms N       delay every response by N ms\n"
+        << "  --jitter-ms N        add a uniform 0..N ms to the delay\n"
+        << "  --error-rate F       answer a fraction F (0 to 1) of requests with an error\n"
+        << "  --error-status N     status of injected errors (default 503)\n"
+        << "  --seed N             seed for synthetic prices, latency and errors\n"
+        << "  --replay FILE        answer from a recording, synthetic data otherwise\n"
+        << "  --upstream URL       forward every request to URL\n"
+        << "  --record FILE        append upstream responses to FILE (with --upstream)\n"
+        << "  --header 'Name: V'   add a header to upstream requests (repeatable)\n"
+        << "  --batch-endpoint P   batch quote endpoint (default /quotes/batch)\n";
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    testing::MockPumpFunApi::Options options;
+    long port = 8080;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string flag = argv[i];
+            if (flag == "--help" || flag == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + flag);
+            }
+            const std::string value = argv[++i];
+            if (flag == "--port") {
+                port = std::stol(value);
+                if (port < 0 || port > 65535) {
+                    throw std::invalid_argument("port out of range: " + value);
+                }
+            } else if (flag == "--latency-ms") {
+                options.latency = std::chrono::milliseconds(std::stol(value));
+            } else if (flag == "--jitter-ms") {
+                options.latencyJitter = std::chrono::milliseconds(std::stol(value));
+            } else if (flag == "--error-rate") {
+                options.errorRate = std::stod(value);
+            } else if (flag == "--error-status") {
+                options.errorStatus = std::stoi(value);
+            } else if (flag == "--seed") {
+                options.seed = std::stoull(value);
+            } else if (flag == "--replay") {
+                options.replayFile = value;
+            } else if (flag == "--upstream") {
+                options.upstreamUrl = value;
+            } else if (flag == "--record") {
+                options.recordFile = value;
+            } else if (flag == "--header") {
+                const auto colon = value.find(':');
+                if (colon == std::string::npos) {
+                    throw std::invalid_argument("header must look like 'Name: value': " + value);
+                }
+                const auto start = value.find_first_not_of(' ', colon + 1);
+                options.upstreamHeaders[value.substr(0, colon)] =
+                    start == std::string::npos ? std::string{} : value.substr(start);
+            } else if (flag == "--batch-endpoint") {
+                options.batchQuoteEndpoint = value;
+            } else {
+                throw std::invalid_argument("unknown option " + flag);
+            }
+        }
+        if (!options.recordFile.empty() && options.upstreamUrl.empty()) {
+            throw std::invalid_argument("--record needs --upstream");
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    try {
+        testing::MockPumpFunApi api(options);
+        testing::MockHttpServer server(api.handler());
+        server.start(static_cast<std::uint16_t>(port));
+
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+
+        std::cout << "Serving mock Pump.fun API on " << server.baseUrl();
+        if (!options.upstreamUrl.empty()) {
+            std::cout << " (forwarding to " << options.upstreamUrl << ")";
+        } else if (!options.replayFile.empty()) {
+            std::cout << " (replaying " << api.replayEntries() << " responses)";
+        }
+        std::cout << std::endl;
+
+        while (!stopRequested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        server.stop();
+
+        const auto stats = api.stats();
+        std::cout << "Served " << stats.requests << " requests: " << stats.injectedErrors
+                  << " injected errors, " << stats.replayed << " replayed, " << stats.recorded
+                  << " recorded, " << stats.upstreamFailures << " upstream failures" << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << "mock_pumpfun_server: " << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
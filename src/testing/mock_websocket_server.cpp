@@ -0,0 +1,303 @@
+#include "testing/mock_websocket_server.h"
+
+#include "market_data/websocket_protocol.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace testing {
+namespace {
+constexpr int kAcceptPollMillis = 50;
+constexpr std::size_t kMaxHeaderBytes = 64 * 1024;
+constexpr std::size_t kMaxMessageBytes = 16 * 1024 * 1024;
+
+using market_data::websocket::Opcode;
+
+std::string lowerCase(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+std::string trim(const std::string& value) {
+    const auto begin = value.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return {};
+    }
+    const auto end = value.find_last_not_of(" \t\r");
+    return value.substr(begin, end - begin + 1);
+}
+
+bool writeAll(int fd, const std::string& data) {
+    std::size_t written = 0;
+    while (written < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+}  // namespace
+
+MockWebSocketServer::MockWebSocketServer(MessageHandler handler) : handler_(std::move(handler)) {}
+
+MockWebSocketServer::~MockWebSocketServer() {
+    stop();
+}
+
+void MockWebSocketServer::start() {
+    if (running_.load()) {
+        return;
+    }
+
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        throw std::runtime_error(std::string("MockWebSocketServer socket failed: ") +
+                                 std::strerror(errno));
+    }
+    const int reuse = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd_, 64) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        throw std::runtime_error("MockWebSocketServer bind failed: " + error);
+    }
+
+    socklen_t length = sizeof(address);
+    ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    running_.store(true);
+    acceptor_ = std::thread(&MockWebSocketServer::acceptLoop, this);
+}
+
+void MockWebSocketServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (acceptor_.joinable()) {
+        acceptor_.join();
+    }
+    ::close(listenFd_);
+    listenFd_ = -1;
+
+    dropConnections();
+    std::vector<std::unique_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        connections.swap(connections_);
+    }
+    for (auto& connection : connections) {
+        if (connection->thread.joinable()) {
+            connection->thread.join();
+        }
+    }
+}
+
+std::uint16_t MockWebSocketServer::port() const {
+    return port_;
+}
+
+std::string MockWebSocketServer::url(const std::string& target) const {
+    return "ws://127.0.0.1:" + std::to_string(port_) + target;
+}
+
+std::size_t MockWebSocketServer::broadcast(const std::string& message) {
+    const std::string frame = market_data::websocket::encodeFrame(Opcode::Text, message, false);
+
+    // Held across the writes so a connection cannot be closed (and its fd
+    // recycled) underneath them.
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    std::size_t delivered = 0;
+    for (auto& connection : connections_) {
+        if (connection->open && sendFrame(*connection, frame)) {
+            ++delivered;
+        }
+    }
+    return delivered;
+}
+
+void MockWebSocketServer::dropConnections() {
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    for (auto& connection : connections_) {
+        // Unblocks the reader; the serving thread owns and closes the fd.
+        if (connection->open) {
+            ::shutdown(connection->fd, SHUT_RDWR);
+        }
+    }
+}
+
+std::size_t MockWebSocketServer::acceptedConnections() const {
+    return acceptedConnections_.load();
+}
+
+std::size_t MockWebSocketServer::openConnections() const {
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    return static_cast<std::size_t>(
+        std::count_if(connections_.begin(), connections_.end(),
+                      [](const std::unique_ptr<Connection>& connection) { return connection->open; }));
+}
+
+std::vector<std::string> MockWebSocketServer::receivedMessages() const {
+    std::lock_guard<std::mutex> lock(messagesMutex_);
+    return receivedMessages_;
+}
+
+void MockWebSocketServer::acceptLoop() {
+    while (running_.load()) {
+        pollfd descriptor{listenFd_, POLLIN, 0};
+        const int ready = ::poll(&descriptor, 1, kAcceptPollMillis);
+        if (ready <= 0) {
+            continue;
+        }
+
+        const int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        const int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        ++acceptedConnections_;
+
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        Connection* raw = connection.get();
+        connection->thread = std::thread(&MockWebSocketServer::serveConnection, this, raw);
+        connections_.push_back(std::move(connection));
+    }
+}
+
+void MockWebSocketServer::serveConnection(Connection* connection) {
+    const int fd = connection->fd;
+    std::string buffer;
+    char chunk[16 * 1024];
+
+    std::size_t headerEnd = std::string::npos;
+    while (headerEnd == std::string::npos) {
+        const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0 || buffer.size() > kMaxHeaderBytes) {
+            closeConnection(*connection);
+            return;
+        }
+        buffer.append(chunk, static_cast<std::size_t>(n));
+        headerEnd = buffer.find("\r\n\r\n");
+    }
+
+    std::string key;
+    std::istringstream head(buffer.substr(0, headerEnd));
+    std::string line;
+    while (std::getline(head, line)) {
+        const auto colon = line.find(':');
+        if (colon != std::string::npos &&
+            lowerCase(trim(line.substr(0, colon))) == "sec-websocket-key") {
+            key = trim(line.substr(colon + 1));
+        }
+    }
+    if (key.empty()) {
+        writeAll(fd, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        closeConnection(*connection);
+        return;
+    }
+
+    const std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+                                 "Upgrade: websocket\r\n"
+                                 "Connection: Upgrade\r\n"
+                                 "Sec-WebSocket-Accept: " +
+                                 market_data::websocket::acceptKeyFor(key) + "\r\n\r\n";
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        connection->open = writeAll(fd, response);
+    }
+
+    market_data::websocket::FrameParser parser(kMaxMessageBytes);
+    parser.append(buffer.data() + headerEnd + 4, buffer.size() - headerEnd - 4);
+    std::string message;
+
+    try {
+        while (running_.load()) {
+            while (auto frame = parser.next()) {
+                switch (frame->opcode) {
+                    case Opcode::Text:
+                    case Opcode::Binary:
+                    case Opcode::Continuation:
+                        message += frame->payload;
+                        if (frame->fin) {
+                            {
+                                std::lock_guard<std::mutex> lock(messagesMutex_);
+                                receivedMessages_.push_back(message);
+                            }
+                            if (handler_) {
+                                handler_(message);
+                            }
+                            message.clear();
+                        }
+                        break;
+                    case Opcode::Ping:
+                        sendFrame(*connection, market_data::websocket::encodeFrame(
+                                                   Opcode::Pong, frame->payload, false));
+                        break;
+                    case Opcode::Pong:
+                        break;
+                    case Opcode::Close:
+                        sendFrame(*connection,
+                                  market_data::websocket::encodeFrame(Opcode::Close, {}, false));
+                        closeConnection(*connection);
+                        return;
+                }
+            }
+
+            const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                break;
+            }
+            parser.append(chunk, static_cast<std::size_t>(n));
+        }
+    } catch (const std::exception&) {
+        // Protocol violation; drop the connection like a real server would.
+    }
+
+    closeConnection(*connection);
+}
+
+bool MockWebSocketServer::sendFrame(Connection& connection, const std::string& frame) {
+    std::lock_guard<std::mutex> lock(connection.writeMutex);
+    return writeAll(connection.fd, frame);
+}
+
+void MockWebSocketServer::closeConnection(Connection& connection) {
+    // Closing under the lock keeps broadcast() from writing to a recycled fd.
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    if (connection.fd >= 0) {
+        connection.open = false;
+        ::close(connection.fd);
+        connection.fd = -1;
+    }
+}
+
+}  // namespace testing
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace testing {
+
+// MockWebSocketServer is a minimal RFC 6455 server bound to 127.0.0.1 on an
+// ephemeral port. It records every text message clients send, answers pings,
+// and lets tests push text frames to all clients or drop every connection to
+// exercise reconnect logic.
+class MockWebSocketServer {
+public:
+    // Invoked on the connection's reader thread for each text message.
+    using MessageHandler = std::function<void(const std::string& message)>;
+
+    explicit MockWebSocketServer(MessageHandler handler = {});
+    ~MockWebSocketServer();
+
+    MockWebSocketServer(const MockWebSocketServer&) = delete;
+    MockWebSocketServer& operator=(const MockWebSocketServer&) = delete;
+
+    // Binds and starts accepting connections. Throws std::runtime_error if the
+    // socket cannot be bound.
+    void start();
+    void stop();
+
+    std::uint16_t port() const;
+    // ws:// URL for the given request target.
+    std::string url(const std::string& target = "/") const;
+
+    // Sends a text frame to every open connection. Returns the number of
+    // connections written to.
+    std::size_t broadcast(const std::string& message);
+
+    // Abruptly closes every open connection without a close handshake.
+    void dropConnections();
+
+    std::size_t acceptedConnections() const;
+    std::size_t openConnections() const;
+    std::vector<std::string> receivedMessages() const;
+
+private:
+    struct Connection {
+        int fd{-1};
+        bool open{false};
+        std::mutex writeMutex;
+        std::thread thread;
+    };
+
+    void acceptLoop();
+    void serveConnection(Connection* connection);
+    bool sendFrame(Connection& connection, const std::string& frame);
+    void closeConnection(Connection& connection);
+
+    MessageHandler handler_;
+    int listenFd_{-1};
+    std::uint16_t port_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread acceptor_;
+
+    mutable std::mutex connectionsMutex_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    mutable std::mutex messagesMutex_;
+    std::vector<std::string> receivedMessages_;
+
+    std::atomic<std::size_t> acceptedConnections_{0};
+};
+
+}  // namespace testing
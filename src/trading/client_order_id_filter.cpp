@@ -0,0 +1,45 @@
+#include "trading/client_order_id_filter.h"
+
+#include <algorithm>
+
+namespace trading {
+
+ClientOrderIdFilter::ClientOrderIdFilter(std::chrono::milliseconds window, std::size_t capacity)
+    : window_(window), capacity_(std::max<std::size_t>(capacity, 1)) {
+    seen_.reserve(capacity_);
+}
+
+bool ClientOrderIdFilter::insert(const std::string& id, Clock::time_point now) {
+    evict(now);
+
+    auto [it, inserted] = seen_.emplace(id, nextSequence_);
+    if (!inserted) {
+        return false;
+    }
+
+    arrival_.push_back(Entry{id, now, nextSequence_++});
+    evict(now);
+    return true;
+}
+
+void ClientOrderIdFilter::erase(const std::string& id) {
+    seen_.erase(id);
+}
+
+std::size_t ClientOrderIdFilter::size() const {
+    return seen_.size();
+}
+
+void ClientOrderIdFilter::evict(Clock::time_point now) {
+    while (!arrival_.empty() &&
+           (arrival_.size() > capacity_ || now - arrival_.front().seenAt >= window_)) {
+        const auto& oldest = arrival_.front();
+        auto it = seen_.find(oldest.id);
+        if (it != seen_.end() && it->second == oldest.sequence) {
+            seen_.erase(it);
+        }
+        arrival_.pop_front();
+    }
+}
+
+}  // namespace trading
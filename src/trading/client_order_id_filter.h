@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+namespace trading {
+
+// ClientOrderIdFilter remembers client order ids seen within a sliding time
+// window so resubmitted orders can be rejected in O(1). Memory is bounded by
+// capacity: under a flood the oldest ids are forgotten before the window ends.
+// The filter is not thread-safe; the owning engine serialises access.
+class ClientOrderIdFilter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ClientOrderIdFilter(std::chrono::milliseconds window, std::size_t capacity);
+
+    // Records id. Returns false if it was already seen within the window.
+    bool insert(const std::string& id, Clock::time_point now = Clock::now());
+
+    // Forgets id so a later submission with it is accepted again.
+    void erase(const std::string& id);
+
+    std::size_t size() const;
+
+private:
+    struct Entry {
+        std::string id;
+        Clock::time_point seenAt;
+        std::uint64_t sequence{0};
+    };
+
+    void evict(Clock::time_point now);
+
+    const std::chrono::milliseconds window_;
+    const std::size_t capacity_;
+
+    // Live ids mapped to the sequence of their entry in arrival_. Entries for
+    // erased or re-inserted ids stay queued until evicted and are then ignored.
+    std::unordered_map<std::string, std::uint64_t> seen_;
+    std::deque<Entry> arrival_;
+    std::uint64_t nextSequence_{0};
+};
+
+}  // namespace trading
@@ -2,8 +2,10 @@
 
 #include "common/logging.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <iomanip>
 #include <iostream>
 #include <optional>
@@ -12,15 +14,82 @@
 
 namespace trading {
 namespace {
-constexpr auto kEngineSleepInterval = std::chrono::milliseconds(100);
+constexpr auto kRiskEvaluationInterval = std::chrono::milliseconds(100);
+// Long enough to cover Telegram long-poll redelivery and manual retries.
+constexpr auto kClientOrderIdWindow = std::chrono::minutes(10);
+constexpr std::size_t kClientOrderIdCapacity = 65536;
+
+const char* exitTriggerLabel(ExitTriggerType type) {
+    switch (type) {
+        case ExitTriggerType::StopLoss:
+            return "stop-loss";
+        case ExitTriggerType::TakeProfit:
+            return "take-profit";
+        case ExitTriggerType::TrailingStop:
+        default:
+            return "trailing-stop";
+    }
+}
+
+const char* timeInForceLabel(TimeInForce timeInForce) {
+    switch (timeInForce) {
+        case TimeInForce::ImmediateOrCancel:
+            return "IOC";
+        case TimeInForce::FillOrKill:
+            return "FOK";
+        case TimeInForce::GoodTillTime:
+            return "GTT";
+        case TimeInForce::GoodTillCancel:
+        default:
+            return "GTC";
+    }
+}
+
+bool restsWhenNotMarketable(TimeInForce timeInForce) {
+    return timeInForce == TimeInForce::GoodTillCancel || timeInForce == TimeInForce::GoodTillTime;
+}
+
+// Without a limit or a mark the order is treated as marketable, matching the
+// simulated routing used before marks were available.
+bool crossesMark(bool isBuy, const std::optional<double>& limitPrice, const std::optional<double>& mark) {
+    if (!limitPrice || !mark) {
+        return true;
+    }
+    return isBuy ? *mark <= *limitPrice : *mark >= *limitPrice;
 }
+}  // namespace
 
 RiskManagedEngine::RiskManagedEngine() : RiskManagedEngine(RiskLimits{}) {}
 
-RiskManagedEngine::RiskManagedEngine(RiskLimits limits) : riskLimits_(std::move(limits)) {}
+RiskManagedEngine::RiskManagedEngine(RiskLimits limits)
+    : RiskManagedEngine(std::move(limits), nullptr) {}
+
+RiskManagedEngine::RiskManagedEngine(RiskLimits limits, std::shared_ptr<common::TimerWheel> timers)
+    : timers_(std::move(timers)),
+      riskLimits_(std::move(limits)),
+      clientOrderIds_(kClientOrderIdWindow, kClientOrderIdCapacity) {
+    if (!timers_) {
+        timers_ = std::make_shared<common::TimerWheel>();
+        drivesTimers_ = true;
+    }
+}
 
 RiskManagedEngine::~RiskManagedEngine() {
     stop();
+
+    // Expiry callbacks capture this; on a shared wheel they must not outlive us.
+    std::vector<common::TimerWheel::TimerId> expiries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [orderId, order] : openOrders_) {
+            if (order.expiryTimer != 0) {
+                expiries.push_back(order.expiryTimer);
+            }
+        }
+    }
+    for (const auto timer : expiries) {
+        timers_->cancel(timer);
+    }
 }
 
 void RiskManagedEngine::start() {
@@ -29,6 +98,7 @@ void RiskManagedEngine::start() {
         return;
     }
 
+    riskTimer_ = timers_->scheduleEvery(kRiskEvaluationInterval, [this]() { evaluateAggregateRisk(); });
     worker_ = std::thread(&RiskManagedEngine::executionLoop, this);
 }
 
@@ -37,6 +107,13 @@ void RiskManagedEngine::stop() {
         return;
     }
 
+    timers_->cancel(riskTimer_);
+    {
+        // Pairs with the worker's predicate check so the wakeup is not lost.
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    workCondition_.notify_all();
+
     if (worker_.joinable()) {
         worker_.join();
     }
@@ -51,6 +128,11 @@ void RiskManagedEngine::updateRiskLimits(const RiskLimits& limits) {
     riskLimits_ = limits;
 }
 
+RiskLimits RiskManagedEngine::riskLimits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return riskLimits_;
+}
+
 OrderReceipt RiskManagedEngine::buy(const OrderRequest& request) {
     return submitOrder(request, Order::Side::Buy);
 }
@@ -63,6 +145,129 @@ StatusReport RiskManagedEngine::status(const std::optional<std::string>& symbol)
     return buildStatusReport(symbol);
 }
 
+OrderReceipt RiskManagedEngine::cancelOrder(const std::string& orderId) {
+    OrderReceipt receipt;
+    receipt.orderId = orderId;
+
+    std::optional<Order> order;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        order = closeOrderLocked(orderId);
+    }
+    if (!order) {
+        receipt.message = "Order " + orderId + " is not open.";
+        return receipt;
+    }
+    if (order->expiryTimer != 0) {
+        timers_->cancel(order->expiryTimer);
+    }
+
+    TradeUpdate update;
+    update.orderId = orderId;
+    update.success = false;
+    update.message = "Cancelled order " + orderId + " for " + order->symbol;
+    notifyTradeUpdate(update);
+
+    receipt.success = true;
+    receipt.message = "Order cancelled.";
+    return receipt;
+}
+
+OrderReceipt RiskManagedEngine::replaceOrder(const std::string& orderId, const OrderRequest& request) {
+    OrderReceipt receipt;
+    receipt.orderId = orderId;
+
+    if (request.quantity <= 0.0) {
+        receipt.message = "Quantity must be greater than zero.";
+        return receipt;
+    }
+    if (auto error = validateTimeInForce(request)) {
+        receipt.message = *error;
+        return receipt;
+    }
+
+    Order amended;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = openOrders_.find(orderId);
+        if (it == openOrders_.end()) {
+            receipt.message = "Order " + orderId + " is not open.";
+            return receipt;
+        }
+        if (!request.symbol.empty() && request.symbol != it->second.symbol) {
+            receipt.message = "The symbol of an open order cannot be changed.";
+            return receipt;
+        }
+        amended = it->second;
+    }
+    amended.quantity = request.quantity;
+    amended.limitPrice = request.limitPrice;
+    amended.timeInForce = request.timeInForce;
+
+    const bool allowPartial = amended.timeInForce == TimeInForce::ImmediateOrCancel;
+    if (!applyRiskChecks(amended) && (!allowPartial || riskCompliantQuantity(amended) <= 0.0)) {
+        receipt.message = "Risk controls rejected replacement for order " + orderId;
+        return receipt;
+    }
+
+    common::TimerWheel::TimerId staleExpiry = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = openOrders_.find(orderId);
+        if (it == openOrders_.end()) {
+            receipt.message = "Order " + orderId + " is not open.";
+            return receipt;
+        }
+
+        Order& order = it->second;
+        order.quantity = amended.quantity;
+        order.limitPrice = amended.limitPrice;
+        order.timeInForce = amended.timeInForce;
+        staleExpiry = order.expiryTimer;
+        order.expiryTimer = 0;
+        ++order.expiryGeneration;
+        if (order.timeInForce == TimeInForce::GoodTillTime) {
+            scheduleExpiryLocked(order, *request.goodTill);
+        }
+
+        // The new terms may be marketable (or no longer allowed to rest).
+        if (order.resting) {
+            order.resting = false;
+            auto restingIt = restingOrders_.find(order.symbol);
+            if (restingIt != restingOrders_.end()) {
+                restingIt->second.erase(orderId);
+                if (restingIt->second.empty()) {
+                    restingOrders_.erase(restingIt);
+                }
+            }
+            orderQueue_.push_back(orderId);
+        }
+    }
+    if (staleExpiry != 0) {
+        timers_->cancel(staleExpiry);
+    }
+    workCondition_.notify_one();
+
+    TradeUpdate update;
+    update.orderId = orderId;
+    update.success = true;
+    {
+        std::ostringstream oss;
+        oss << "Replaced order " << orderId << ": " << amended.quantity << " of " << amended.symbol;
+        if (amended.limitPrice) {
+            oss << " @ " << *amended.limitPrice;
+        }
+        oss << " (" << timeInForceLabel(amended.timeInForce) << ")";
+        update.message = oss.str();
+    }
+    notifyTradeUpdate(update);
+
+    receipt.success = true;
+    receipt.message = "Order replaced.";
+    receipt.averagePrice = amended.limitPrice.value_or(0.0);
+    return receipt;
+}
+
 void RiskManagedEngine::subscribeToTradeUpdates(TradeCallback callback) {
     if (!callback) {
         return;
@@ -96,8 +301,91 @@ void RiskManagedEngine::updateMarkPrice(const std::string& symbol, double price)
         return;
     }
 
+    std::vector<TradeUpdate> triggerUpdates;
+    bool requeued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        mark_prices_[symbol] = price;
+        if (isRunning()) {
+            triggerUpdates = queueFiredExitTriggers(symbol, price);
+            requeued = requeueMarketableOrders(symbol, price);
+        }
+    }
+
+    if (!triggerUpdates.empty() || requeued) {
+        workCondition_.notify_one();
+    }
+    for (const auto& update : triggerUpdates) {
+        notifyTradeUpdate(update);
+    }
+}
+
+ExitTriggerReceipt RiskManagedEngine::attachExitTrigger(const ExitTriggerRequest& request) {
+    ExitTriggerReceipt receipt;
+
+    if (request.symbol.empty()) {
+        receipt.message = "Symbol must be specified.";
+        return receipt;
+    }
+
+    if (request.quantity <= 0.0) {
+        receipt.message = "Quantity must be greater than zero.";
+        return receipt;
+    }
+
+    if (request.type == ExitTriggerType::TrailingStop) {
+        if (request.trailingOffset <= 0.0) {
+            receipt.message = "Trailing offset must be greater than zero.";
+            return receipt;
+        }
+    } else if (request.triggerPrice <= 0.0) {
+        receipt.message = "Trigger price must be greater than zero.";
+        return receipt;
+    }
+
+    ExitTriggerBook::Trigger trigger;
+    trigger.triggerId = generateTriggerId();
+    trigger.symbol = request.symbol;
+    trigger.type = request.type;
+    trigger.quantity = request.quantity;
+    trigger.triggerPrice = request.triggerPrice;
+    trigger.trailingOffset = request.trailingOffset;
+    trigger.limitPrice = request.limitPrice;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double referencePrice = 0.0;
+        auto markIt = mark_prices_.find(request.symbol);
+        if (markIt != mark_prices_.end()) {
+            referencePrice = markIt->second;
+        }
+        if (request.type == ExitTriggerType::TrailingStop && referencePrice <= 0.0) {
+            receipt.message = "No Pump.fun mark price available for " + request.symbol +
+                              "; unable to anchor trailing stop.";
+            return receipt;
+        }
+        exitTriggers_.add(trigger, referencePrice);
+    }
+
+    std::ostringstream oss;
+    oss << "Armed " << exitTriggerLabel(trigger.type) << " trigger for " << trigger.quantity
+        << " of " << trigger.symbol;
+    if (trigger.type == ExitTriggerType::TrailingStop) {
+        oss << " trailing by " << trigger.trailingOffset;
+    } else {
+        oss << " @ " << trigger.triggerPrice;
+    }
+    LOG_INFO(oss.str());
+
+    receipt.success = true;
+    receipt.message = "Exit trigger armed.";
+    receipt.triggerId = trigger.triggerId;
+    return receipt;
+}
+
+bool RiskManagedEngine::cancelExitTrigger(const std::string& triggerId) {
     std::lock_guard<std::mutex> lock(mutex_);
-    mark_prices_[symbol] = price;
+    return exitTriggers_.remove(triggerId);
 }
 
 OrderReceipt RiskManagedEngine::submitOrder(const OrderRequest& request, Order::Side side) {
@@ -121,14 +409,47 @@ OrderReceipt RiskManagedEngine::submitOrder(const OrderRequest& request, Order::
         return receipt;
     }
 
+    if (auto error = validateTimeInForce(request)) {
+        receipt.success = false;
+        receipt.message = *error;
+        return receipt;
+    }
+
+    if (request.clientOrderId) {
+        if (request.clientOrderId->empty()) {
+            receipt.success = false;
+            receipt.message = "Client order id must not be empty.";
+            return receipt;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!clientOrderIds_.insert(*request.clientOrderId)) {
+            LOG_WARN("Rejecting duplicate client order id " + *request.clientOrderId);
+            receipt.success = false;
+            receipt.message = "Duplicate client order id " + *request.clientOrderId +
+                              "; the order was already submitted.";
+            return receipt;
+        }
+    }
+
     Order order;
     order.orderId = generateOrderId();
     order.symbol = request.symbol;
     order.quantity = request.quantity;
     order.limitPrice = request.limitPrice;
     order.side = side;
+    order.timeInForce = request.timeInForce;
+
+    // An IOC order is accepted as long as some of it can fill within limits.
+    const bool allowPartial = order.timeInForce == TimeInForce::ImmediateOrCancel;
+    if (!applyRiskChecks(order) && (!allowPartial || riskCompliantQuantity(order) <= 0.0)) {
+        if (request.clientOrderId) {
+            // Only accepted orders hold on to their client id, so a retry after
+            // the limits free up is not mistaken for a duplicate.
+            std::lock_guard<std::mutex> lock(mutex_);
+            clientOrderIds_.erase(*request.clientOrderId);
+        }
 
-    if (!applyRiskChecks(order)) {
         TradeUpdate update;
         update.orderId = order.orderId;
         update.success = false;
@@ -143,8 +464,13 @@ OrderReceipt RiskManagedEngine::submitOrder(const OrderRequest& request, Order::
 
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        orderQueue_.push_back(order);
+        auto& stored = openOrders_.emplace(order.orderId, order).first->second;
+        if (stored.timeInForce == TimeInForce::GoodTillTime) {
+            scheduleExpiryLocked(stored, *request.goodTill);
+        }
+        orderQueue_.push_back(order.orderId);
     }
+    workCondition_.notify_one();
 
     TradeUpdate acceptance;
     acceptance.orderId = order.orderId;
@@ -157,6 +483,7 @@ OrderReceipt RiskManagedEngine::submitOrder(const OrderRequest& request, Order::
         if (order.limitPrice) {
             oss << " @ " << *order.limitPrice;
         }
+        oss << " (" << timeInForceLabel(order.timeInForce) << ")";
         acceptance.message = oss.str();
     }
     notifyTradeUpdate(acceptance);
@@ -169,9 +496,25 @@ OrderReceipt RiskManagedEngine::submitOrder(const OrderRequest& request, Order::
     return receipt;
 }
 
+std::optional<std::string> RiskManagedEngine::validateTimeInForce(const OrderRequest& request) const {
+    if (request.timeInForce != TimeInForce::GoodTillTime) {
+        if (request.goodTill) {
+            return std::string("An expiry is only valid for good-till-time orders.");
+        }
+        return std::nullopt;
+    }
+    if (!request.goodTill) {
+        return std::string("Good-till-time orders require an expiry.");
+    }
+    if (*request.goodTill <= std::chrono::system_clock::now()) {
+        return std::string("Good-till-time expiry is already in the past.");
+    }
+    return std::nullopt;
+}
+
 void RiskManagedEngine::executionLoop() {
     while (running_.load()) {
-        std::vector<Order> pending;
+        std::vector<std::string> pending;
         {
             std::lock_guard<std::mutex> lock(mutex_);
             pending.swap(orderQueue_);
@@ -181,11 +524,27 @@ void RiskManagedEngine::executionLoop() {
             routePendingOrders(pending);
         }
 
-        evaluateAggregateRisk();
-        std::this_thread::sleep_for(kEngineSleepInterval);
+        // Sleep until an order arrives or, when driving the private wheel, the
+        // next timer (risk sweep, expiries) is due.
+        std::optional<common::TimerWheel::Clock::time_point> nextTimer;
+        if (drivesTimers_) {
+            timers_->advance();
+            nextTimer = timers_->nextExpiry();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto hasWork = [this]() {
+            return !running_.load() || !orderQueue_.empty() || timersChanged_;
+        };
+        if (nextTimer) {
+            workCondition_.wait_until(lock, *nextTimer, hasWork);
+        } else {
+            workCondition_.wait(lock, hasWork);
+        }
+        timersChanged_ = false;
     }
 
-    std::vector<Order> pending;
+    std::vector<std::string> pending;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         pending.swap(orderQueue_);
@@ -195,37 +554,255 @@ void RiskManagedEngine::executionLoop() {
     }
 }
 
-void RiskManagedEngine::routePendingOrders(std::vector<Order>& orders) {
-    for (const auto& order : orders) {
-        if (!applyRiskChecks(order)) {
-            TradeUpdate update;
-            update.orderId = order.orderId;
-            update.success = false;
-            update.message = "Risk control rejected order for symbol " + order.symbol;
-            notifyTradeUpdate(update);
-            continue;
+void RiskManagedEngine::routePendingOrders(std::vector<std::string>& orderIds) {
+    for (const auto& orderId : orderIds) {
+        routeOrder(orderId);
+    }
+}
+
+void RiskManagedEngine::routeOrder(const std::string& orderId) {
+    std::optional<Order> order;
+    std::optional<double> mark;
+    TradeUpdate restingNotice;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = openOrders_.find(orderId);
+        if (it == openOrders_.end()) {
+            return;  // Cancelled or expired while queued.
         }
 
-        handleOrderRouting(order);
-        updatePositionTracking(order);
+        auto markIt = mark_prices_.find(it->second.symbol);
+        if (markIt != mark_prices_.end()) {
+            mark = markIt->second;
+        }
 
-        TradeUpdate update;
-        update.orderId = order.orderId;
-        update.success = true;
-        {
+        Order& open = it->second;
+        if (crossesMark(open.side == Order::Side::Buy, open.limitPrice, mark) ||
+            !restsWhenNotMarketable(open.timeInForce)) {
+            order = closeOrderLocked(orderId);
+        } else {
+            open.resting = true;
+            restingOrders_[open.symbol].insert(orderId);
+
+            restingNotice.orderId = orderId;
+            restingNotice.success = true;
             std::ostringstream oss;
-            oss << "Executed "
-                << (order.side == Order::Side::Buy ? "buy" : "sell")
-                << " order for " << order.symbol << " (" << order.quantity << ")";
-            if (order.limitPrice) {
-                oss << " @ " << *order.limitPrice;
+            oss << "Order " << orderId << " resting: limit " << *open.limitPrice
+                << " not marketable at mark " << *mark;
+            restingNotice.message = oss.str();
+        }
+    }
+
+    if (!order) {
+        notifyTradeUpdate(restingNotice);
+        return;
+    }
+
+    if (order->expiryTimer != 0) {
+        timers_->cancel(order->expiryTimer);
+    }
+
+    const bool isBuy = order->side == Order::Side::Buy;
+    if (!crossesMark(isBuy, order->limitPrice, mark)) {
+        TradeUpdate update;
+        update.orderId = order->orderId;
+        update.success = false;
+        std::ostringstream oss;
+        oss << "Cancelled " << timeInForceLabel(order->timeInForce) << " order for " << order->symbol
+            << ": limit " << *order->limitPrice << " not marketable at mark " << *mark;
+        update.message = oss.str();
+        notifyTradeUpdate(update);
+        return;
+    }
+
+    double fillQuantity = order->quantity;
+    if (!applyRiskChecks(*order)) {
+        fillQuantity = order->timeInForce == TimeInForce::ImmediateOrCancel
+                           ? riskCompliantQuantity(*order)
+                           : 0.0;
+    }
+    if (fillQuantity <= 0.0) {
+        TradeUpdate update;
+        update.orderId = order->orderId;
+        update.success = false;
+        update.message = "Risk control rejected order for symbol " + order->symbol;
+        notifyTradeUpdate(update);
+        return;
+    }
+
+    const double cancelledQuantity = order->quantity - fillQuantity;
+    order->quantity = fillQuantity;
+    handleOrderRouting(*order);
+    updatePositionTracking(*order);
+
+    TradeUpdate update;
+    update.orderId = order->orderId;
+    update.success = true;
+    update.filledQuantity = order->quantity;
+    {
+        std::ostringstream oss;
+        oss << "Executed "
+            << (isBuy ? "buy" : "sell")
+            << " order for " << order->symbol << " (" << order->quantity << ")";
+        if (order->limitPrice) {
+            oss << " @ " << *order->limitPrice;
+        }
+        if (cancelledQuantity > 0.0) {
+            oss << "; cancelled remaining " << cancelledQuantity << " (IOC)";
+        }
+        update.message = oss.str();
+    }
+    notifyTradeUpdate(update);
+
+    notifyStatusUpdate(status(std::nullopt));
+}
+
+bool RiskManagedEngine::requeueMarketableOrders(const std::string& symbol, double price) {
+    auto restingIt = restingOrders_.find(symbol);
+    if (restingIt == restingOrders_.end()) {
+        return false;
+    }
+
+    bool requeued = false;
+    auto& resting = restingIt->second;
+    for (auto it = resting.begin(); it != resting.end();) {
+        auto orderIt = openOrders_.find(*it);
+        if (orderIt != openOrders_.end()) {
+            Order& order = orderIt->second;
+            if (!crossesMark(order.side == Order::Side::Buy, order.limitPrice, price)) {
+                ++it;
+                continue;
             }
+            order.resting = false;
+            orderQueue_.push_back(order.orderId);
+            requeued = true;
+        }
+        it = resting.erase(it);
+    }
+
+    if (resting.empty()) {
+        restingOrders_.erase(restingIt);
+    }
+    return requeued;
+}
+
+void RiskManagedEngine::scheduleExpiryLocked(Order& order,
+                                             std::chrono::system_clock::time_point goodTill) {
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+        goodTill - std::chrono::system_clock::now());
+    const std::string orderId = order.orderId;
+    const std::uint64_t generation = ++order.expiryGeneration;
+    order.expiryTimer =
+        timers_->schedule(delay, [this, orderId, generation]() { expireOrder(orderId, generation); });
+    if (drivesTimers_) {
+        timersChanged_ = true;
+    }
+}
+
+std::optional<RiskManagedEngine::Order> RiskManagedEngine::closeOrderLocked(const std::string& orderId) {
+    auto it = openOrders_.find(orderId);
+    if (it == openOrders_.end()) {
+        return std::nullopt;
+    }
+
+    Order order = std::move(it->second);
+    openOrders_.erase(it);
+    if (order.resting) {
+        auto restingIt = restingOrders_.find(order.symbol);
+        if (restingIt != restingOrders_.end()) {
+            restingIt->second.erase(orderId);
+            if (restingIt->second.empty()) {
+                restingOrders_.erase(restingIt);
+            }
+        }
+    }
+    return order;
+}
+
+void RiskManagedEngine::expireOrder(const std::string& orderId, std::uint64_t generation) {
+    std::optional<Order> order;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = openOrders_.find(orderId);
+        if (it == openOrders_.end() || it->second.expiryGeneration != generation) {
+            return;
+        }
+        order = closeOrderLocked(orderId);
+    }
+
+    TradeUpdate update;
+    update.orderId = orderId;
+    update.success = false;
+    update.message = "Good-till-time order " + orderId + " for " + order->symbol + " expired unfilled";
+    notifyTradeUpdate(update);
+}
+
+std::vector<TradeUpdate> RiskManagedEngine::queueFiredExitTriggers(const std::string& symbol,
+                                                                   double price) {
+    std::vector<TradeUpdate> updates;
+    auto fired = exitTriggers_.onMarkPrice(symbol, price);
+    if (fired.empty()) {
+        return updates;
+    }
+
+    // Exits never flip a position short: clamp to what is held net of sells
+    // that are already queued or resting for this symbol.
+    double available = 0.0;
+    auto positionIt = positions_.find(symbol);
+    if (positionIt != positions_.end()) {
+        available = positionIt->second;
+    }
+    const auto sellQuantity = [this, &symbol](const std::string& orderId) {
+        auto orderIt = openOrders_.find(orderId);
+        if (orderIt == openOrders_.end() || orderIt->second.symbol != symbol ||
+            orderIt->second.side != Order::Side::Sell) {
+            return 0.0;
+        }
+        return orderIt->second.quantity;
+    };
+    for (const auto& queuedId : orderQueue_) {
+        available -= sellQuantity(queuedId);
+    }
+    auto restingIt = restingOrders_.find(symbol);
+    if (restingIt != restingOrders_.end()) {
+        for (const auto& restingId : restingIt->second) {
+            available -= sellQuantity(restingId);
+        }
+    }
+
+    for (const auto& result : fired) {
+        const auto& trigger = result.trigger;
+        TradeUpdate update;
+        std::ostringstream oss;
+        oss << "Exit trigger " << trigger.triggerId << " (" << exitTriggerLabel(trigger.type)
+            << " @ " << result.stopLevel << ") fired at mark " << price;
+
+        if (available <= 0.0) {
+            oss << "; no open position in " << symbol << " to exit";
+            update.success = false;
             update.message = oss.str();
+            updates.push_back(std::move(update));
+            continue;
         }
-        notifyTradeUpdate(update);
 
-        notifyStatusUpdate(status(std::nullopt));
+        Order order;
+        order.orderId = generateOrderId();
+        order.symbol = symbol;
+        order.quantity = std::min(trigger.quantity, available);
+        order.limitPrice = trigger.limitPrice;
+        order.side = Order::Side::Sell;
+        openOrders_.emplace(order.orderId, order);
+        orderQueue_.push_back(order.orderId);
+        available -= order.quantity;
+
+        oss << "; queued sell " << order.quantity << " of " << symbol;
+        update.orderId = order.orderId;
+        update.success = true;
+        update.message = oss.str();
+        updates.push_back(std::move(update));
     }
+
+    return updates;
 }
 
 void RiskManagedEngine::handleOrderRouting(const Order& order) {
@@ -310,6 +887,38 @@ bool RiskManagedEngine::applyRiskChecks(const Order& order) const {
     return true;
 }
 
+double RiskManagedEngine::riskCompliantQuantity(const Order& order) const {
+    if (applyRiskChecks(order)) {
+        return order.quantity;
+    }
+
+    // Only the position limit is sized down; an exposure breach at the reduced
+    // size still rejects.
+    double currentPosition = 0.0;
+    double maxPosition = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxPosition = riskLimits_.maxPosition;
+        auto positionIt = positions_.find(order.symbol);
+        if (positionIt != positions_.end()) {
+            currentPosition = positionIt->second;
+        }
+    }
+    if (maxPosition <= 0.0) {
+        return 0.0;
+    }
+
+    const double headroom = order.side == Order::Side::Buy ? maxPosition - currentPosition
+                                                           : maxPosition + currentPosition;
+    if (headroom <= 0.0) {
+        return 0.0;
+    }
+
+    Order reduced = order;
+    reduced.quantity = std::min(order.quantity, headroom);
+    return applyRiskChecks(reduced) ? reduced.quantity : 0.0;
+}
+
 void RiskManagedEngine::evaluateAggregateRisk() const {
     std::vector<std::string> warnings;
     {
@@ -413,6 +1022,11 @@ std::string RiskManagedEngine::generateOrderId() {
     return "ORD-" + std::to_string(id);
 }
 
+std::string RiskManagedEngine::generateTriggerId() {
+    const auto id = ++triggerCounter_;
+    return "TRG-" + std::to_string(id);
+}
+
 StatusReport RiskManagedEngine::buildStatusReport(const std::optional<std::string>& symbol) const {
     StatusReport report;
     std::lock_guard<std::mutex> lock(mutex_);
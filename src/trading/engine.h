@@ -1,14 +1,21 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "common/timer_wheel.h"
+#include "trading/client_order_id_filter.h"
+#include "trading/exit_trigger_book.h"
 #include "trading/trading_engine.h"
 
 namespace trading {
@@ -17,6 +24,9 @@ class RiskManagedEngine : public TradingEngine {
 public:
     RiskManagedEngine();
     explicit RiskManagedEngine(RiskLimits limits);
+    // Shares an externally driven timer wheel (e.g. with the market-data client
+    // and execution algos). Without one the engine thread drives a private wheel.
+    RiskManagedEngine(RiskLimits limits, std::shared_ptr<common::TimerWheel> timers);
     ~RiskManagedEngine() override;
 
     RiskManagedEngine(const RiskManagedEngine&) = delete;
@@ -30,13 +40,20 @@ public:
     bool isRunning() const override;
 
     void updateRiskLimits(const RiskLimits& limits) override;
+    RiskLimits riskLimits() const override;
 
     OrderReceipt buy(const OrderRequest& request) override;
     OrderReceipt sell(const OrderRequest& request) override;
     StatusReport status(const std::optional<std::string>& symbol) const override;
 
+    OrderReceipt cancelOrder(const std::string& orderId) override;
+    OrderReceipt replaceOrder(const std::string& orderId, const OrderRequest& request) override;
+
     void updateMarkPrice(const std::string& symbol, double price) override;
 
+    ExitTriggerReceipt attachExitTrigger(const ExitTriggerRequest& request) override;
+    bool cancelExitTrigger(const std::string& triggerId) override;
+
     void subscribeToTradeUpdates(TradeCallback callback) override;
     void subscribeToAlerts(AlertCallback callback) override;
     void subscribeToStatusUpdates(StatusCallback callback) override;
@@ -48,15 +65,35 @@ private:
         double quantity{0.0};
         std::optional<double> limitPrice;
         enum class Side { Buy, Sell } side{Side::Buy};
+        TimeInForce timeInForce{TimeInForce::GoodTillCancel};
+        common::TimerWheel::TimerId expiryTimer{0};
+        // Bumped on every (re)arm so a superseded expiry that was already
+        // running when replaced cannot expire the amended order.
+        std::uint64_t expiryGeneration{0};
+        bool resting{false};
     };
 
     OrderReceipt submitOrder(const OrderRequest& request, Order::Side side);
+    std::optional<std::string> validateTimeInForce(const OrderRequest& request) const;
 
     void executionLoop();
-    void routePendingOrders(std::vector<Order>& orders);
+    void routePendingOrders(std::vector<std::string>& orderIds);
+    void routeOrder(const std::string& orderId);
     void handleOrderRouting(const Order& order);
     void updatePositionTracking(const Order& order);
+    // Requires mutex_ to be held. Moves fired exit triggers into orderQueue_.
+    std::vector<TradeUpdate> queueFiredExitTriggers(const std::string& symbol, double price);
+    // Requires mutex_ to be held. Requeues resting orders the new mark crosses.
+    bool requeueMarketableOrders(const std::string& symbol, double price);
+    // Requires mutex_ to be held. Arms the good-till-time expiry for an open order.
+    void scheduleExpiryLocked(Order& order, std::chrono::system_clock::time_point goodTill);
+    // Requires mutex_ to be held. Removes an order from the open-order table and
+    // returns it; its expiry timer must be cancelled after releasing mutex_.
+    std::optional<Order> closeOrderLocked(const std::string& orderId);
+    void expireOrder(const std::string& orderId, std::uint64_t generation);
     bool applyRiskChecks(const Order& order) const;
+    // Largest quantity of order (up to its full size) that passes risk checks.
+    double riskCompliantQuantity(const Order& order) const;
     void evaluateAggregateRisk() const;
 
     void notifyTradeUpdate(const TradeUpdate& update) const;
@@ -64,17 +101,33 @@ private:
     void notifyStatusUpdate(const StatusReport& report) const;
 
     std::string generateOrderId();
+    std::string generateTriggerId();
 
     StatusReport buildStatusReport(const std::optional<std::string>& symbol) const;
 
     std::atomic<bool> running_{false};
     mutable std::mutex mutex_;
+    std::condition_variable workCondition_;
     std::thread worker_;
 
-    std::vector<Order> orderQueue_;
+    std::shared_ptr<common::TimerWheel> timers_;
+    bool drivesTimers_{false};
+    common::TimerWheel::TimerId riskTimer_{0};
+
+    // Open orders by id. orderQueue_ and restingOrders_ hold ids only; entries
+    // whose order was cancelled or filled meanwhile are skipped when drained.
+    std::unordered_map<std::string, Order> openOrders_;
+    std::vector<std::string> orderQueue_;
+    // Non-marketable limit orders by symbol, re-evaluated on mark updates.
+    std::unordered_map<std::string, std::unordered_set<std::string>> restingOrders_;
+    // Set when an expiry lands on the private wheel so the worker re-computes
+    // its wait deadline.
+    bool timersChanged_{false};
     std::unordered_map<std::string, double> positions_;
     std::unordered_map<std::string, double> mark_prices_;
     RiskLimits riskLimits_;
+    ExitTriggerBook exitTriggers_;
+    ClientOrderIdFilter clientOrderIds_;
 
     mutable std::mutex callbacksMutex_;
     std::vector<TradeCallback> tradeSubscribers_;
@@ -82,6 +135,7 @@ private:
     std::vector<StatusCallback> statusSubscribers_;
 
     std::atomic<std::uint64_t> orderCounter_{0};
+    std::atomic<std::uint64_t> triggerCounter_{0};
 };
 
 }  // namespace trading
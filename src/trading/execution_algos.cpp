@@ -0,0 +1,474 @@
+#include "trading/execution_algos.h"
+
+#include "common/logging.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+namespace trading {
+namespace {
+constexpr double kQuantityEpsilon = 1e-9;
+constexpr auto kVolumeWindow = std::chrono::hours(24);
+
+const char* algoLabel(ExecutionAlgoType algo) {
+    switch (algo) {
+        case ExecutionAlgoType::Twap:
+            return "TWAP";
+        case ExecutionAlgoType::Vwap:
+            return "VWAP";
+        case ExecutionAlgoType::Participation:
+        default:
+            return "POV";
+    }
+}
+}  // namespace
+
+ExecutionAlgoEngine::ExecutionAlgoEngine(TradingEngine& engine,
+                                         std::shared_ptr<common::TimerWheel> timers)
+    : engine_(engine),
+      aliveFlag_(std::make_shared<std::atomic<bool>>(true)),
+      timers_(std::move(timers)) {
+    if (!timers_) {
+        timers_ = std::make_shared<common::TimerWheel>();
+        ownsTimers_ = true;
+    }
+
+    auto alive = aliveFlag_;
+    engine_.subscribeToTradeUpdates([this, alive](const TradeUpdate& update) {
+        if (!alive || !alive->load()) {
+            return;
+        }
+        handleTradeUpdate(update);
+    });
+}
+
+ExecutionAlgoEngine::~ExecutionAlgoEngine() {
+    if (aliveFlag_) {
+        aliveFlag_->store(false);
+    }
+    stop();
+}
+
+void ExecutionAlgoEngine::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) {
+        return;
+    }
+
+    if (ownsTimers_) {
+        timers_->start();
+    }
+}
+
+void ExecutionAlgoEngine::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // runSlice() re-checks running_ under mutex_ before re-arming, so once the
+    // timers collected here are cancelled no slice can fire again.
+    std::vector<common::TimerWheel::TimerId> timers;
+    std::vector<ParentOrderStatus> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [id, parent] : parents_) {
+            (void)id;
+            if (parent.sliceTimer != 0) {
+                timers.push_back(parent.sliceTimer);
+                parent.sliceTimer = 0;
+            }
+            if (parent.status.state != ParentOrderState::Working) {
+                continue;
+            }
+            parent.status.state = ParentOrderState::Cancelled;
+            parent.status.message = "Execution algo engine stopped.";
+            cancelled.push_back(parent.status);
+        }
+    }
+
+    for (const auto timer : timers) {
+        timers_->cancel(timer);
+    }
+    if (ownsTimers_) {
+        timers_->stop();
+    }
+
+    for (const auto& status : cancelled) {
+        notifyProgress(status);
+    }
+}
+
+bool ExecutionAlgoEngine::isRunning() const {
+    return running_.load();
+}
+
+ParentOrderStatus ExecutionAlgoEngine::submit(const ParentOrderRequest& request) {
+    ParentOrderStatus status;
+    status.symbol = request.symbol;
+    status.side = request.side;
+    status.algo = request.algo;
+    status.targetQuantity = request.quantity;
+    status.state = ParentOrderState::Rejected;
+
+    if (!isRunning()) {
+        status.message = "Execution algo engine is not running; unable to accept parent orders.";
+        return status;
+    }
+
+    if (request.symbol.empty()) {
+        status.message = "Symbol must be specified.";
+        return status;
+    }
+
+    if (request.quantity <= 0.0) {
+        status.message = "Quantity must be greater than zero.";
+        return status;
+    }
+
+    if (request.sliceInterval.count() <= 0 || request.duration < request.sliceInterval) {
+        status.message = "Duration must cover at least one positive slice interval.";
+        return status;
+    }
+
+    if (request.algo == ExecutionAlgoType::Participation &&
+        (request.participationRate <= 0.0 || request.participationRate > 1.0)) {
+        status.message = "Participation rate must be within (0, 1].";
+        return status;
+    }
+
+    const RiskLimits limits = engine_.riskLimits();
+    if (limits.maxPosition > 0.0 && request.quantity > limits.maxPosition) {
+        status.message = "Parent quantity exceeds the configured position limit.";
+        return status;
+    }
+
+    const auto now = Clock::now();
+    ParentOrder parent;
+    parent.request = request;
+    parent.startTime = now;
+    parent.endTime = now + request.duration;
+    parent.slicesTotal = std::max<std::size_t>(
+        1, static_cast<std::size_t>(request.duration / request.sliceInterval));
+
+    status.parentId = generateParentId();
+    status.state = ParentOrderState::Working;
+    status.message = "Parent order working.";
+    parent.status = status;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& stored = parents_.emplace(status.parentId, std::move(parent)).first->second;
+        scheduleSliceLocked(stored, now);
+    }
+
+    std::ostringstream oss;
+    oss << "Working " << algoLabel(request.algo) << " parent " << status.parentId << ": "
+        << (request.side == ParentOrderSide::Buy ? "buy " : "sell ") << request.quantity << " of "
+        << request.symbol << " over " << request.duration.count() << "ms";
+    LOG_INFO(oss.str());
+
+    notifyProgress(status);
+    return status;
+}
+
+bool ExecutionAlgoEngine::cancel(const std::string& parentId) {
+    ParentOrderStatus snapshot;
+    common::TimerWheel::TimerId timer = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = parents_.find(parentId);
+        if (it == parents_.end() || it->second.status.state != ParentOrderState::Working) {
+            return false;
+        }
+        it->second.status.state = ParentOrderState::Cancelled;
+        it->second.status.message = "Parent order cancelled.";
+        std::swap(timer, it->second.sliceTimer);
+        snapshot = it->second.status;
+    }
+
+    // Cancelled outside mutex_: the wheel may wait for an in-flight slice
+    // callback, which itself takes mutex_.
+    if (timer != 0) {
+        timers_->cancel(timer);
+    }
+    notifyProgress(snapshot);
+    return true;
+}
+
+std::optional<ParentOrderStatus> ExecutionAlgoEngine::parentStatus(const std::string& parentId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = parents_.find(parentId);
+    if (it == parents_.end()) {
+        return std::nullopt;
+    }
+    return it->second.status;
+}
+
+void ExecutionAlgoEngine::updateMarketData(const std::string& symbol, double price, double volume24h) {
+    if (symbol.empty() || price <= 0.0 || volume24h < 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& sample = marketData_[symbol];
+    sample.price = price;
+    sample.volume24h = volume24h;
+}
+
+void ExecutionAlgoEngine::subscribeToProgress(ProgressCallback callback) {
+    if (!callback) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(callbacksMutex_);
+    progressSubscribers_.push_back(std::move(callback));
+}
+
+void ExecutionAlgoEngine::runSlice(const std::string& parentId) {
+    std::optional<ChildPlan> plan;
+    std::optional<ParentOrderStatus> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.load()) {
+            return;
+        }
+        plan = planSlice(parentId, Clock::now(), finished);
+        if (plan) {
+            ++submissionsInFlight_;
+        }
+    }
+
+    if (plan) {
+        submitChild(*plan);
+    }
+    if (finished) {
+        notifyProgress(*finished);
+    }
+}
+
+void ExecutionAlgoEngine::scheduleSliceLocked(ParentOrder& parent, Clock::time_point due) {
+    const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::max(Clock::duration::zero(), due - Clock::now()));
+    auto alive = aliveFlag_;
+    const std::string parentId = parent.status.parentId;
+    parent.sliceTimer = timers_->schedule(delay, [this, alive, parentId]() {
+        if (!alive || !alive->load()) {
+            return;
+        }
+        runSlice(parentId);
+    });
+}
+
+std::optional<ExecutionAlgoEngine::ChildPlan> ExecutionAlgoEngine::planSlice(
+    const std::string& parentId,
+    Clock::time_point now,
+    std::optional<ParentOrderStatus>& finished) {
+    auto it = parents_.find(parentId);
+    if (it == parents_.end() || it->second.status.state != ParentOrderState::Working) {
+        return std::nullopt;
+    }
+
+    auto& parent = it->second;
+    parent.sliceTimer = 0;
+    ++parent.slicesElapsed;
+    const bool finalSlice = parent.slicesElapsed >= parent.slicesTotal;
+    if (!finalSlice) {
+        scheduleSliceLocked(parent,
+                            parent.startTime + parent.request.sliceInterval * parent.slicesElapsed);
+    }
+
+    const double remaining = parent.status.targetQuantity - parent.status.submittedQuantity;
+    const double quantity = computeChildQuantity(parent, now);
+
+    if (finalSlice && remaining - quantity > kQuantityEpsilon) {
+        // Only participation can run out of window: TWAP/VWAP sweep on the last slice.
+        std::ostringstream oss;
+        oss << "Participation window elapsed with "
+            << parent.status.submittedQuantity + quantity << " of "
+            << parent.status.targetQuantity << " submitted.";
+        parent.status.state = ParentOrderState::Expired;
+        parent.status.message = oss.str();
+        finished = parent.status;
+    }
+
+    if (quantity <= kQuantityEpsilon) {
+        return std::nullopt;
+    }
+
+    ChildPlan plan;
+    plan.parentId = parentId;
+    plan.side = parent.request.side;
+    plan.request.symbol = parent.request.symbol;
+    plan.request.quantity = quantity;
+    plan.request.limitPrice = parent.request.limitPrice;
+    return plan;
+}
+
+double ExecutionAlgoEngine::computeChildQuantity(ParentOrder& parent, Clock::time_point now) {
+    const double remaining = parent.status.targetQuantity - parent.status.submittedQuantity;
+    if (remaining <= kQuantityEpsilon) {
+        return 0.0;
+    }
+
+    const bool finalSlice = parent.slicesElapsed >= parent.slicesTotal;
+    const double slicesLeft =
+        static_cast<double>(parent.slicesTotal - parent.slicesElapsed + 1);
+
+    // TokenQuote only exposes a rolling 24h volume, so the change between two
+    // samples stands in for the volume traded during the last slice.
+    MarketSample sample;
+    auto sampleIt = marketData_.find(parent.request.symbol);
+    if (sampleIt != marketData_.end()) {
+        sample = sampleIt->second;
+    }
+    std::optional<double> intervalVolume;
+    if (sample.volume24h > 0.0) {
+        if (parent.lastVolumeSample) {
+            intervalVolume = std::max(0.0, sample.volume24h - *parent.lastVolumeSample);
+        }
+        parent.lastVolumeSample = sample.volume24h;
+    }
+
+    double quantity = 0.0;
+    switch (parent.request.algo) {
+        case ExecutionAlgoType::Twap:
+            quantity = finalSlice ? remaining : remaining / slicesLeft;
+            break;
+        case ExecutionAlgoType::Vwap:
+            if (finalSlice) {
+                quantity = remaining;
+            } else if (intervalVolume) {
+                // Weight this slice by observed volume against the volume the
+                // 24h rate projects for the rest of the horizon.
+                const auto timeLeft = std::max(Clock::duration::zero(),
+                                               parent.endTime - now - parent.request.sliceInterval);
+                const double projected =
+                    sample.volume24h * (std::chrono::duration<double>(timeLeft) /
+                                        std::chrono::duration<double>(kVolumeWindow));
+                const double denominator = *intervalVolume + projected;
+                quantity = denominator > 0.0 ? remaining * (*intervalVolume / denominator) : 0.0;
+            } else {
+                quantity = remaining / slicesLeft;
+            }
+            break;
+        case ExecutionAlgoType::Participation:
+            if (intervalVolume && sample.price > 0.0) {
+                quantity = parent.request.participationRate * (*intervalVolume / sample.price);
+            }
+            break;
+    }
+
+    if (parent.request.maxChildQuantity > 0.0) {
+        quantity = std::min(quantity, parent.request.maxChildQuantity);
+    }
+    return std::clamp(quantity, 0.0, remaining);
+}
+
+void ExecutionAlgoEngine::submitChild(const ChildPlan& plan) {
+    const OrderReceipt receipt = plan.side == ParentOrderSide::Buy ? engine_.buy(plan.request)
+                                                                   : engine_.sell(plan.request);
+
+    std::optional<ParentOrderStatus> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --submissionsInFlight_;
+
+        auto it = parents_.find(plan.parentId);
+        if (it != parents_.end()) {
+            auto& parent = it->second;
+            if (receipt.success) {
+                childToParent_[receipt.orderId] = plan.parentId;
+                parent.status.submittedQuantity += plan.request.quantity;
+                ++parent.status.childOrders;
+
+                auto fillIt = unmatchedFills_.find(receipt.orderId);
+                if (fillIt != unmatchedFills_.end()) {
+                    applyFill(parent, fillIt->second);
+                    childToParent_.erase(receipt.orderId);
+                    unmatchedFills_.erase(fillIt);
+                }
+            } else if (parent.status.state == ParentOrderState::Working) {
+                parent.status.state = ParentOrderState::Rejected;
+                parent.status.message = "Child order rejected: " + receipt.message;
+            }
+            snapshot = parent.status;
+        }
+
+        if (submissionsInFlight_ == 0) {
+            unmatchedFills_.clear();
+        }
+    }
+
+    if (snapshot) {
+        notifyProgress(*snapshot);
+    }
+}
+
+void ExecutionAlgoEngine::handleTradeUpdate(const TradeUpdate& update) {
+    if (update.orderId.empty()) {
+        return;
+    }
+
+    ParentOrderStatus snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto childIt = childToParent_.find(update.orderId);
+        if (childIt == childToParent_.end()) {
+            if (submissionsInFlight_ > 0 && update.filledQuantity > 0.0) {
+                unmatchedFills_[update.orderId] += update.filledQuantity;
+            }
+            return;
+        }
+
+        if (update.success && update.filledQuantity <= 0.0) {
+            return;  // Acceptance notice; wait for the execution.
+        }
+
+        auto parentIt = parents_.find(childIt->second);
+        childToParent_.erase(childIt);
+        if (parentIt == parents_.end()) {
+            return;
+        }
+
+        auto& parent = parentIt->second;
+        if (update.filledQuantity > 0.0) {
+            applyFill(parent, update.filledQuantity);
+        } else if (parent.status.state == ParentOrderState::Working) {
+            parent.status.state = ParentOrderState::Rejected;
+            parent.status.message = "Child order rejected at routing: " + update.message;
+        }
+        snapshot = parent.status;
+    }
+
+    notifyProgress(snapshot);
+}
+
+void ExecutionAlgoEngine::applyFill(ParentOrder& parent, double quantity) {
+    parent.status.filledQuantity += quantity;
+    if (parent.status.state == ParentOrderState::Working &&
+        parent.status.filledQuantity + kQuantityEpsilon >= parent.status.targetQuantity) {
+        parent.status.state = ParentOrderState::Completed;
+        parent.status.message = "Parent order filled.";
+    }
+}
+
+void ExecutionAlgoEngine::notifyProgress(const ParentOrderStatus& status) const {
+    std::vector<ProgressCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(callbacksMutex_);
+        callbacks = progressSubscribers_;
+    }
+
+    for (const auto& callback : callbacks) {
+        if (callback) {
+            callback(status);
+        }
+    }
+}
+
+std::string ExecutionAlgoEngine::generateParentId() {
+    const auto id = ++parentCounter_;
+    return "ALG-" + std::to_string(id);
+}
+
+}  // namespace trading
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/timer_wheel.h"
+#include "trading/trading_engine.h"
+
+namespace trading {
+
+enum class ExecutionAlgoType {
+    Twap,
+    Vwap,
+    Participation,
+};
+
+enum class ParentOrderSide {
+    Buy,
+    Sell,
+};
+
+enum class ParentOrderState {
+    Working,
+    Completed,
+    Cancelled,
+    Rejected,
+    Expired,
+};
+
+struct ParentOrderRequest {
+    std::string symbol;
+    ParentOrderSide side{ParentOrderSide::Buy};
+    double quantity{0.0};
+    ExecutionAlgoType algo{ExecutionAlgoType::Twap};
+    std::chrono::milliseconds duration{std::chrono::minutes(1)};
+    std::chrono::milliseconds sliceInterval{std::chrono::seconds(5)};
+    // Fraction of observed traded volume to take per slice (participation algo).
+    double participationRate{0.1};
+    // Upper bound on any single child order; zero disables the cap.
+    double maxChildQuantity{0.0};
+    std::optional<double> limitPrice;
+};
+
+struct ParentOrderStatus {
+    std::string parentId;
+    std::string symbol;
+    ParentOrderSide side{ParentOrderSide::Buy};
+    ExecutionAlgoType algo{ExecutionAlgoType::Twap};
+    ParentOrderState state{ParentOrderState::Working};
+    double targetQuantity{0.0};
+    double submittedQuantity{0.0};
+    double filledQuantity{0.0};
+    std::size_t childOrders{0};
+    std::string message;
+};
+
+// ExecutionAlgoEngine slices large parent orders into child OrderRequests that
+// are routed through a TradingEngine. Every child still passes the engine's
+// risk checks; a rejected child halts its parent. Slices are timers on a
+// common::TimerWheel, so there is no per-algo thread.
+class ExecutionAlgoEngine {
+public:
+    using ProgressCallback = std::function<void(const ParentOrderStatus&)>;
+
+    // Pass a shared, already running wheel to avoid a dedicated timer thread;
+    // otherwise the engine owns one and drives it between start() and stop().
+    explicit ExecutionAlgoEngine(TradingEngine& engine,
+                                 std::shared_ptr<common::TimerWheel> timers = nullptr);
+    ~ExecutionAlgoEngine();
+
+    ExecutionAlgoEngine(const ExecutionAlgoEngine&) = delete;
+    ExecutionAlgoEngine& operator=(const ExecutionAlgoEngine&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // Validates and schedules a parent order. The returned status carries the
+    // parent id on success or a Rejected state with the reason on failure.
+    ParentOrderStatus submit(const ParentOrderRequest& request);
+    bool cancel(const std::string& parentId);
+
+    std::optional<ParentOrderStatus> parentStatus(const std::string& parentId) const;
+
+    // Feeds the latest price and rolling 24h volume (quote currency, as in
+    // market_data::TokenQuote::volume_24h) used by the VWAP and participation
+    // algos to size slices.
+    void updateMarketData(const std::string& symbol, double price, double volume24h);
+
+    void subscribeToProgress(ProgressCallback callback);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct MarketSample {
+        double price{0.0};
+        double volume24h{0.0};
+    };
+
+    struct ParentOrder {
+        ParentOrderRequest request;
+        ParentOrderStatus status;
+        Clock::time_point startTime{};
+        Clock::time_point endTime{};
+        std::size_t slicesTotal{1};
+        std::size_t slicesElapsed{0};
+        std::optional<double> lastVolumeSample;
+        common::TimerWheel::TimerId sliceTimer{0};
+    };
+
+    struct ChildPlan {
+        std::string parentId;
+        ParentOrderSide side{ParentOrderSide::Buy};
+        OrderRequest request;
+    };
+
+    void runSlice(const std::string& parentId);
+    void scheduleSliceLocked(ParentOrder& parent, Clock::time_point due);
+    std::optional<ChildPlan> planSlice(const std::string& parentId,
+                                       Clock::time_point now,
+                                       std::optional<ParentOrderStatus>& finished);
+    double computeChildQuantity(ParentOrder& parent, Clock::time_point now);
+    void submitChild(const ChildPlan& plan);
+    void handleTradeUpdate(const TradeUpdate& update);
+    void applyFill(ParentOrder& parent, double quantity);
+    void notifyProgress(const ParentOrderStatus& status) const;
+
+    std::string generateParentId();
+
+    TradingEngine& engine_;
+    std::shared_ptr<std::atomic<bool>> aliveFlag_;
+
+    std::shared_ptr<common::TimerWheel> timers_;
+    bool ownsTimers_{false};
+
+    std::atomic<bool> running_{false};
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, ParentOrder> parents_;
+    std::unordered_map<std::string, std::string> childToParent_;
+    std::unordered_map<std::string, MarketSample> marketData_;
+
+    // Fills can race ahead of the child id being recorded when the engine
+    // routes a child before buy()/sell() returns; park them until matched.
+    std::size_t submissionsInFlight_{0};
+    std::unordered_map<std::string, double> unmatchedFills_;
+
+    mutable std::mutex callbacksMutex_;
+    std::vector<ProgressCallback> progressSubscribers_;
+
+    std::atomic<std::uint64_t> parentCounter_{0};
+};
+
+}  // namespace trading
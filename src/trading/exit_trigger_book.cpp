@@ -0,0 +1,203 @@
+#include "trading/exit_trigger_book.h"
+
+#include <utility>
+
+namespace trading {
+
+void ExitTriggerBook::add(Trigger trigger, double referencePrice) {
+    auto& book = books_[trigger.symbol];
+
+    Entry entry;
+    switch (trigger.type) {
+        case ExitTriggerType::StopLoss:
+            entry.stopLossIt = book.stopLosses.emplace(trigger.triggerPrice, trigger.triggerId);
+            break;
+        case ExitTriggerType::TakeProfit:
+            entry.takeProfitIt = book.takeProfits.emplace(trigger.triggerPrice, trigger.triggerId);
+            break;
+        case ExitTriggerType::TrailingStop: {
+            // Buckets below the latest mark are ratcheted on every update, so the
+            // reference price either matches an existing bucket or opens a new one.
+            auto [bucketIt, inserted] = book.trailingStops.try_emplace(referencePrice);
+            auto& bucket = bucketIt->second;
+            if (inserted) {
+                bucket.highWater = referencePrice;
+                bucket.stopIt = book.trailingByStop.end();
+            }
+            entry.trailingBucket = &bucket;
+            entry.trailingIt = bucket.byOffset.emplace(trigger.trailingOffset, trigger.triggerId);
+            if (entry.trailingIt == bucket.byOffset.begin()) {
+                refileTrailingBucket(book, bucket);
+            }
+            break;
+        }
+    }
+
+    const std::string triggerId = trigger.triggerId;
+    entry.trigger = std::move(trigger);
+    entries_[triggerId] = std::move(entry);
+}
+
+bool ExitTriggerBook::remove(const std::string& triggerId) {
+    auto entryIt = entries_.find(triggerId);
+    if (entryIt == entries_.end()) {
+        return false;
+    }
+
+    const Entry& entry = entryIt->second;
+    const std::string symbol = entry.trigger.symbol;
+    auto bookIt = books_.find(symbol);
+    if (bookIt != books_.end()) {
+        auto& book = bookIt->second;
+        switch (entry.trigger.type) {
+            case ExitTriggerType::StopLoss:
+                book.stopLosses.erase(entry.stopLossIt);
+                break;
+            case ExitTriggerType::TakeProfit:
+                book.takeProfits.erase(entry.takeProfitIt);
+                break;
+            case ExitTriggerType::TrailingStop: {
+                auto& bucket = *entry.trailingBucket;
+                const bool wasHighest = entry.trailingIt == bucket.byOffset.begin();
+                bucket.byOffset.erase(entry.trailingIt);
+                if (bucket.byOffset.empty()) {
+                    book.trailingByStop.erase(bucket.stopIt);
+                    book.trailingStops.erase(bucket.highWater);
+                } else if (wasHighest) {
+                    refileTrailingBucket(book, bucket);
+                }
+                break;
+            }
+        }
+    }
+
+    entries_.erase(entryIt);
+    eraseSymbolIfEmpty(symbol);
+    return true;
+}
+
+std::vector<ExitTriggerBook::FiredTrigger> ExitTriggerBook::onMarkPrice(const std::string& symbol,
+                                                                       double price) {
+    std::vector<FiredTrigger> fired;
+
+    auto bookIt = books_.find(symbol);
+    if (bookIt == books_.end()) {
+        return fired;
+    }
+    auto& book = bookIt->second;
+
+    const auto collect = [this, &fired](const std::string& triggerId, double stopLevel) {
+        auto entryIt = entries_.find(triggerId);
+        if (entryIt == entries_.end()) {
+            return;
+        }
+        FiredTrigger result;
+        result.trigger = std::move(entryIt->second.trigger);
+        result.stopLevel = stopLevel;
+        fired.push_back(std::move(result));
+        entries_.erase(entryIt);
+    };
+
+    // Stop-losses fire once the mark trades at or below the trigger.
+    const auto stopEnd = book.stopLosses.upper_bound(price);
+    for (auto it = book.stopLosses.begin(); it != stopEnd; ++it) {
+        collect(it->second, it->first);
+    }
+    book.stopLosses.erase(book.stopLosses.begin(), stopEnd);
+
+    // Take-profits fire once the mark trades at or above the trigger.
+    const auto takeEnd = book.takeProfits.upper_bound(price);
+    for (auto it = book.takeProfits.begin(); it != takeEnd; ++it) {
+        collect(it->second, it->first);
+    }
+    book.takeProfits.erase(book.takeProfits.begin(), takeEnd);
+
+    // Trailing stops fire when the mark falls offset or more below the high-water mark.
+    // Only buckets whose highest stop is at or above the mark are visited, and
+    // each of those fires at least its smallest offset.
+    ratchetTrailingStops(book, price);
+    while (!book.trailingByStop.empty() && book.trailingByStop.begin()->first >= price) {
+        auto& bucket = *book.trailingByStop.begin()->second;
+        auto it = bucket.byOffset.begin();
+        // Same expression as the filing key, so the first offset always fires.
+        while (it != bucket.byOffset.end() && bucket.highWater - it->first >= price) {
+            collect(it->second, bucket.highWater - it->first);
+            ++it;
+        }
+        bucket.byOffset.erase(bucket.byOffset.begin(), it);
+        if (bucket.byOffset.empty()) {
+            book.trailingByStop.erase(bucket.stopIt);
+            book.trailingStops.erase(bucket.highWater);
+        } else {
+            refileTrailingBucket(book, bucket);
+        }
+    }
+
+    eraseSymbolIfEmpty(symbol);
+    return fired;
+}
+
+std::size_t ExitTriggerBook::size() const {
+    return entries_.size();
+}
+
+std::size_t ExitTriggerBook::size(const std::string& symbol) const {
+    auto bookIt = books_.find(symbol);
+    if (bookIt == books_.end()) {
+        return 0;
+    }
+    const auto& book = bookIt->second;
+    std::size_t total = book.stopLosses.size() + book.takeProfits.size();
+    for (const auto& [highWater, bucket] : book.trailingStops) {
+        (void)highWater;
+        total += bucket.byOffset.size();
+    }
+    return total;
+}
+
+void ExitTriggerBook::ratchetTrailingStops(SymbolBook& book, double price) {
+    auto& index = book.trailingStops;
+    auto target = index.find(price);
+    auto it = index.begin();
+    while (it != index.end() && it->first < price) {
+        if (target == index.end()) {
+            // Common case: a single bucket moves up with the market. Re-keying the
+            // node keeps the bucket (and iterators into it) in place.
+            auto node = index.extract(it++);
+            node.key() = price;
+            node.mapped().highWater = price;
+            target = index.insert(std::move(node)).position;
+            refileTrailingBucket(book, target->second);
+            continue;
+        }
+
+        for (const auto& [offset, triggerId] : it->second.byOffset) {
+            (void)offset;
+            auto entryIt = entries_.find(triggerId);
+            if (entryIt != entries_.end()) {
+                entryIt->second.trailingBucket = &target->second;
+            }
+        }
+        book.trailingByStop.erase(it->second.stopIt);
+        target->second.byOffset.merge(it->second.byOffset);
+        it = index.erase(it);
+        refileTrailingBucket(book, target->second);
+    }
+}
+
+void ExitTriggerBook::refileTrailingBucket(SymbolBook& book, TrailingBucket& bucket) {
+    if (bucket.stopIt != book.trailingByStop.end()) {
+        book.trailingByStop.erase(bucket.stopIt);
+    }
+    const double highestStop = bucket.highWater - bucket.byOffset.begin()->first;
+    bucket.stopIt = book.trailingByStop.emplace(highestStop, &bucket);
+}
+
+void ExitTriggerBook::eraseSymbolIfEmpty(const std::string& symbol) {
+    auto bookIt = books_.find(symbol);
+    if (bookIt != books_.end() && bookIt->second.empty()) {
+        books_.erase(bookIt);
+    }
+}
+
+}  // namespace trading
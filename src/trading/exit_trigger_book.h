@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "trading/trading_engine.h"
+
+namespace trading {
+
+// ExitTriggerBook keeps stop-loss, take-profit and trailing-stop triggers in
+// price-sorted containers per symbol so that a mark update only touches the
+// triggers that actually fire. The book is not thread-safe; the owning engine
+// serialises access under its own mutex.
+class ExitTriggerBook {
+public:
+    struct Trigger {
+        std::string triggerId;
+        std::string symbol;
+        ExitTriggerType type{ExitTriggerType::StopLoss};
+        double quantity{0.0};
+        double triggerPrice{0.0};
+        double trailingOffset{0.0};
+        std::optional<double> limitPrice;
+    };
+
+    struct FiredTrigger {
+        Trigger trigger;
+        // Level that was crossed; for trailing stops this is the ratcheted stop.
+        double stopLevel{0.0};
+    };
+
+    // Adds a trigger. Trailing stops anchor their high-water mark at
+    // referencePrice (normally the latest mark for the symbol).
+    void add(Trigger trigger, double referencePrice);
+
+    // Removes a trigger by id. Returns false if the id is unknown.
+    bool remove(const std::string& triggerId);
+
+    // Applies a mark update and returns (and removes) every trigger that fired.
+    // Runs in O(log n + k) per trigger family, where k is the number fired,
+    // plus O(log n) for each trailing bucket the mark ratchets up.
+    std::vector<FiredTrigger> onMarkPrice(const std::string& symbol, double price);
+
+    std::size_t size() const;
+    std::size_t size(const std::string& symbol) const;
+
+private:
+    // Stop-losses are ordered highest first so the fired set is a prefix.
+    using StopLossIndex = std::multimap<double, std::string, std::greater<double>>;
+    using TakeProfitIndex = std::multimap<double, std::string>;
+    // Trailing stops sharing a high-water mark live in one bucket ordered by
+    // offset; a rising mark re-keys the bucket instead of every trigger.
+    using TrailingOffsets = std::multimap<double, std::string>;
+    struct TrailingBucket;
+    // Buckets filed by their highest stop (high-water minus smallest offset),
+    // highest first, so the buckets with something to fire are a prefix.
+    using TrailingStopIndex = std::multimap<double, TrailingBucket*, std::greater<double>>;
+    struct TrailingBucket {
+        // The bucket's key in TrailingIndex, kept here so entries pointing at
+        // the bucket can find it without storing the key themselves.
+        double highWater{0.0};
+        TrailingOffsets byOffset;
+        TrailingStopIndex::iterator stopIt;
+    };
+    using TrailingIndex = std::map<double, TrailingBucket>;
+
+    struct SymbolBook {
+        StopLossIndex stopLosses;
+        TakeProfitIndex takeProfits;
+        TrailingIndex trailingStops;
+        TrailingStopIndex trailingByStop;
+
+        bool empty() const {
+            return stopLosses.empty() && takeProfits.empty() && trailingStops.empty();
+        }
+    };
+
+    struct Entry {
+        Trigger trigger;
+        StopLossIndex::iterator stopLossIt;
+        TakeProfitIndex::iterator takeProfitIt;
+        TrailingBucket* trailingBucket{nullptr};
+        TrailingOffsets::iterator trailingIt;
+    };
+
+    void ratchetTrailingStops(SymbolBook& book, double price);
+    static void refileTrailingBucket(SymbolBook& book, TrailingBucket& bucket);
+    void eraseSymbolIfEmpty(const std::string& symbol);
+
+    std::unordered_map<std::string, SymbolBook> books_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace trading
@@ -5,12 +5,17 @@
 
 #include "common/logging.h"
 #include "market_data/pumpfun_client.h"
+#include "market_data/pumpfun_stream_client.h"
 
 namespace trading {
 
 PumpFunMarketDataBridge::PumpFunMarketDataBridge(market_data::PumpFunClient& client,
                                                  TradingEngine& engine)
-    : client_(client), engine_(engine) {}
+    : client_(&client), engine_(engine) {}
+
+PumpFunMarketDataBridge::PumpFunMarketDataBridge(market_data::PumpFunStreamClient& stream,
+                                                 TradingEngine& engine)
+    : stream_(&stream), engine_(engine) {}
 
 PumpFunMarketDataBridge::~PumpFunMarketDataBridge() {
     stop();
@@ -29,16 +34,10 @@ void PumpFunMarketDataBridge::start(const std::vector<std::string>& symbols,
 
     for (const auto& symbol : symbols) {
         try {
-            const auto id = client_.subscribeToQuotes(
-                symbol,
-                [this](const market_data::TokenQuote& quote) {
-                    if (quote.price <= 0.0) {
-                        LOG_WARN("Received non-positive Pump.fun price for " + quote.mint);
-                        return;
-                    }
-                    engine_.updateMarkPrice(quote.mint, quote.price);
-                },
-                interval);
+            auto callback = [this](const market_data::TokenQuote& quote) { applyQuote(quote); };
+            const auto id = stream_ != nullptr
+                                ? stream_->subscribeToQuotes(symbol, std::move(callback))
+                                : client_->subscribeToQuotes(symbol, std::move(callback), interval);
             newSubscriptions.emplace(symbol, id);
         } catch (const std::exception& ex) {
             LOG_ERROR(std::string("Failed to subscribe to Pump.fun quotes for ") + symbol +
@@ -80,8 +79,20 @@ void PumpFunMarketDataBridge::clearSubscriptions() {
 
     for (const auto& [symbol, id] : local) {
         (void)symbol;
-        client_.unsubscribe(id);
+        if (stream_ != nullptr) {
+            stream_->unsubscribe(id);
+        } else {
+            client_->unsubscribe(id);
+        }
+    }
+}
+
+void PumpFunMarketDataBridge::applyQuote(const market_data::TokenQuote& quote) {
+    if (quote.price <= 0.0) {
+        LOG_WARN("Received non-positive Pump.fun price for " + quote.mint);
+        return;
     }
+    engine_.updateMarkPrice(quote.mint, quote.price);
 }
 
 }  // namespace trading
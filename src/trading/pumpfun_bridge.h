@@ -12,6 +12,7 @@
 
 namespace market_data {
 class PumpFunClient;
+class PumpFunStreamClient;
 struct TokenQuote;
 }  // namespace market_data
 
@@ -20,6 +21,8 @@ namespace trading {
 class PumpFunMarketDataBridge {
 public:
     PumpFunMarketDataBridge(market_data::PumpFunClient& client, TradingEngine& engine);
+    // Streams marks over a WebSocket instead of polling; interval is ignored.
+    PumpFunMarketDataBridge(market_data::PumpFunStreamClient& stream, TradingEngine& engine);
     ~PumpFunMarketDataBridge();
 
     void start(const std::vector<std::string>& symbols,
@@ -30,8 +33,10 @@ public:
 
 private:
     void clearSubscriptions();
+    void applyQuote(const market_data::TokenQuote& quote);
 
-    market_data::PumpFunClient& client_;
+    market_data::PumpFunClient* client_{nullptr};
+    market_data::PumpFunStreamClient* stream_{nullptr};
     TradingEngine& engine_;
 
     std::atomic<bool> running_{false};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <optional>
 #include <string>
@@ -12,10 +13,26 @@ struct RiskLimits {
     double maxExposure{0.0};
 };
 
+enum class TimeInForce {
+    // Rests until filled or cancelled.
+    GoodTillCancel,
+    // Fills what it can against the mark and risk limits; the rest is cancelled.
+    ImmediateOrCancel,
+    // Fills in full against the mark or is cancelled without a partial fill.
+    FillOrKill,
+    // Like GoodTillCancel, but expires at OrderRequest::goodTill.
+    GoodTillTime,
+};
+
 struct OrderRequest {
     std::string symbol;
     double quantity{0.0};
     std::optional<double> limitPrice;
+    TimeInForce timeInForce{TimeInForce::GoodTillCancel};
+    std::optional<std::chrono::system_clock::time_point> goodTill{};
+    // Caller-assigned id; a resubmission with an id the engine has recently
+    // accepted is rejected instead of routed twice.
+    std::optional<std::string> clientOrderId{};
 };
 
 struct OrderReceipt {
@@ -35,6 +52,8 @@ struct TradeUpdate {
     std::string orderId;
     std::string message;
     bool success{false};
+    // Quantity executed by this update; zero for acceptances and rejections.
+    double filledQuantity{0.0};
 };
 
 struct AlertUpdate {
@@ -42,6 +61,29 @@ struct AlertUpdate {
     std::string body;
 };
 
+enum class ExitTriggerType {
+    StopLoss,
+    TakeProfit,
+    TrailingStop,
+};
+
+struct ExitTriggerRequest {
+    std::string symbol;
+    ExitTriggerType type{ExitTriggerType::StopLoss};
+    double quantity{0.0};
+    // Mark price that fires stop-loss and take-profit triggers.
+    double triggerPrice{0.0};
+    // Distance below the highest mark seen since attachment for trailing stops.
+    double trailingOffset{0.0};
+    std::optional<double> limitPrice;
+};
+
+struct ExitTriggerReceipt {
+    bool success{false};
+    std::string message;
+    std::string triggerId;
+};
+
 class TradingEngine {
 public:
     using TradeCallback = std::function<void(const TradeUpdate&)>;
@@ -55,13 +97,23 @@ public:
     virtual bool isRunning() const = 0;
 
     virtual void updateRiskLimits(const RiskLimits& limits) = 0;
+    virtual RiskLimits riskLimits() const = 0;
 
     virtual OrderReceipt buy(const OrderRequest& request) = 0;
     virtual OrderReceipt sell(const OrderRequest& request) = 0;
     virtual StatusReport status(const std::optional<std::string>& symbol) const = 0;
 
+    // Cancels an open (queued or resting) order.
+    virtual OrderReceipt cancelOrder(const std::string& orderId) = 0;
+    // Amends the quantity, limit price and time-in-force of an open order in
+    // place. The symbol and side are fixed and the order keeps its id.
+    virtual OrderReceipt replaceOrder(const std::string& orderId, const OrderRequest& request) = 0;
+
     virtual void updateMarkPrice(const std::string& symbol, double price) = 0;
 
+    virtual ExitTriggerReceipt attachExitTrigger(const ExitTriggerRequest& request) = 0;
+    virtual bool cancelExitTrigger(const std::string& triggerId) = 0;
+
     virtual void subscribeToTradeUpdates(TradeCallback callback) = 0;
     virtual void subscribeToAlerts(AlertCallback callback) = 0;
     virtual void subscribeToStatusUpdates(StatusCallback callback) = 0;
@@ -35,6 +35,13 @@ TradingImGuiApp::TradingImGuiApp() : rng_(std::random_device{}()) {
         std::lock_guard<std::mutex> lock(data_mutex_);
         price_history_.push_back(static_cast<float>(last_price_));
     }
+
+    frame_timers_.scheduleEvery(kSyntheticTickInterval, [this]() { updateSyntheticMarketData(); });
+    frame_timers_.scheduleEvery(status_poll_interval_, [this]() {
+        if (auto_status_refresh_) {
+            refreshStatusFromEngine();
+        }
+    });
 }
 
 TradingImGuiApp::~TradingImGuiApp() { alive_.store(false); }
@@ -83,8 +90,10 @@ void TradingImGuiApp::render() {
         return;
     }
 
-    updateSyntheticMarketData();
-    refreshStatusFromEngine();
+    frame_timers_.advance();
+    if (manual_status_request_.exchange(false)) {
+        refreshStatusFromEngine();
+    }
 
     auto snapshot = buildDashboardSnapshot();
     snapshot.has_engine = static_cast<bool>(engine_);
@@ -179,7 +188,6 @@ void TradingImGuiApp::renderStatusSection(const DashboardSnapshot& snapshot) {
 
     ImGui::SameLine();
     if (ImGui::Button("Refresh Snapshot")) {
-        manual_status_request_.store(true);
         refreshStatusFromEngine();
     }
 
@@ -603,31 +611,10 @@ void TradingImGuiApp::refreshStatusFromEngine() {
         return;
     }
 
-    const bool manual_request = manual_status_request_.exchange(false);
-    if (!auto_status_refresh_ && !manual_request) {
-        return;
-    }
-
-    const auto now = std::chrono::steady_clock::now();
-    if (!manual_request && last_status_fetch_.time_since_epoch().count() != 0 &&
-        now - last_status_fetch_ < status_poll_interval_) {
-        return;
-    }
-
-    last_status_fetch_ = now;
     handleStatusUpdate(engine->status(std::nullopt));
 }
 
 void TradingImGuiApp::updateSyntheticMarketData() {
-    const auto now = std::chrono::steady_clock::now();
-    if (last_market_tick_.time_since_epoch().count() == 0) {
-        last_market_tick_ = now;
-    }
-    if (now - last_market_tick_ < kSyntheticTickInterval) {
-        return;
-    }
-    last_market_tick_ = now;
-
     std::lock_guard<std::mutex> lock(data_mutex_);
 
     if (price_history_.empty()) {
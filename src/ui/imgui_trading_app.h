@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "common/timer_wheel.h"
 #include "trading/trading_engine.h"
 #include "ui/imgui_helpers.h"
 
@@ -167,9 +168,9 @@ private:
     std::deque<std::string> log_messages_;
     std::size_t max_log_messages_ = 200;
 
-    std::chrono::steady_clock::time_point last_market_tick_{};
-    std::chrono::steady_clock::time_point last_status_fetch_{};
     std::chrono::milliseconds status_poll_interval_{std::chrono::milliseconds(750)};
+    // Advanced from render() so periodic UI work runs on the frame loop.
+    common::TimerWheel frame_timers_;
 
     std::atomic<bool> manual_status_request_{false};
     bool auto_status_refresh_ = true;
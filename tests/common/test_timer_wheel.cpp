@@ -0,0 +1,122 @@
+#include "common/timer_wheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = common::TimerWheel::Clock;
+using std::chrono::milliseconds;
+
+bool Expect(bool condition, const char* message) {
+    if (!condition) {
+        std::cerr << message << std::endl;
+    }
+    return condition;
+}
+
+bool TestOneShotOrderingAndCancel() {
+    common::TimerWheel wheel(milliseconds(10));
+    const auto start = Clock::now();
+
+    std::vector<int> fired;
+    wheel.schedule(milliseconds(30), [&fired]() { fired.push_back(30); });
+    wheel.schedule(milliseconds(10), [&fired]() { fired.push_back(10); });
+    const auto cancelled = wheel.schedule(milliseconds(20), [&fired]() { fired.push_back(20); });
+
+    if (!Expect(wheel.cancel(cancelled), "Failed to cancel a pending timer")) {
+        return false;
+    }
+    if (!Expect(!wheel.cancel(cancelled), "Cancelled the same timer twice")) {
+        return false;
+    }
+
+    wheel.advance(start + milliseconds(25));
+    if (!Expect(fired.size() == 1 && fired.front() == 10, "Timer fired out of order or early")) {
+        return false;
+    }
+
+    wheel.advance(start + milliseconds(60));
+    return Expect(fired.size() == 2 && fired.back() == 30, "Later timer did not fire") &&
+           Expect(wheel.pendingTimers() == 0, "Fired timers remained pending");
+}
+
+bool TestCascadingLongTimers() {
+    common::TimerWheel wheel(milliseconds(10));
+    const auto start = Clock::now();
+
+    bool fiveSeconds = false;
+    bool oneHour = false;
+    wheel.schedule(milliseconds(5000), [&fiveSeconds]() { fiveSeconds = true; });
+    wheel.schedule(std::chrono::hours(1), [&oneHour]() { oneHour = true; });
+
+    wheel.advance(start + milliseconds(4980));
+    if (!Expect(!fiveSeconds, "Five second timer fired early")) {
+        return false;
+    }
+    wheel.advance(start + milliseconds(5020));
+    if (!Expect(fiveSeconds, "Five second timer did not fire after cascading")) {
+        return false;
+    }
+
+    wheel.advance(start + std::chrono::minutes(59));
+    if (!Expect(!oneHour, "One hour timer fired early")) {
+        return false;
+    }
+    wheel.advance(start + std::chrono::hours(1) + milliseconds(20));
+    return Expect(oneHour, "One hour timer did not fire after cascading");
+}
+
+bool TestPeriodicTimerCanCancelItself() {
+    common::TimerWheel wheel(milliseconds(10));
+    const auto start = Clock::now();
+
+    int runs = 0;
+    common::TimerWheel::TimerId id = 0;
+    id = wheel.scheduleEvery(milliseconds(10), [&]() {
+        if (++runs == 5) {
+            wheel.cancel(id);
+        }
+    });
+
+    for (int step = 1; step <= 20; ++step) {
+        wheel.advance(start + milliseconds(10 * step + 5));
+    }
+    return Expect(runs == 5, "Periodic timer did not stop after cancelling itself");
+}
+
+bool TestDriverThread() {
+    common::TimerWheel wheel(milliseconds(5));
+    wheel.start();
+
+    std::atomic<bool> fired{false};
+    wheel.schedule(milliseconds(20), [&fired]() { fired.store(true); });
+
+    const auto deadline = Clock::now() + milliseconds(500);
+    while (!fired.load() && Clock::now() < deadline) {
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    wheel.stop();
+    return Expect(fired.load(), "Driver thread did not fire the timer");
+}
+
+}  // namespace
+
+int main() {
+    if (!TestOneShotOrderingAndCancel()) {
+        return 1;
+    }
+    if (!TestCascadingLongTimers()) {
+        return 1;
+    }
+    if (!TestPeriodicTimerCanCancelItself()) {
+        return 1;
+    }
+    if (!TestDriverThread()) {
+        return 1;
+    }
+    return 0;
+}
@@ -1,11 +1,28 @@
 #include "market_data/pumpfun_client.h"
+#include "market_data/json_cursor.h"
+#include "market_data/mint_key.h"
+#include "market_data/pumpfun_stream_client.h"
+#include "market_data/receive_buffer.h"
+#include "market_data/response_parser.h"
+#include "testing/mock_http_server.h"
+#include "testing/mock_pumpfun_api.h"
+#include "testing/mock_websocket_server.h"
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -145,17 +162,1994 @@ bool TestMetadataParsing() {
   return true;
 }
 
-int main() {
-  if (!TestUrlBuilder()) {
-    return 1;
+constexpr std::int64_t kSecondNs = 1'000'000'000;
+// 2026-10-18T12:00:00Z
+constexpr std::int64_t kNoonNs = 1792324800 * kSecondNs;
+
+bool TestTimestampParsing() {
+  const std::vector<std::pair<std::string, std::int64_t>> cases = {
+      {"2026-10-18T12:00:00Z", kNoonNs},
+      {"2026-10-18T12:00:00.123456789Z", kNoonNs + 123456789},
+      {"2026-10-18 14:30:00+02:30", kNoonNs},
+      {"2026-10-18T07:00:00-0500", kNoonNs},
+      {"2026-10-18T12:00", kNoonNs},
+      {"2026-10-18", kNoonNs - 12 * 3600 * kSecondNs},
+      {"1792324800", kNoonNs},
+      {"1792324800.25", kNoonNs + kSecondNs / 4},
+      {"1792324800000", kNoonNs},
+      {"1792324800000000", kNoonNs},
+      {"1792324800000000001", kNoonNs + 1},
+      {"2024-02-29T00:00:00Z", 1709164800 * kSecondNs},
+  };
+  for (const auto& [text, expected] : cases) {
+    market_data::TimestampNs parsed = 0;
+    if (!market_data::parseTimestamp(text, parsed) || parsed != expected) {
+      std::cerr << "Timestamp " << text << " parsed to " << parsed << ", expected " << expected
+                << std::endl;
+      return false;
+    }
   }
-  if (!TestRetriesSucceed()) {
-    return 1;
+  // The last five are past the int64 nanosecond range (1677 to 2262).
+  for (const std::string invalid :
+       {"", "soon", "2026-13-01T00:00:00Z", "2026-02-29", "2026-10-18T25:00:00Z",
+        "2026-10-18T12:00:00Q", "-5", "99999999999", "50000000000000", "90000000000000000",
+        "2263-01-01T00:00:00Z", "1677-01-01"}) {
+    market_data::TimestampNs parsed = 0;
+    if (market_data::parseTimestamp(invalid, parsed)) {
+      std::cerr << "Invalid timestamp accepted: " << invalid << std::endl;
+      return false;
+    }
   }
-  if (!TestRetriesExhaust()) {
-    return 1;
+  if (market_data::formatTimestamp(kNoonNs + 5'000'000) != "2026-10-18T12:00:00.005Z" ||
+      market_data::timestampFromEpoch(1792324800.5) != kNoonNs + kSecondNs / 2 ||
+      market_data::timestampFromEpoch(5e10) != 0 || market_data::timestampFromEpoch(5e13) != 0 ||
+      market_data::timestampFromEpoch(9e16) != 0) {
+    std::cerr << "Timestamp formatting or epoch conversion is wrong" << std::endl;
+    return false;
   }
-  if (!TestMetadataParsing()) {
+  return true;
+}
+
+market_data::TokenQuote DomQuote(const std::string& payload) {
+  nlohmann::json json = payload.empty() ? nlohmann::json::object() : nlohmann::json::parse(payload);
+  if (json.contains("result")) {
+    json = json["result"];
+  }
+  if (json.contains("data") && json["data"].is_object()) {
+    json = json["data"];
+  }
+  if (json.is_array() && !json.empty()) {
+    json = json.front();
+  }
+  return market_data::PumpFunClient::parseTokenQuote(json);
+}
+
+std::unordered_map<std::string, market_data::TokenQuote> DomBatchQuotes(
+    const std::string& payload,
+    const std::vector<std::string>& token_mints) {
+  nlohmann::json json = payload.empty() ? nlohmann::json::object() : nlohmann::json::parse(payload);
+  for (const char* wrapper : {"result", "data", "quotes"}) {
+    if (json.contains(wrapper)) {
+      json = json[wrapper];
+    }
+  }
+  std::unordered_map<std::string, market_data::TokenQuote> quotes;
+  if (json.is_array()) {
+    for (const auto& entry : json) {
+      auto quote = market_data::PumpFunClient::parseTokenQuote(entry);
+      if (!quote.mint.empty()) {
+        quotes.insert_or_assign(quote.mint, quote);
+      }
+    }
+  } else if (json.is_object()) {
+    for (const auto& mint : token_mints) {
+      if (json.contains(mint)) {
+        auto quote = market_data::PumpFunClient::parseTokenQuote(json[mint]);
+        if (quote.mint.empty()) {
+          quote.mint = mint;
+        }
+        quotes.insert_or_assign(mint, quote);
+      }
+    }
+  }
+  return quotes;
+}
+
+bool TestMintKey() {
+  const std::string wrapped_sol = "So11111111111111111111111111111111111111112";
+  const auto key = market_data::MintKey::fromBase58(wrapped_sol);
+  if (key.bytes()[0] != 0x06 || key.bytes()[1] != 0x9b || key.bytes()[31] != 0x01 ||
+      key.toBase58() != wrapped_sol) {
+    std::cerr << "MintKey did not decode or re-encode " << wrapped_sol << std::endl;
+    return false;
+  }
+  market_data::MintKey zero;
+  if (!market_data::MintKey::tryParse("11111111111111111111111111111111", zero) ||
+      zero != market_data::MintKey() || zero.toBase58() != "11111111111111111111111111111111") {
+    std::cerr << "MintKey mishandled leading zero bytes" << std::endl;
+    return false;
+  }
+  for (const std::string mint : {"EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v",
+                                 "6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P"}) {
+    market_data::MintKey parsed;
+    if (!market_data::MintKey::tryParse(mint, parsed) || parsed.toBase58() != mint ||
+        parsed == key) {
+      std::cerr << "MintKey did not round-trip " << mint << std::endl;
+      return false;
+    }
+  }
+  // Not base58, too short, leading '1's that make it 33 bytes, too long.
+  for (const std::string invalid : {"", "MINT0", "abc", "1So11111111111111111111111111111111111111112",
+                                    "So111111111111111111111111111111111111111112"}) {
+    market_data::MintKey parsed = key;
+    if (market_data::MintKey::tryParse(invalid, parsed) || parsed != key) {
+      std::cerr << "MintKey accepted " << invalid << std::endl;
+      return false;
+    }
+  }
+  bool threw = false;
+  try {
+    market_data::MintKey::fromBase58("MINTA");
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+
+  market_data::TokenQuote quote;
+  quote.mint = wrapped_sol;
+  quote.price = 1.5;
+  quote.liquidity = 7;
+  quote.timestamp_ns = kNoonNs;
+  market_data::CompactQuote compact;
+  std::unordered_map<market_data::MintKey, int> by_mint{{key, 1}};
+  if (!threw || !market_data::CompactQuote::fromQuote(quote, compact) || compact.mint != key ||
+      by_mint.count(compact.mint) != 1 || compact.toQuote().mint != wrapped_sol ||
+      compact.toQuote().price != 1.5 || compact.toQuote("x").timestamp_ns != kNoonNs) {
+    std::cerr << "CompactQuote conversion is wrong" << std::endl;
+    return false;
+  }
+  quote.mint = "MINTA";
+  if (market_data::CompactQuote::fromQuote(quote, compact) || compact.price != 1.5) {
+    std::cerr << "CompactQuote accepted a non-address mint" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestOnDemandParsing() {
+  // The on-demand parser must agree with the DOM path on every shape it accepts.
+  const std::vector<std::string> quotes = {
+      "",
+      R"({"mint":"A","price":1.5,"priceChange24h":-2,"volume24h":10,"liquidity":7,"timestamp":"2026-10-18T12:00:00Z"})",
+      R"({"result":{"data":{"address":"B","priceUsd":2.5e-3,"volume":3,"updatedAt":1792324800}}})",
+      R"({"data":[{"mint":"C","usdPrice":3}],"extra":{"nested":[1,{"x":null}],"flag":true}})",
+      R"([{"mint":"D","price":"not a number","priceUsd":4,"timestamp":"soon","time":"1792324800123"},{"mint":"E"}])",
+      R"({"price":1,"price":2,"usdPrice":3,"priceUsd":"x","mint":"F\/G\"H"})",
+      R"({"result":null,"mint":"ignored"})",
+      R"({"data":"text","mint":"I","liquidityUsd":9,"liquidity":null})",
+      R"(  {"mint" : "J" , "price_change_24h" : 1E2 , "volume_24h" : 0.5 }  )",
+  };
+  for (const auto& payload : quotes) {
+    const auto expected = DomQuote(payload);
+    const auto actual = market_data::parseQuoteResponse(payload);
+    if (actual.mint != expected.mint || actual.price != expected.price ||
+        actual.price_change_24h != expected.price_change_24h ||
+        actual.volume_24h != expected.volume_24h || actual.liquidity != expected.liquidity ||
+        actual.timestamp_ns != expected.timestamp_ns) {
+      std::cerr << "On-demand quote parse disagrees with DOM path for " << payload << std::endl;
+      return false;
+    }
+  }
+
+  const std::vector<std::string> batches = {
+      "",
+      R"([{"mint":"A","price":1},{"price":2},{"address":"B","priceUsd":3,"timestamp":1792324800}])",
+      R"({"result":{"data":{"quotes":[{"mint":"C","volume24h":4}]}}})",
+      R"({"data":{"A":{"price":5},"B":{"mint":"other","liquidity":6},"Z":{"price":7}}})",
+      R"({"quotes":{"A":{"usdPrice":8,"updatedAt":"2026-10-18T12:00:00Z"}},"next":null})",
+      R"({"data":null})",
+  };
+  for (const auto& payload : batches) {
+    const auto expected = DomBatchQuotes(payload, {"A", "B"});
+    market_data::FieldLayoutCache layout;
+    const auto actual = market_data::parseBatchQuoteResponse(payload, {"A", "B"}, &layout);
+    bool same = actual.size() == expected.size();
+    for (const auto& [mint, quote] : expected) {
+      const auto it = actual.find(mint);
+      same = same && it != actual.end() && it->second.mint == quote.mint &&
+             it->second.price == quote.price && it->second.volume_24h == quote.volume_24h &&
+             it->second.liquidity == quote.liquidity &&
+             it->second.timestamp_ns == quote.timestamp_ns;
+    }
+    if (!same) {
+      std::cerr << "On-demand batch parse disagrees with DOM path for " << payload << std::endl;
+      return false;
+    }
+  }
+
+  const auto escaped = market_data::parseQuoteResponse(R"({"mint":"caf\u00e9 \ud83d\ude80"})");
+  if (escaped.mint != "caf\xc3\xa9 \xf0\x9f\x9a\x80") {
+    std::cerr << "Unicode escapes were not decoded: " << escaped.mint << std::endl;
+    return false;
+  }
+
+  const auto candles = market_data::parseCandlesResponse(
+      R"({"result":{"candles":[{"startTime":"2026-10-18T12:00:00Z","closeTime":"2026-10-18T12:01:00Z","open":1,"high":2,"low":0.5,"close":1.5,"volumeUsd":9,"quoteVolume":3},7,{"time":1792324920,"open_time":true}]}})",
+      "MINT", "1m");
+  if (candles.size() != 3 || candles[0].open_time_ns != kNoonNs ||
+      candles[0].close_time_ns != kNoonNs + 60 * kSecondNs || candles[0].high != 2 ||
+      candles[0].volume != 9 || candles[0].quote_volume != 3 || candles[1].mint != "MINT" ||
+      candles[1].open != 0 || candles[2].open_time_ns != kNoonNs + 120 * kSecondNs ||
+      candles[2].timeframe != "1m") {
+    std::cerr << "On-demand candle parse returned unexpected candles" << std::endl;
+    return false;
+  }
+  if (!market_data::parseCandlesResponse(R"({"data":null})", "MINT", "1m").empty()) {
+    std::cerr << "Null candle payload should yield no candles" << std::endl;
+    return false;
+  }
+
+  for (const std::string malformed : {R"({"mint":"A",})", R"({"mint":"A"} trailing)",
+                                      R"([1,2)", R"({"mint" "A"})", R"({"price":-})"}) {
+    try {
+      market_data::parseQuoteResponse(malformed);
+      std::cerr << "Malformed payload was accepted: " << malformed << std::endl;
+      return false;
+    } catch (const market_data::JsonParseError&) {
+    }
+  }
+  return true;
+}
+
+bool TestFieldLayoutCache() {
+  market_data::FieldLayoutCache layout;
+  const std::string usd_layout =
+      R"([{"startTime":"2026-10-18T12:00:00Z","open":1,"high":2,"low":1,"close":2,"volumeUsd":5},)"
+      R"({"startTime":"2026-10-18T12:01:00Z","open":2,"high":3,"low":2,"close":3,"volumeUsd":6}])";
+  auto candles = market_data::parseCandlesResponse(usd_layout, "MINT", "1m", &layout);
+  candles = market_data::parseCandlesResponse(usd_layout, "MINT", "1m", &layout);
+  if (layout.detections() != 1 || candles.size() != 2 ||
+      candles[1].open_time_ns != kNoonNs + 60 * kSecondNs ||
+      candles[1].volume != 6 || candles[1].high != 3) {
+    std::cerr << "Candle layout was not detected once and reused (" << layout.detections()
+              << " detections)" << std::endl;
+    return false;
+  }
+
+  // A provider switching aliases is picked up by re-detection.
+  candles = market_data::parseCandlesResponse(
+      R"([{"open_time":1792324800000,"open":4,"high":5,"low":4,"close":5,"volume":7}])", "MINT",
+      "1m", &layout);
+  if (layout.detections() != 2 || candles[0].open_time_ns != kNoonNs || candles[0].volume != 7) {
+    std::cerr << "Changed candle layout was not re-detected" << std::endl;
+    return false;
+  }
+
+  // Records that miss an expected field or add a new one fall back to detection.
+  candles = market_data::parseCandlesResponse(
+      R"([{"open_time":1792324800,"open":4,"low":4,"close":5,"volume":7},)"
+      R"({"open_time":1792324800,"open":4,"high":6,"low":4,"close":5,"volume":7,"quoteVolume":8}])",
+      "MINT", "1m", &layout);
+  if (layout.detections() != 4 || candles[0].high != 0 || candles[1].high != 6 ||
+      candles[1].quote_volume != 8) {
+    std::cerr << "Candles that did not fit the layout were misparsed (" << layout.detections()
+              << " detections)" << std::endl;
+    return false;
+  }
+
+  market_data::FieldLayoutCache quote_layout;
+  for (int i = 0; i < 3; ++i) {
+    const auto quote = market_data::parseQuoteResponse(
+        R"({"data":{"address":"Q","usdPrice":)" + std::to_string(i) + R"(,"time":1792324800}})",
+        &quote_layout);
+    if (quote.mint != "Q" || quote.price != i || quote.timestamp_ns != kNoonNs) {
+      std::cerr << "Quote parsed through the cached layout is wrong" << std::endl;
+      return false;
+    }
+  }
+  if (quote_layout.detections() != 1) {
+    std::cerr << "Quote layout was re-detected for identical records" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestConnectionReuse() {
+  testing::MockHttpServer server([](const testing::MockHttpServer::Request&) {
+    testing::MockHttpServer::Response response;
+    response.body = R"({"mint":"TOKEN","price":2.5,"liquidity":10})";
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+
+  try {
+    for (int i = 0; i < 5; ++i) {
+      client.fetchTokenQuote("TOKEN");
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << "fetchTokenQuote against mock server threw: " << ex.what() << std::endl;
+    return false;
+  }
+
+  const auto stats = client.connectionStats();
+  if (stats.requests != 5 || stats.new_connections != 1 || stats.reused_connections != 4) {
+    std::cerr << "Expected 1 new and 4 reused connections but saw " << stats.new_connections
+              << " new and " << stats.reused_connections << " reused" << std::endl;
+    return false;
+  }
+  if (server.acceptedConnections() != 1) {
+    std::cerr << "Server accepted " << server.acceptedConnections() << " connections" << std::endl;
+    return false;
+  }
+
+  // With one connection per host, concurrent pollers queue on the same socket.
+  client.setMaxConnectionsPerHost(1);
+  std::atomic<int> failures{0};
+  std::vector<std::thread> pollers;
+  for (int t = 0; t < 4; ++t) {
+    pollers.emplace_back([&client, &failures]() {
+      for (int i = 0; i < 3; ++i) {
+        try {
+          client.fetchTokenQuote("TOKEN");
+        } catch (const std::exception&) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& poller : pollers) {
+    poller.join();
+  }
+
+  if (failures.load() != 0 || server.acceptedConnections() != 1) {
+    std::cerr << "Per-host limit not honoured: " << failures.load() << " failures, "
+              << server.acceptedConnections() << " connections" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestEventLoopSubscriptions() {
+  std::mutex served_mutex;
+  std::unordered_map<std::string, int> served;
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    testing::MockHttpServer::Response response;
+    {
+      std::lock_guard<std::mutex> lock(served_mutex);
+      // Fail each mint's first request once to exercise the retry timer.
+      if (served[mint]++ == 0) {
+        response.status = 503;
+        return response;
+      }
+    }
+    response.body = R"({"mint":")" + mint + R"(","price":1.5})";
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setRetryPolicy(2, std::chrono::milliseconds(5));
+
+  constexpr int kMints = 20;
+  std::vector<std::atomic<int>> quotes(kMints);
+  std::vector<market_data::PumpFunClient::SubscriptionId> ids;
+  for (int i = 0; i < kMints; ++i) {
+    ids.push_back(client.subscribeToQuotes(
+        "MINT" + std::to_string(i),
+        [&quotes, i](const market_data::TokenQuote& quote) {
+          if (quote.mint == "MINT" + std::to_string(i) && std::abs(quote.price - 1.5) < 1e-9) {
+            ++quotes[i];
+          }
+        },
+        std::chrono::milliseconds(20)));
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+  bool all_polled = false;
+  while (!all_polled && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    all_polled = true;
+    for (const auto& count : quotes) {
+      all_polled = all_polled && count.load() >= 2;
+    }
+  }
+  if (!all_polled) {
+    std::cerr << "Event loop did not deliver quotes for every subscription" << std::endl;
+    return false;
+  }
+
+  for (const auto id : ids) {
+    client.unsubscribe(id);
+  }
+  int total = 0;
+  for (const auto& count : quotes) {
+    total += count.load();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  int after = 0;
+  for (const auto& count : quotes) {
+    after += count.load();
+  }
+  if (after != total) {
+    std::cerr << "Quotes delivered after unsubscribe" << std::endl;
+    return false;
+  }
+
+  // Polls share a handful of keep-alive connections instead of one per mint.
+  if (server.acceptedConnections() > 4) {
+    std::cerr << "Event loop opened " << server.acceptedConnections() << " connections" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestSubscriptionsShareMintPoll() {
+  std::atomic<int> served{0};
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    if (request.target.find("/SHARED") != std::string::npos) {
+      ++served;
+    }
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    response.body = R"({"mint":")" + mint + R"(","price":2.5})";
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  std::atomic<int> fast{0};
+  std::atomic<int> slow{0};
+  std::atomic<int> slowest{0};
+  const auto fast_id = client.subscribeToQuotes(
+      "SHARED", [&fast](const market_data::TokenQuote&) { ++fast; }, std::chrono::milliseconds(40));
+  const auto slow_id = client.subscribeToQuotes(
+      "SHARED", [&slow](const market_data::TokenQuote&) { ++slow; }, std::chrono::milliseconds(200));
+  const auto slowest_id = client.subscribeToQuotes(
+      "SHARED", [&slowest](const market_data::TokenQuote&) { ++slowest; },
+      std::chrono::milliseconds(400));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  // Every upstream poll fans out to all three listeners at the fastest pace.
+  const int polled = served.load();
+  if (polled < 5 || std::abs(fast.load() - polled) > 1 || std::abs(fast.load() - slow.load()) > 1 ||
+      std::abs(slow.load() - slowest.load()) > 1) {
+    std::cerr << "Listeners did not share one upstream poll (served " << polled << ", fast "
+              << fast.load() << ", slow " << slow.load() << ", slowest " << slowest.load() << ")"
+              << std::endl;
+    return false;
+  }
+
+  // With the fastest listener gone the poll slows to the next smallest interval.
+  client.unsubscribe(fast_id);
+  const int before_slowdown = served.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  const int slowed = served.load() - before_slowdown;
+  if (slowed < 1 || slowed > 3) {
+    std::cerr << "Poll did not slow to the remaining minimum interval (" << slowed << " polls)"
+              << std::endl;
+    return false;
+  }
+
+  client.unsubscribe(slow_id);
+  client.unsubscribe(slowest_id);
+  const int after_last = served.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  if (served.load() > after_last + 1) {
+    std::cerr << "Upstream polling continued after the last listener left" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestBatchQuotes() {
+  std::atomic<int> batch_requests{0};
+  std::atomic<int> single_requests{0};
+  std::atomic<int> largest_batch{0};
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    const std::string marker = "/quotes/batch?addresses=";
+    const auto query = request.target.find(marker);
+    if (query == std::string::npos) {
+      ++single_requests;
+      const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+      response.body = R"({"mint":")" + mint + R"(","price":1.0})";
+      return response;
+    }
+
+    ++batch_requests;
+    std::string addresses = request.target.substr(query + marker.size());
+    for (auto pos = addresses.find("%2C"); pos != std::string::npos; pos = addresses.find("%2C")) {
+      addresses.replace(pos, 3, ",");
+    }
+    int count = 0;
+    response.body = "[";
+    std::size_t begin = 0;
+    while (begin <= addresses.size()) {
+      auto end = addresses.find(',', begin);
+      if (end == std::string::npos) {
+        end = addresses.size();
+      }
+      if (count++ > 0) {
+        response.body += ",";
+      }
+      response.body += R"({"mint":")" + addresses.substr(begin, end - begin) + R"(","price":3.5})";
+      begin = end + 1;
+    }
+    response.body += "]";
+    for (int seen = largest_batch.load(); count > seen && !largest_batch.compare_exchange_weak(seen, count);) {
+    }
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setBatchQuoteEndpoint("/quotes/batch", 3);
+
+  std::vector<std::string> mints;
+  for (int i = 0; i < 7; ++i) {
+    mints.push_back("BATCH" + std::to_string(i));
+  }
+  mints.push_back("BATCH0");
+  const auto quotes = client.fetchTokenQuotes(mints);
+  if (quotes.size() != 7 || batch_requests.load() != 3 || largest_batch.load() > 3) {
+    std::cerr << "Batch fetch returned " << quotes.size() << " quotes from " << batch_requests.load()
+              << " requests" << std::endl;
+    return false;
+  }
+  for (int i = 0; i < 7; ++i) {
+    const auto it = quotes.find("BATCH" + std::to_string(i));
+    if (it == quotes.end() || std::abs(it->second.price - 3.5) > 1e-9) {
+      std::cerr << "Batch fetch missing quote for BATCH" << i << std::endl;
+      return false;
+    }
+  }
+
+  // Polls that fall due together are coalesced into batch requests.
+  batch_requests.store(0);
+  std::vector<std::atomic<int>> delivered(6);
+  std::vector<market_data::PumpFunClient::SubscriptionId> ids;
+  for (std::size_t i = 0; i < delivered.size(); ++i) {
+    ids.push_back(client.subscribeToQuotes(
+        "POLL" + std::to_string(i),
+        [&delivered, i](const market_data::TokenQuote&) { ++delivered[i]; },
+        std::chrono::milliseconds(100)));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(550));
+  for (const auto id : ids) {
+    client.unsubscribe(id);
+  }
+
+  int total = 0;
+  for (std::size_t i = 0; i < delivered.size(); ++i) {
+    if (delivered[i].load() < 2) {
+      std::cerr << "Batched poll starved POLL" << i << std::endl;
+      return false;
+    }
+    total += delivered[i].load();
+  }
+  if (single_requests.load() != 0 || batch_requests.load() * 2 > total) {
+    std::cerr << "Polls were not coalesced (" << batch_requests.load() << " batch requests, "
+              << single_requests.load() << " single requests for " << total << " quotes)"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+template <typename Predicate>
+bool WaitUntil(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::seconds(3)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+int CountStreamMessages(const testing::MockWebSocketServer& server,
+                        const std::string& method,
+                        const std::string& mint) {
+  int count = 0;
+  for (const auto& message : server.receivedMessages()) {
+    if (message.find("\"method\":\"" + method + "\"") != std::string::npos &&
+        message.find("\"" + mint + "\"") != std::string::npos) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+bool TestStreamingQuotes() {
+  testing::MockWebSocketServer server;
+  server.start();
+
+  market_data::PumpFunStreamClient::Options options;
+  options.initial_reconnect_delay = std::chrono::milliseconds(10);
+  options.max_keys_per_message = 2;
+  market_data::PumpFunStreamClient client(server.url("/stream"), "test-key", options);
+
+  std::mutex latest_mutex;
+  std::unordered_map<std::string, market_data::TokenQuote> latest;
+  const auto record = [&](const market_data::TokenQuote& quote) {
+    std::lock_guard<std::mutex> lock(latest_mutex);
+    latest[quote.mint] = quote;
+  };
+  const auto latest_for = [&](const std::string& mint) {
+    std::lock_guard<std::mutex> lock(latest_mutex);
+    return latest[mint];
+  };
+  std::atomic<int> shared_quotes{0};
+
+  const auto first_a = client.subscribeToQuotes("So11111111111111111111111111111111111111112", record);
+  client.subscribeToQuotes("EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v", record);
+  client.subscribeToQuotes("6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P", record);
+  const auto second_a = client.subscribeToQuotes(
+      "So11111111111111111111111111111111111111112", [&shared_quotes](const market_data::TokenQuote&) { ++shared_quotes; });
+  client.start();
+
+  const auto subscribed_once = [&](int times) {
+    return CountStreamMessages(server, "subscribe", "So11111111111111111111111111111111111111112") == times &&
+           CountStreamMessages(server, "subscribe", "EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v") == times &&
+           CountStreamMessages(server, "subscribe", "6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P") == times;
+  };
+  if (!WaitUntil([&]() { return subscribed_once(1); })) {
+    std::cerr << "Stream did not subscribe every mint exactly once" << std::endl;
+    return false;
+  }
+  if (server.receivedMessages().size() != 2) {
+    std::cerr << "Stream did not batch subscriptions by max_keys_per_message" << std::endl;
+    return false;
+  }
+
+  server.broadcast(R"({"channel":"quotes","data":{"mint":"So11111111111111111111111111111111111111112","price":1.25,"volume24h":900}})");
+  server.broadcast(
+      R"({"channel":"trades","data":[{"mint":"So11111111111111111111111111111111111111112","price":1.5,"timestamp":"2026-10-18T12:00:00.5Z"},{"mint":"EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v","price":2.0}]})");
+  const bool streamed = WaitUntil([&]() {
+    const auto a = latest_for("So11111111111111111111111111111111111111112");
+    return std::abs(a.price - 1.5) < 1e-9 && latest_for("EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v").price == 2.0 &&
+           shared_quotes.load() > 0;
+  });
+  const auto merged = latest_for("So11111111111111111111111111111111111111112");
+  if (!streamed || merged.volume_24h != 900 ||
+      merged.timestamp_ns != kNoonNs + kSecondNs / 2) {
+    std::cerr << "Trades were not merged into the streamed quote" << std::endl;
+    return false;
+  }
+
+  // A dropped connection reconnects and resubscribes every mint.
+  server.dropConnections();
+  if (!WaitUntil([&]() { return server.acceptedConnections() == 2 && subscribed_once(2); })) {
+    std::cerr << "Stream did not resubscribe after reconnecting" << std::endl;
+    return false;
+  }
+  server.broadcast(R"({"channel":"quotes","data":{"mint":"6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P","price":3.0}})");
+  if (!WaitUntil([&]() { return latest_for("6EF8rrecthR5Dkzon8Nwu78hRvfCKubJ14M5uBEwF6P").price == 3.0; })) {
+    std::cerr << "Stream did not deliver quotes after reconnecting" << std::endl;
+    return false;
+  }
+
+  // The wire subscription is only dropped with the last local subscriber.
+  client.unsubscribe(first_a);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  if (CountStreamMessages(server, "unsubscribe", "So11111111111111111111111111111111111111112") != 0) {
+    std::cerr << "Stream unsubscribed a mint that still had subscribers" << std::endl;
+    return false;
+  }
+  client.unsubscribe(second_a);
+  if (!WaitUntil([&]() { return CountStreamMessages(server, "unsubscribe", "So11111111111111111111111111111111111111112") == 1; })) {
+    std::cerr << "Stream did not unsubscribe the mint" << std::endl;
+    return false;
+  }
+  const int shared_before = shared_quotes.load();
+  server.broadcast(R"({"channel":"quotes","data":{"mint":"So11111111111111111111111111111111111111112","price":9.0}})");
+  server.broadcast(R"({"channel":"quotes","data":{"mint":"EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v","price":4.0}})");
+  if (!WaitUntil([&]() { return latest_for("EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v").price == 4.0; }) ||
+      latest_for("So11111111111111111111111111111111111111112").price != 1.5 || shared_quotes.load() != shared_before) {
+    std::cerr << "Quotes delivered after unsubscribe" << std::endl;
+    return false;
+  }
+
+  const auto stats = client.stats();
+  client.stop();
+  if (stats.connects != 2 || stats.reconnects != 1) {
+    std::cerr << "Unexpected stream connection stats" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestStreamingBackpressure() {
+  testing::MockWebSocketServer server;
+  server.start();
+  market_data::PumpFunStreamClient client(server.url());
+
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+  std::atomic<int> delivered{0};
+  std::atomic<double> last_price{0.0};
+  client.subscribeToQuotes("TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA", [&](const market_data::TokenQuote& quote) {
+    entered.store(true);
+    while (!release.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ++delivered;
+    last_price.store(quote.price);
+  });
+  client.start();
+
+  if (!WaitUntil([&]() { return CountStreamMessages(server, "subscribe", "TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA") == 1; })) {
+    std::cerr << "Stream did not subscribe" << std::endl;
+    return false;
+  }
+  server.broadcast(R"({"channel":"quotes","data":{"mint":"TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA","price":0.5}})");
+  if (!WaitUntil([&]() { return entered.load(); })) {
+    std::cerr << "Stream did not invoke the callback" << std::endl;
+    return false;
+  }
+
+  // The consumer is stuck; updates keep arriving and are conflated per mint.
+  constexpr int kUpdates = 1000;
+  for (int i = 1; i <= kUpdates; ++i) {
+    server.broadcast(R"({"channel":"quotes","data":{"mint":"TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA","price":)" + std::to_string(i) +
+                     "}}");
+  }
+  if (!WaitUntil([&]() { return client.stats().messages_received == kUpdates + 1; })) {
+    std::cerr << "Stream stopped reading while the consumer was blocked" << std::endl;
+    return false;
+  }
+  release.store(true);
+
+  if (!WaitUntil([&]() { return last_price.load() == kUpdates; })) {
+    std::cerr << "Slow consumer did not receive the latest quote" << std::endl;
+    return false;
+  }
+  const auto stats = client.stats();
+  client.stop();
+  if (delivered.load() > 3 || stats.quotes_conflated < kUpdates - 2) {
+    std::cerr << "Stream queued stale quotes instead of conflating them" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestAdaptivePolling() {
+  std::atomic<int> hot_polls{0};
+  std::atomic<int> idle_polls{0};
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    if (request.target.find("/HOT") != std::string::npos) {
+      // Moves 1% on every poll.
+      const int n = ++hot_polls;
+      response.body = R"({"mint":"HOT","price":)" + std::to_string(1.0 + 0.01 * n) + "}";
+    } else {
+      ++idle_polls;
+      response.body = R"({"mint":"IDLE","price":2.0,"volume24h":500})";
+    }
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  market_data::PumpFunClient::AdaptivePollingOptions options;
+  options.max_requests_per_second = 1000;
+  options.min_interval = std::chrono::milliseconds(20);
+  options.max_interval = std::chrono::milliseconds(400);
+  client.setAdaptivePolling(options);
+
+  const auto ignore = [](const market_data::TokenQuote&) {};
+  client.subscribeToQuotes("HOT", ignore, std::chrono::milliseconds(100));
+  client.subscribeToQuotes("IDLE", ignore, std::chrono::milliseconds(100));
+  if (client.pollInterval("HOT").count() != 100 || client.pollInterval("NONE").count() != 0) {
+    std::cerr << "Adaptive polls did not start at the requested interval" << std::endl;
+    return false;
+  }
+  // The moving mint speeds up; the quiet one doubles 100 -> 200 -> 400 ms.
+  if (!WaitUntil([&]() {
+        return client.pollInterval("HOT").count() == 20 && client.pollInterval("IDLE").count() == 400;
+      })) {
+    std::cerr << "Adaptive intervals were " << client.pollInterval("HOT").count() << " ms (hot) and "
+              << client.pollInterval("IDLE").count() << " ms (idle)" << std::endl;
+    return false;
+  }
+
+  // Demand settles at 50 + 2.5 polls/s; a budget of 10/s stretches both by 5.25
+  // (give or take the 10% drift tolerated before re-arming).
+  options.max_requests_per_second = 10;
+  client.setAdaptivePolling(options);
+  if (!WaitUntil([&]() {
+        const auto hot = client.pollInterval("HOT").count();
+        return hot >= 95 && hot <= 116 && client.pollInterval("IDLE").count() >= 1900;
+      })) {
+    std::cerr << "Hot poll was not stretched to the budget: " << client.pollInterval("HOT").count()
+              << " ms" << std::endl;
+    return false;
+  }
+  const int before = hot_polls.load() + idle_polls.load();
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  const int polled = hot_polls.load() + idle_polls.load() - before;
+  if (polled > 13) {
+    std::cerr << "Adaptive polling exceeded its budget: " << polled << " polls in 1 s" << std::endl;
+    return false;
+  }
+
+  // A boosted mint jumps to the fast end at once and shares the budget.
+  client.setPollingBoost("IDLE", true);
+  if (client.pollInterval("IDLE") > client.pollInterval("HOT") * 2) {
+    std::cerr << "Boosted poll did not speed up: " << client.pollInterval("IDLE").count() << " ms"
+              << std::endl;
+    return false;
+  }
+
+  client.setAdaptivePolling(std::nullopt);
+  if (client.pollInterval("HOT").count() != 100 || client.pollInterval("IDLE").count() != 100) {
+    std::cerr << "Disabling adaptive polling did not restore the requested intervals" << std::endl;
+    return false;
+  }
+
+  bool threw = false;
+  try {
+    options.max_interval = std::chrono::milliseconds(10);
+    client.setAdaptivePolling(options);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  client.stopAll();
+  if (!threw) {
+    std::cerr << "Inverted adaptive interval range was accepted" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestRequestCoalescing() {
+  constexpr int kCallers = 8;
+  std::atomic<int> upstream{0};
+  std::atomic<bool> fail{false};
+  market_data::PumpFunClient* self = nullptr;
+  market_data::PumpFunClient client(
+      "https://api.example.com",
+      {},
+      "/metadata",
+      "/quotes",
+      "/candles",
+      [&](const std::string&, const std::vector<std::pair<std::string, std::string>>&,
+          const std::unordered_map<std::string, std::string>&) -> std::string {
+        const int call = ++upstream;
+        // Hold the first request open until every other caller has joined it.
+        WaitUntil([&]() {
+          return self->coalescingStats().coalesced_requests >=
+                 static_cast<std::uint64_t>(kCallers - 1) * call;
+        });
+        if (fail.load()) {
+          throw std::runtime_error("upstream unavailable");
+        }
+        return R"({"mint":"HOT","price":4.2})";
+      });
+  self = &client;
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+
+  const auto burst = [&client]() {
+    std::atomic<int> succeeded{0};
+    std::atomic<int> failed{0};
+    std::vector<std::thread> callers;
+    for (int i = 0; i < kCallers; ++i) {
+      callers.emplace_back([&]() {
+        try {
+          if (client.fetchTokenQuote("HOT").mint == "HOT") {
+            ++succeeded;
+          }
+        } catch (const std::exception&) {
+          ++failed;
+        }
+      });
+    }
+    for (auto& caller : callers) {
+      caller.join();
+    }
+    return std::make_pair(succeeded.load(), failed.load());
+  };
+
+  const auto [succeeded, failed] = burst();
+  auto stats = client.coalescingStats();
+  if (succeeded != kCallers || upstream.load() != 1 || stats.upstream_requests != 1 ||
+      stats.coalesced_requests != kCallers - 1) {
+    std::cerr << "Concurrent quote fetches were not coalesced (" << upstream.load()
+              << " upstream calls, " << succeeded << " results)" << std::endl;
+    return false;
+  }
+
+  // A failure is shared with every waiter, and the key is free again afterwards.
+  fail.store(true);
+  const auto [after_success, after_failure] = burst();
+  stats = client.coalescingStats();
+  if (after_success != 0 || after_failure != kCallers || upstream.load() != 2 ||
+      stats.upstream_requests != 2) {
+    std::cerr << "Coalesced failure was not propagated (" << after_failure << " failures, "
+              << upstream.load() << " upstream calls)" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestResponseCache() {
+  std::atomic<int> metadata_requests{0};
+  std::atomic<int> not_modified{0};
+  std::atomic<int> quote_requests{0};
+  std::atomic<bool> upstream_down{false};
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    if (upstream_down.load()) {
+      response.status = 503;
+      return response;
+    }
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    if (request.target.rfind("/quotes/", 0) == 0) {
+      ++quote_requests;
+      response.body = R"({"mint":")" + mint + R"(","price":1.0})";
+      return response;
+    }
+    ++metadata_requests;
+    const auto validator = request.headers.find("if-none-match");
+    if (validator != request.headers.end() && validator->second == "\"v1\"") {
+      ++not_modified;
+      response.status = 304;
+      return response;
+    }
+    response.headers["ETag"] = "\"v1\"";
+    response.body = R"({"mint":")" + mint + R"(","name":"Cached","symbol":"CCH"})";
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  client.setCacheTtl("/metadata", std::chrono::milliseconds(60));
+
+  client.fetchTokenMetadata("CACHED");
+  const auto cached = client.fetchTokenMetadata("CACHED");
+  if (metadata_requests.load() != 1 || cached.symbol != "CCH" || client.cacheStats().hits != 1) {
+    std::cerr << "Fresh metadata was not served from the cache (" << metadata_requests.load()
+              << " requests)" << std::endl;
+    return false;
+  }
+
+  // Expired entries are revalidated with the ETag instead of refetched.
+  std::this_thread::sleep_for(std::chrono::milliseconds(80));
+  const auto revalidated = client.fetchTokenMetadata("CACHED");
+  if (not_modified.load() != 1 || revalidated.name != "Cached" ||
+      client.cacheStats().revalidations != 1) {
+    std::cerr << "Expired metadata was not revalidated with If-None-Match" << std::endl;
+    return false;
+  }
+
+  // Upstream errors fall back to the stale entry, but only within the window.
+  upstream_down.store(true);
+  std::this_thread::sleep_for(std::chrono::milliseconds(80));
+  try {
+    if (client.fetchTokenMetadata("CACHED").name != "Cached" ||
+        client.cacheStats().stale_served != 1) {
+      std::cerr << "Stale metadata was not served under an upstream error" << std::endl;
+      return false;
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << "Stale metadata fallback threw: " << ex.what() << std::endl;
+    return false;
+  }
+  client.setStaleIfError(std::chrono::milliseconds(0));
+  bool threw = false;
+  try {
+    client.fetchTokenMetadata("CACHED");
+  } catch (const std::exception&) {
+    threw = true;
+  }
+  if (!threw) {
+    std::cerr << "Stale metadata was served past the stale-if-error window" << std::endl;
+    return false;
+  }
+  upstream_down.store(false);
+
+  // Quotes are not cached by default.
+  client.fetchTokenQuote("CACHED");
+  client.fetchTokenQuote("CACHED");
+  if (quote_requests.load() != 2) {
+    std::cerr << "Quotes were unexpectedly cached" << std::endl;
+    return false;
+  }
+
+  // The byte budget evicts least recently used entries.
+  constexpr std::size_t kCapacity = 16 * 1024;
+  client.setCacheCapacity(kCapacity);
+  for (int i = 0; i < 200; ++i) {
+    client.fetchTokenMetadata("MINT" + std::to_string(i));
+  }
+  const auto stats = client.cacheStats();
+  if (stats.evictions == 0 || stats.bytes > kCapacity || stats.entries >= 200) {
+    std::cerr << "Cache exceeded its byte budget (" << stats.bytes << " bytes, " << stats.entries
+              << " entries)" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestRateLimiter() {
+  using market_data::RateLimiter;
+  using market_data::RequestPriority;
+
+  RateLimiter::Options options;
+  options.requests_per_second = 10.0;
+  options.burst = 2.0;
+  options.max_wait = {std::chrono::seconds(1), std::chrono::seconds(1), std::chrono::seconds(1),
+                      std::chrono::milliseconds(50)};
+  RateLimiter limiter(options);
+
+  // Held positions may drain the bucket; lower classes then queue or shed.
+  const auto first = limiter.tryAcquire(RequestPriority::HeldPosition);
+  const auto second = limiter.tryAcquire(RequestPriority::HeldPosition);
+  const auto watchlist = limiter.tryAcquire(RequestPriority::Watchlist);
+  const auto metadata = limiter.tryAcquire(RequestPriority::Metadata);
+  if (!first || first->count() != 0 || !second || second->count() != 0) {
+    std::cerr << "A full bucket did not grant held-position requests" << std::endl;
+    return false;
+  }
+  if (!watchlist || watchlist->count() < 100) {
+    std::cerr << "An empty bucket did not defer a watchlist request" << std::endl;
+    return false;
+  }
+  if (metadata || limiter.stats().shed[3] != 1) {
+    std::cerr << "A metadata request was not shed past its max_wait" << std::endl;
+    return false;
+  }
+
+  // A 429 pauses for Retry-After and halves the rate; successes restore it.
+  limiter.onRateLimited(std::chrono::milliseconds(300));
+  const auto paused = limiter.tryAcquire(RequestPriority::HeldPosition);
+  auto stats = limiter.stats();
+  if (!paused || paused->count() < 300 || stats.rate_limited_responses != 1 ||
+      std::abs(stats.requests_per_second - 5.0) > 1e-9) {
+    std::cerr << "A 429 did not pause the limiter and halve its rate" << std::endl;
+    return false;
+  }
+  limiter.onSuccess();
+  limiter.onSuccess();
+  if (std::abs(limiter.stats().requests_per_second - 6.0) > 1e-9) {
+    std::cerr << "Successes did not restore the rate (" << limiter.stats().requests_per_second
+              << "/s)" << std::endl;
+    return false;
+  }
+
+  if (RateLimiter::forKey("rate-limit-key", options) !=
+      RateLimiter::forKey("rate-limit-key", options)) {
+    std::cerr << "Clients of one key did not share a rate limiter" << std::endl;
+    return false;
+  }
+
+  // A 429 with Retry-After holds the client's next attempt back.
+  std::atomic<int> quote_requests{0};
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    if (request.target.rfind("/quotes/", 0) == 0 && ++quote_requests == 1) {
+      response.status = 429;
+      response.headers["Retry-After"] = "1";
+      return response;
+    }
+    response.body = R"({"mint":"LIMITED","price":1.0,"name":"Limited","symbol":"LIM"})";
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl(), "rate-limit-test");
+  client.setRetryPolicy(2, std::chrono::milliseconds(0));
+  RateLimiter::Options client_options;
+  client_options.requests_per_second = 100.0;
+  client_options.burst = 5.0;
+  client_options.max_wait[3] = std::chrono::milliseconds(0);
+  client.setRateLimit(client_options);
+
+  const auto started = std::chrono::steady_clock::now();
+  try {
+    client.fetchTokenQuote("LIMITED");
+  } catch (const std::exception& ex) {
+    std::cerr << "Rate-limited quote fetch threw: " << ex.what() << std::endl;
+    return false;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - started;
+  stats = client.rateLimiterStats();
+  if (quote_requests.load() != 2 || elapsed < std::chrono::milliseconds(900) ||
+      stats.rate_limited_responses != 1 || std::abs(stats.requests_per_second - 55.0) > 1e-9) {
+    std::cerr << "The client did not honour Retry-After (" << quote_requests.load()
+              << " requests, " << stats.requests_per_second << "/s)" << std::endl;
+    return false;
+  }
+
+  // Metadata may not dip into the reserve, so it is shed rather than queued.
+  client_options.requests_per_second = 1.0;
+  client_options.burst = 1.0;
+  client.setRateLimit(client_options);
+  bool shed = false;
+  try {
+    client.fetchTokenMetadata("LIMITED");
+    client.fetchTokenMetadata("LIMITED");
+  } catch (const market_data::RateLimitedError&) {
+    shed = true;
+  }
+  if (!shed) {
+    std::cerr << "A metadata fetch over the limit was not shed" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestCircuitBreaker() {
+  using market_data::CircuitBreaker;
+  using market_data::CircuitState;
+
+  CircuitBreaker::Options options;
+  options.failure_threshold = 2;
+  options.open_duration = std::chrono::milliseconds(50);
+  options.max_open_duration = std::chrono::milliseconds(200);
+  CircuitBreaker breaker("/quotes", options);
+
+  breaker.onFailure();
+  breaker.onFailure();
+  if (breaker.state() != CircuitState::Open || breaker.allowRequest() ||
+      breaker.stats().rejected_requests != 1) {
+    std::cerr << "Breaker did not open after consecutive failures" << std::endl;
+    return false;
+  }
+  // Half-open lets exactly one probe through; a failed probe doubles the wait.
+  // admits() only looks, leaving the probe for allowRequest.
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  if (!breaker.admits() || !breaker.admits() || breaker.state() != CircuitState::Open) {
+    std::cerr << "Breaker admits() claimed the probe" << std::endl;
+    return false;
+  }
+  if (!breaker.allowRequest() || breaker.state() != CircuitState::HalfOpen ||
+      breaker.allowRequest()) {
+    std::cerr << "Half-open breaker did not admit a single probe" << std::endl;
+    return false;
+  }
+  breaker.onFailure();
+  const auto reopened = breaker.stats();
+  if (reopened.state != CircuitState::Open || reopened.times_opened != 2 ||
+      reopened.retry_in <= std::chrono::milliseconds(50)) {
+    std::cerr << "A failed probe did not reopen the breaker for longer" << std::endl;
+    return false;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(110));
+  if (!breaker.allowRequest()) {
+    std::cerr << "Breaker did not half-open after its open period" << std::endl;
+    return false;
+  }
+  breaker.onSuccess();
+  if (breaker.state() != CircuitState::Closed || !breaker.allowRequest()) {
+    std::cerr << "A successful probe did not close the breaker" << std::endl;
+    return false;
+  }
+
+  // The client fails fast per endpoint while its breaker is open.
+  std::atomic<int> quote_calls{0};
+  std::atomic<bool> quotes_down{true};
+  market_data::PumpFunClient client(
+      "https://api.example.com",
+      {},
+      "/metadata",
+      "/quotes",
+      "/candles",
+      [&](const std::string& endpoint, const std::vector<std::pair<std::string, std::string>>&,
+          const std::unordered_map<std::string, std::string>&) -> std::string {
+        if (endpoint.rfind("/quotes/", 0) == 0) {
+          ++quote_calls;
+          if (quotes_down.load()) {
+            throw std::runtime_error("upstream unavailable");
+          }
+          return R"({"mint":"DOWN","price":1.0})";
+        }
+        return R"({"mint":"DOWN","name":"Down","symbol":"DWN"})";
+      });
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  options.failure_threshold = 3;
+  options.open_duration = std::chrono::milliseconds(100);
+  options.max_open_duration = std::chrono::seconds(1);
+  client.setCircuitBreaker(options);
+
+  bool fast_failed = false;
+  for (int i = 0; i < 4; ++i) {
+    try {
+      client.fetchTokenQuote(i % 2 == 0 ? "DOWN" : "ALSODOWN");
+    } catch (const market_data::CircuitOpenError&) {
+      fast_failed = i == 3;
+    } catch (const std::exception&) {
+    }
+  }
+  const auto stats = client.circuitBreakerStats();
+  const auto quotes = stats.find("https://api.example.com/quotes");
+  if (!fast_failed || quote_calls.load() != 3 || quotes == stats.end() ||
+      quotes->second.state != CircuitState::Open) {
+    std::cerr << "Quote breaker did not fail fast (" << quote_calls.load() << " upstream calls)"
+              << std::endl;
+    return false;
+  }
+  try {
+    client.fetchTokenMetadata("DOWN");
+  } catch (const std::exception& ex) {
+    std::cerr << "An open quote breaker blocked metadata: " << ex.what() << std::endl;
+    return false;
+  }
+
+  quotes_down.store(false);
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  try {
+    client.fetchTokenQuote("DOWN");
+  } catch (const std::exception& ex) {
+    std::cerr << "Probe after the open period failed: " << ex.what() << std::endl;
+    return false;
+  }
+  const auto closed = client.circuitBreakerStats().at("https://api.example.com/quotes");
+  if (closed.state != CircuitState::Closed) {
+    std::cerr << "Quote breaker did not close after a successful probe" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestBreakerProbeWaitsForRateLimit() {
+  std::atomic<bool> quotes_down{true};
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request&) {
+    testing::MockHttpServer::Response response;
+    if (quotes_down.load()) {
+      response.status = 503;
+    } else {
+      response.body = R"({"mint":"PROBE","price":2.0})";
+    }
+    return response;
+  });
+  server.start();
+
+  // One token every 400 ms, so the poll that follows the 300 ms open period
+  // is deferred by the limiter before it may probe.
+  market_data::PumpFunClient client(server.baseUrl(), "probe-deferral-key");
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  market_data::CircuitBreaker::Options breaker_options;
+  breaker_options.failure_threshold = 1;
+  breaker_options.open_duration = std::chrono::milliseconds(300);
+  client.setCircuitBreaker(breaker_options);
+  market_data::RateLimiter::Options limiter_options;
+  limiter_options.requests_per_second = 2.5;
+  limiter_options.burst = 1.0;
+  client.setRateLimit(limiter_options);
+  client.setPollingBoost("PROBE", true);
+
+  const auto tripped = std::chrono::steady_clock::now();
+  try {
+    client.fetchTokenQuote("PROBE");
+  } catch (const std::exception&) {
+  }
+  quotes_down.store(false);
+
+  std::atomic<bool> received{false};
+  std::atomic<long long> received_after_ms{0};
+  const auto id = client.subscribeToQuotes(
+      "PROBE",
+      [&](const market_data::TokenQuote&) {
+        if (!received.exchange(true)) {
+          received_after_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::steady_clock::now() - tripped)
+                                  .count();
+        }
+      },
+      std::chrono::milliseconds(20));
+  WaitUntil([&]() { return received.load(); }, std::chrono::seconds(2));
+  client.unsubscribe(id);
+
+  // A deferred poll that had already claimed the probe would refuse itself and
+  // leave the breaker half-open for another open period (until ~600 ms).
+  const auto breaker = client.circuitBreakerStats().at(server.baseUrl() + "/quotes");
+  if (!received.load() || received_after_ms.load() >= 520 ||
+      breaker.state != market_data::CircuitState::Closed) {
+    std::cerr << "Probe was held up by a rate-limit deferral (first quote after "
+              << received_after_ms.load() << " ms)" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestPollRetriesDoNotBlockWorkers() {
+  std::atomic<int> healthy_quotes{0};
+  market_data::PumpFunClient client(
+      "https://api.example.com",
+      {},
+      "/metadata",
+      "/quotes",
+      "/candles",
+      [](const std::string& endpoint, const std::vector<std::pair<std::string, std::string>>&,
+         const std::unordered_map<std::string, std::string>&) -> std::string {
+        if (endpoint == "/quotes/FLAKY") {
+          throw std::runtime_error("upstream unavailable");
+        }
+        return R"({"mint":"HEALTHY","price":1.0})";
+      });
+  // A worker sleeping through this backoff would starve the healthy mint.
+  client.setRetryPolicy(3, std::chrono::milliseconds(400));
+  client.setPollingConcurrency(1);
+
+  const auto flaky = client.subscribeToQuotes(
+      "FLAKY", [](const market_data::TokenQuote&) {}, std::chrono::milliseconds(20));
+  const auto healthy = client.subscribeToQuotes(
+      "HEALTHY", [&](const market_data::TokenQuote&) { ++healthy_quotes; },
+      std::chrono::milliseconds(20));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  client.unsubscribe(flaky);
+  client.unsubscribe(healthy);
+  if (healthy_quotes.load() < 5) {
+    std::cerr << "A retrying poll held up the worker pool (" << healthy_quotes.load()
+              << " healthy quotes)" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestProviderFailover() {
+  std::atomic<bool> primary_down{true};
+  std::atomic<int> primary_requests{0};
+  testing::MockHttpServer primary([&](const testing::MockHttpServer::Request& request) {
+    ++primary_requests;
+    testing::MockHttpServer::Response response;
+    if (primary_down.load()) {
+      response.status = 503;
+      return response;
+    }
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    response.body = R"({"mint":")" + mint + R"(","price":1.0})";
+    response.delay = std::chrono::milliseconds(40);
+    return response;
+  });
+  std::mutex fallback_mutex;
+  std::vector<std::string> fallback_targets;
+  std::vector<std::string> fallback_keys;
+  testing::MockHttpServer fallback([&](const testing::MockHttpServer::Request& request) {
+    {
+      std::lock_guard<std::mutex> lock(fallback_mutex);
+      fallback_targets.push_back(request.target);
+      const auto key = request.headers.find("x-api-key");
+      fallback_keys.push_back(key != request.headers.end() ? key->second : "");
+    }
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    testing::MockHttpServer::Response response;
+    response.body = R"({"mint":")" + mint + R"(","price":2.0})";
+    return response;
+  });
+  primary.start();
+  fallback.start();
+
+  market_data::PumpFunClient client(primary.baseUrl(), "primary-key");
+  client.setRetryPolicy(2, std::chrono::milliseconds(0));
+  market_data::PumpFunClient::ProviderConfig config;
+  config.name = "fallback";
+  config.base_url = fallback.baseUrl();
+  config.api_key = "fallback-key";
+  config.quote_endpoint = "/v2/price";
+  client.addProvider(config);
+
+  // The failed attempt moves to the fallback, in its layout and with its key.
+  market_data::TokenQuote quote;
+  try {
+    quote = client.fetchTokenQuote("FAILOVER");
+  } catch (const std::exception& ex) {
+    std::cerr << "Quote fetch did not fail over: " << ex.what() << std::endl;
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(fallback_mutex);
+    if (std::abs(quote.price - 2.0) > 1e-9 || fallback_targets.size() != 1 ||
+        fallback_targets.front() != "/v2/price/FAILOVER" || fallback_keys.front() != "fallback-key") {
+      std::cerr << "Failover request did not use the fallback's layout and key" << std::endl;
+      return false;
+    }
+  }
+  auto health = client.providerHealth();
+  if (health.size() != 2 || health[0].available || health[0].failures != 1 ||
+      health[1].name != "fallback" || health[1].requests != 1 || !health[1].available) {
+    std::cerr << "Provider health does not reflect the failover" << std::endl;
+    return false;
+  }
+
+  // While the primary backs off, requests and polls go straight to the fallback.
+  const int primary_before = primary_requests.load();
+  std::atomic<int> polled{0};
+  const auto id = client.subscribeToQuotes(
+      "POLLED",
+      [&](const market_data::TokenQuote& polled_quote) {
+        if (std::abs(polled_quote.price - 2.0) < 1e-9) {
+          ++polled;
+        }
+      },
+      std::chrono::milliseconds(20));
+  WaitUntil([&]() { return polled.load() >= 3; });
+  client.unsubscribe(id);
+  client.fetchTokenQuote("DIRECT");
+  if (polled.load() < 3 || primary_requests.load() != primary_before) {
+    std::cerr << "Requests reached a provider that is backing off (" << polled.load()
+              << " polled quotes)" << std::endl;
+    return false;
+  }
+
+  // With both healthy, traffic settles on the lower-latency provider.
+  primary_down.store(false);
+  market_data::PumpFunClient routed(primary.baseUrl());
+  routed.setRetryPolicy(1, std::chrono::milliseconds(0));
+  routed.addProvider(config);
+  const int routed_before = primary_requests.load();
+  for (int i = 0; i < 6; ++i) {
+    routed.fetchTokenQuote("ROUTED" + std::to_string(i));
+  }
+  health = routed.providerHealth();
+  if (primary_requests.load() - routed_before != 1 || health[1].requests != 5 ||
+      health[0].latency_ms <= health[1].latency_ms) {
+    std::cerr << "Requests were not routed to the faster provider ("
+              << primary_requests.load() - routed_before << " went to the slow one)" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestHedgedRequests() {
+  // The next stall_next requests answer after 600 ms, every other one at once.
+  std::atomic<int> stall_next{0};
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    testing::MockHttpServer::Response response;
+    response.body = R"({"mint":")" + mint + R"(","price":1.0})";
+    int stall = stall_next.load();
+    while (stall > 0 && !stall_next.compare_exchange_weak(stall, stall - 1)) {
+    }
+    if (stall > 0) {
+      response.delay = std::chrono::milliseconds(600);
+    }
+    return response;
+  });
+  server.start();
+
+  market_data::HedgePolicy::Options options;
+  options.window = 16;
+  options.min_samples = 5;
+  options.min_delay = std::chrono::milliseconds(20);
+  options.budget_ratio = 0.5;
+  options.max_budget = 1.0;
+  bool rejected = false;
+  try {
+    auto invalid = options;
+    invalid.min_samples = 32;
+    market_data::HedgePolicy policy(invalid);
+  } catch (const std::invalid_argument&) {
+    rejected = true;
+  }
+  if (!rejected) {
+    std::cerr << "HedgePolicy accepted more min_samples than its window holds" << std::endl;
+    return false;
+  }
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  client.setHedging(options);
+  client.setPollingBoost("HELD", true);
+  for (int i = 0; i < 5; ++i) {
+    client.fetchTokenQuote("HELD");
+  }
+  client.fetchTokenQuote("WATCHED");
+
+  // The stalled request is duplicated after the 20 ms floor and the
+  // duplicate's answer is taken.
+  stall_next.store(1);
+  auto started = std::chrono::steady_clock::now();
+  const auto hedged = client.fetchTokenQuote("HELD");
+  const auto hedged_elapsed = std::chrono::steady_clock::now() - started;
+  auto stats = client.hedgingStats()["/quotes"];
+  if (hedged.mint != "HELD" || hedged_elapsed > std::chrono::milliseconds(400) ||
+      stats.hedges_sent != 1 || stats.hedges_won != 1 ||
+      stats.delay != std::chrono::milliseconds(20)) {
+    std::cerr << "Slow held-position quote was not hedged (" << stats.hedges_sent << " sent, "
+              << stats.hedges_won << " won)" << std::endl;
+    return false;
+  }
+
+  // Half a hedge per request: the next slow request finds the budget spent.
+  stall_next.store(1);
+  started = std::chrono::steady_clock::now();
+  client.fetchTokenQuote("HELD");
+  stats = client.hedgingStats()["/quotes"];
+  if (std::chrono::steady_clock::now() - started < std::chrono::milliseconds(550) ||
+      stats.hedges_sent != 1 || stats.over_budget != 1 || stats.eligible_requests != 7) {
+    std::cerr << "Hedging exceeded its budget or hedged a watchlist quote ("
+              << stats.eligible_requests << " eligible requests)" << std::endl;
+    return false;
+  }
+
+  // Polls hedge from the event loop, so a stalled poll does not hold up the mint.
+  market_data::PumpFunClient polling(server.baseUrl());
+  options.min_samples = 3;
+  options.budget_ratio = 1.0;
+  polling.setHedging(options);
+  polling.setPollingBoost("POLLED", true);
+  std::atomic<int> delivered{0};
+  const auto id = polling.subscribeToQuotes(
+      "POLLED", [&](const market_data::TokenQuote&) { ++delivered; }, std::chrono::milliseconds(40));
+  if (!WaitUntil([&]() { return delivered.load() >= 5; })) {
+    std::cerr << "Hedged polling did not warm up" << std::endl;
+    return false;
+  }
+  stall_next.store(1);
+  const int before = delivered.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  const int during = delivered.load() - before;
+  polling.unsubscribe(id);
+  stats = polling.hedgingStats()["/quotes"];
+  if (stats.hedges_won < 1 || during < 3) {
+    std::cerr << "Stalled poll was not hedged (" << during << " quotes while stalled)"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestHttpMetrics() {
+  market_data::Histogram histogram;
+  for (std::uint64_t value = 1; value <= 1000; ++value) {
+    histogram.record(value);
+  }
+  const auto median = histogram.percentile(0.5);
+  if (histogram.count() != 1000 || histogram.max() != 1000 || median < 500 || median > 563 ||
+      histogram.percentile(1.0) != 1000 || std::abs(histogram.mean() - 500.5) > 1e-9) {
+    std::cerr << "Histogram percentiles are off (median " << median << ")" << std::endl;
+    return false;
+  }
+
+  const std::string body(2000, ' ');
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    if (request.target.rfind("/metadata/", 0) == 0) {
+      response.status = 404;
+      return response;
+    }
+    const std::string mint = request.target.substr(request.target.rfind('/') + 1);
+    response.body = R"({"mint":")" + mint + R"(","price":1.0})" + body;
+    if (mint == "SLOW") {
+      response.delay = std::chrono::milliseconds(60);
+    }
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  client.setSlowRequestThreshold(std::chrono::milliseconds(40));
+  for (int i = 0; i < 3; ++i) {
+    client.fetchTokenQuote("FAST");
+  }
+  client.fetchTokenQuote("SLOW");
+  try {
+    client.fetchTokenMetadata("MISSING");
+  } catch (const std::exception&) {
+  }
+  // Polls complete on the event loop and are timed there.
+  std::atomic<int> polled{0};
+  const auto id = client.subscribeToQuotes(
+      "POLLED", [&](const market_data::TokenQuote&) { ++polled; }, std::chrono::milliseconds(10));
+  WaitUntil([&]() { return polled.load() >= 2; });
+  client.unsubscribe(id);
+
+  auto metrics = client.httpMetrics();
+  const auto& quotes = metrics[server.baseUrl() + "/quotes"];
+  const auto& metadata = metrics[server.baseUrl() + "/metadata"];
+  const std::uint64_t quote_bytes = 2000 + std::string(R"({"mint":"FAST","price":1.0})").size();
+  if (quotes.requests < 6 || quotes.status_codes.at(200) != quotes.requests ||
+      quotes.slow_requests != 1 || quotes.total.max() < 60000 || quotes.first_byte.max() < 60000 ||
+      quotes.total.count() != quotes.requests || quotes.response_bytes.max() < quote_bytes ||
+      quotes.connect.count() != quotes.requests) {
+    std::cerr << "Quote metrics do not match the requests made (" << quotes.requests
+              << " requests, " << quotes.slow_requests << " slow)" << std::endl;
+    return false;
+  }
+  if (metadata.requests != 1 || metadata.status_codes.at(404) != 1) {
+    std::cerr << "Metadata 404 was not counted" << std::endl;
+    return false;
+  }
+
+  // Nothing listens on the stopped server's port, so the request never gets
+  // a response.
+  const std::string closed_url = server.baseUrl();
+  server.stop();
+  market_data::PumpFunClient unreachable(closed_url);
+  unreachable.setRetryPolicy(1, std::chrono::milliseconds(0));
+  try {
+    unreachable.fetchTokenQuote("FAST");
+  } catch (const std::exception&) {
+  }
+  metrics = unreachable.httpMetrics();
+  if (metrics[closed_url + "/quotes"].transport_errors != 1 ||
+      !metrics[closed_url + "/quotes"].status_codes.empty()) {
+    std::cerr << "Transport error was not counted" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestReceiveBuffer() {
+  testing::MockHttpServer server([](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    const auto size = std::stoul(request.target.substr(1));
+    response.body = std::string(size, 'x');
+    return response;
+  });
+  server.start();
+
+  CURL* handle = curl_easy_init();
+  market_data::ReceiveBuffer buffer;
+  const auto fetch = [&](std::size_t bytes) {
+    const std::string url = server.baseUrl() + "/" + std::to_string(bytes);
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    buffer.attach(handle);
+    return curl_easy_perform(handle) == CURLE_OK && buffer.data().size() == bytes;
+  };
+
+  // Presized from Content-Length rather than grown chunk by chunk, which
+  // would leave up to half the capacity unused.
+  const std::size_t large = 200'000;
+  const bool large_ok = fetch(large);
+  const std::size_t presized_slack = buffer.data().capacity() - buffer.data().size();
+  std::string body = buffer.take();
+  const char* storage = body.data();
+  buffer.recycle(std::move(body));
+  const bool small_ok = fetch(1000);
+  const bool reused = buffer.data().data() == storage;
+
+  // Oversized storage is dropped instead of pinned to the handle.
+  const bool huge_ok = fetch(market_data::ReceiveBuffer::kMaxRetainedBytes + 1);
+  buffer.recycle(buffer.take());
+  const bool released = buffer.data().capacity() <= market_data::ReceiveBuffer::kMaxRetainedBytes;
+  curl_easy_cleanup(handle);
+
+  if (!large_ok || !small_ok || !huge_ok || presized_slack > 1024 || !reused || !released) {
+    std::cerr << "Receive buffer was not presized or reused (slack " << presized_slack
+              << ", reused " << reused << ", released " << released << ")" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestMockPumpFunApi() {
+  testing::MockPumpFunApi::Options options;
+  options.latency = std::chrono::milliseconds(5);
+  testing::MockPumpFunApi synthetic(options);
+  testing::MockHttpServer server(synthetic.handler());
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  client.setBatchQuoteEndpoint("/quotes/batch");
+  const auto quote = client.fetchTokenQuote("MOCKMINT");
+  const auto quotes = client.fetchTokenQuotes({"MOCKA", "MOCKB", "MOCKC"});
+  const auto metadata = client.fetchTokenMetadata("MOCKMINT");
+  const auto candles = client.fetchHistoricalCandles("MOCKMINT", "5m", 12);
+  bool candles_ordered = candles.size() == 12;
+  for (std::size_t i = 1; candles_ordered && i < candles.size(); ++i) {
+    candles_ordered = candles[i].open_time_ns - candles[i - 1].open_time_ns == 300'000'000'000LL &&
+                      candles[i].low <= candles[i].high;
+  }
+  if (quote.mint != "MOCKMINT" || quote.price <= 0.0 || quote.timestamp_ns == 0 ||
+      quotes.size() != 3 || quotes.count("MOCKB") == 0 || metadata.mint != "MOCKMINT" ||
+      metadata.name.empty() || !candles_ordered) {
+    std::cerr << "Synthetic mock API payloads did not parse" << std::endl;
+    return false;
+  }
+
+  options.errorRate = 1.0;
+  testing::MockPumpFunApi failing(options);
+  testing::MockHttpServer failing_server(failing.handler());
+  failing_server.start();
+  market_data::PumpFunClient failing_client(failing_server.baseUrl());
+  failing_client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  bool threw = false;
+  try {
+    failing_client.fetchTokenQuote("MOCKMINT");
+  } catch (const std::exception&) {
+    threw = true;
+  }
+  if (!threw || failing.stats().injectedErrors != 1) {
+    std::cerr << "Mock API did not inject the configured error" << std::endl;
+    return false;
+  }
+
+  // Record responses from an upstream, then replay them with it gone.
+  std::atomic<int> keyed_requests{0};
+  testing::MockHttpServer upstream([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    const auto key = request.headers.find("x-api-key");
+    if (key != request.headers.end() && key->second == "recorded-key") {
+      ++keyed_requests;
+    }
+    response.body = R"({"mint":"RECORDED","price":2.5,"note":"line\nbreak \"quoted\""})";
+    return response;
+  });
+  upstream.start();
+
+  const std::string recording =
+      (std::filesystem::temp_directory_path() /
+       ("mock_pumpfun_api_test_" + std::to_string(::getpid()) + ".jsonl"))
+          .string();
+  std::remove(recording.c_str());
+  testing::MockPumpFunApi::Options record_options;
+  record_options.upstreamUrl = upstream.baseUrl();
+  record_options.recordFile = recording;
+  {
+    testing::MockPumpFunApi recorder(record_options);
+    testing::MockHttpServer recorder_server(recorder.handler());
+    recorder_server.start();
+    market_data::PumpFunClient recording_client(recorder_server.baseUrl(), "recorded-key");
+    recording_client.setRetryPolicy(1, std::chrono::milliseconds(0));
+    const auto recorded = recording_client.fetchTokenQuote("RECORDED");
+    if (recorded.price != 2.5 || recorder.stats().recorded != 1 || keyed_requests.load() != 1) {
+      std::cerr << "Mock API did not forward and record the upstream response" << std::endl;
+      std::remove(recording.c_str());
+      return false;
+    }
+  }
+  upstream.stop();
+
+  testing::MockPumpFunApi::Options replay_options;
+  replay_options.replayFile = recording;
+  testing::MockPumpFunApi replayer(replay_options);
+  std::remove(recording.c_str());
+  testing::MockHttpServer replay_server(replayer.handler());
+  replay_server.start();
+  market_data::PumpFunClient replay_client(replay_server.baseUrl());
+  replay_client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  const auto replayed = replay_client.fetchTokenQuote("RECORDED");
+  // Mints missing from the recording fall back to synthetic quotes.
+  const auto unrecorded = replay_client.fetchTokenQuote("UNRECORDED");
+  if (replayer.replayEntries() != 1 || replayed.price != 2.5 || replayed.mint != "RECORDED" ||
+      unrecorded.mint != "UNRECORDED" || replayer.stats().replayed != 1) {
+    std::cerr << "Mock API did not replay the recording" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Wraps data in a gzip member of stored (uncompressed) deflate blocks, which
+// libcurl decodes like any other gzip body.
+std::string GzipStored(const std::string& data) {
+  std::uint32_t crc = 0xFFFFFFFFu;
+  for (const unsigned char byte : data) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  crc ^= 0xFFFFFFFFu;
+
+  std::string out("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+  const auto append16 = [&out](std::size_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+  };
+  std::size_t offset = 0;
+  do {
+    const std::size_t length = std::min<std::size_t>(0xFFFF, data.size() - offset);
+    out.push_back(offset + length == data.size() ? 1 : 0);
+    append16(length);
+    append16(~length & 0xFFFF);
+    out.append(data, offset, length);
+    offset += length;
+  } while (offset < data.size());
+  append16(crc & 0xFFFF);
+  append16(crc >> 16);
+  append16(data.size() & 0xFFFF);
+  append16((data.size() >> 16) & 0xFFFF);
+  return out;
+}
+
+bool TestCandleStreaming() {
+  std::string body = "{\"result\":{\"data\":[";
+  const std::size_t count = 2000;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      body += ',';
+    }
+    body += "{\"time\":" + std::to_string(1700000000 + i * 60) + ",\"open\":" +
+            std::to_string(i) + ",\"high\":" + std::to_string(i + 2) +
+            ",\"low\":0.5,\"close\":" + std::to_string(i + 1) +
+            ",\"volume\":12.5,\"note\":\"a \\\"quoted\\\" [x]\"}";
+  }
+  body += "]},\"cursor\":\"next\"}";
+  const auto expected = market_data::parseCandlesResponse(body, "MINT", "1m");
+
+  // Candles come out as soon as they are complete, holding one at a time.
+  std::vector<market_data::HistoricalCandle> streamed;
+  market_data::CandleStreamParser parser(
+      "MINT", "1m", [&](market_data::HistoricalCandle&& candle) { streamed.push_back(candle); });
+  const std::size_t first_end = body.find('}') + 2;
+  parser.feed(std::string_view(body).substr(0, first_end));
+  const bool early = streamed.size() == 1;
+  std::size_t max_buffered = 0;
+  for (std::size_t offset = first_end; offset < body.size(); offset += 7) {
+    parser.feed(std::string_view(body).substr(offset, 7));
+    max_buffered = std::max(max_buffered, parser.bufferedBytes());
+  }
+  parser.finish();
+  bool same = streamed.size() == expected.size() && expected.size() == count;
+  for (std::size_t i = 0; same && i < count; ++i) {
+    same = streamed[i].mint == "MINT" && streamed[i].timeframe == "1m" &&
+           streamed[i].open_time_ns == expected[i].open_time_ns &&
+           streamed[i].close == expected[i].close && streamed[i].high == expected[i].high &&
+           streamed[i].volume == expected[i].volume;
+  }
+  if (!early || !same || max_buffered > 128) {
+    std::cerr << "Candle stream did not match the buffered parse (early " << early
+              << ", buffered " << max_buffered << ")" << std::endl;
+    return false;
+  }
+
+  // Shapes without a candle array parse as parseCandlesResponse would.
+  for (const std::string shape :
+       {"", "null", "{\"open\":3}", "{\"data\":null}", "{\"result\":{\"open\":4}}",
+        "[1,\"x\",{\"open\":5}]", "{\"data\":{\"x\":1},\"result\":[{\"open\":6}]}",
+        "{\"candles\":{\"open\":7}}"}) {
+    std::vector<market_data::HistoricalCandle> bytewise;
+    market_data::CandleStreamParser shape_parser(
+        "MINT", "1m", [&](market_data::HistoricalCandle&& candle) { bytewise.push_back(candle); });
+    for (const char c : shape) {
+      shape_parser.feed(std::string_view(&c, 1));
+    }
+    shape_parser.finish();
+    const auto whole = market_data::parseCandlesResponse(shape, "MINT", "1m");
+    bool matches = bytewise.size() == whole.size();
+    for (std::size_t i = 0; matches && i < whole.size(); ++i) {
+      matches = bytewise[i].open == whole[i].open;
+    }
+    if (!matches) {
+      std::cerr << "Candle stream mismatch for " << shape << std::endl;
+      return false;
+    }
+  }
+
+  for (const std::string malformed :
+       {"[{\"open\":1},{\"open\":", "[{\"open\":1}]x", "{\"data\":[}"}) {
+    market_data::CandleStreamParser bad("MINT", "1m", [](market_data::HistoricalCandle&&) {});
+    bool threw = false;
+    try {
+      bad.feed(malformed);
+      bad.finish();
+    } catch (const market_data::JsonParseError&) {
+      threw = true;
+    }
+    if (!threw) {
+      std::cerr << "Malformed candle stream was accepted: " << malformed << std::endl;
+      return false;
+    }
+  }
+
+  // Over cURL the body is negotiated gzip and decoded on the fly.
+  std::atomic<bool> accepted_gzip{false};
+  const std::string compressed = GzipStored(body);
+  testing::MockHttpServer server([&](const testing::MockHttpServer::Request& request) {
+    testing::MockHttpServer::Response response;
+    const auto encoding = request.headers.find("accept-encoding");
+    if (encoding != request.headers.end() && encoding->second.find("gzip") != std::string::npos) {
+      accepted_gzip = true;
+      response.headers["Content-Encoding"] = "gzip";
+      response.body = compressed;
+    } else {
+      response.body = body;
+    }
+    return response;
+  });
+  server.start();
+
+  market_data::PumpFunClient client(server.baseUrl());
+  client.setRetryPolicy(1, std::chrono::milliseconds(0));
+  std::size_t received = 0;
+  double last_close = 0.0;
+  const std::size_t delivered = client.streamHistoricalCandles(
+      "MINT", "1m", static_cast<int>(count), [&](market_data::HistoricalCandle&& candle) {
+        ++received;
+        last_close = candle.close;
+      });
+  const auto fetched = client.fetchHistoricalCandles("MINT", "1m", static_cast<int>(count));
+  if (!accepted_gzip || delivered != count || received != count ||
+      last_close != expected.back().close || fetched.size() != count) {
+    std::cerr << "Compressed candle response was not streamed (gzip " << accepted_gzip
+              << ", delivered " << delivered << ", fetched " << fetched.size() << ")"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  if (!TestUrlBuilder()) {
+    return 1;
+  }
+  if (!TestRetriesSucceed()) {
+    return 1;
+  }
+  if (!TestRetriesExhaust()) {
+    return 1;
+  }
+  if (!TestMetadataParsing()) {
+    return 1;
+  }
+  if (!TestTimestampParsing()) {
+    return 1;
+  }
+  if (!TestMintKey()) {
+    return 1;
+  }
+  if (!TestOnDemandParsing()) {
+    return 1;
+  }
+  if (!TestFieldLayoutCache()) {
+    return 1;
+  }
+  if (!TestConnectionReuse()) {
+    return 1;
+  }
+  if (!TestEventLoopSubscriptions()) {
+    return 1;
+  }
+  if (!TestSubscriptionsShareMintPoll()) {
+    return 1;
+  }
+  if (!TestBatchQuotes()) {
+    return 1;
+  }
+  if (!TestRequestCoalescing()) {
+    return 1;
+  }
+  if (!TestResponseCache()) {
+    return 1;
+  }
+  if (!TestStreamingQuotes()) {
+    return 1;
+  }
+  if (!TestStreamingBackpressure()) {
+    return 1;
+  }
+  if (!TestAdaptivePolling()) {
+    return 1;
+  }
+  if (!TestRateLimiter()) {
+    return 1;
+  }
+  if (!TestCircuitBreaker()) {
+    return 1;
+  }
+  if (!TestBreakerProbeWaitsForRateLimit()) {
+    return 1;
+  }
+  if (!TestPollRetriesDoNotBlockWorkers()) {
+    return 1;
+  }
+  if (!TestProviderFailover()) {
+    return 1;
+  }
+  if (!TestHedgedRequests()) {
+    return 1;
+  }
+  if (!TestHttpMetrics()) {
+    return 1;
+  }
+  if (!TestMockPumpFunApi()) {
+    return 1;
+  }
+  if (!TestReceiveBuffer()) {
+    return 1;
+  }
+  if (!TestCandleStreaming()) {
     return 1;
   }
   return 0;
@@ -1,13 +1,19 @@
+#include "trading/client_order_id_filter.h"
 #include "trading/engine.h"
+#include "trading/execution_algos.h"
+#include "trading/exit_trigger_book.h"
 #include "trading/pumpfun_bridge.h"
 
 #include "market_data/pumpfun_client.h"
 
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -93,6 +99,475 @@ bool TestExposureLimitUsesMarkPrice() {
                   "Engine accepted order despite mark-price derived exposure breach");
 }
 
+double PositionFor(const trading::RiskManagedEngine& engine, const std::string& symbol) {
+    const auto report = engine.status(symbol);
+    if (report.positions.empty()) {
+        return 0.0;
+    }
+    const auto& line = report.positions.front();
+    return std::stod(line.substr(line.find(':') + 1));
+}
+
+bool TestStopLossTriggerExitsPosition() {
+    trading::RiskManagedEngine engine;
+    engine.start();
+    engine.updateMarkPrice("COIN", 1.0);
+
+    trading::OrderRequest entry;
+    entry.symbol = "COIN";
+    entry.quantity = 10.0;
+    engine.buy(entry);
+    if (!WaitForCondition([&engine]() { return PositionFor(engine, "COIN") > 9.0; },
+                          std::chrono::milliseconds(500))) {
+        engine.stop();
+        return Expect(false, "Entry order never filled");
+    }
+
+    trading::ExitTriggerRequest stop;
+    stop.symbol = "COIN";
+    stop.type = trading::ExitTriggerType::StopLoss;
+    stop.quantity = 10.0;
+    stop.triggerPrice = 0.8;
+    const auto stopReceipt = engine.attachExitTrigger(stop);
+
+    trading::ExitTriggerRequest take = stop;
+    take.type = trading::ExitTriggerType::TakeProfit;
+    take.triggerPrice = 1.5;
+    const auto takeReceipt = engine.attachExitTrigger(take);
+
+    if (!Expect(stopReceipt.success && takeReceipt.success, "Engine refused to arm exit triggers")) {
+        engine.stop();
+        return false;
+    }
+
+    engine.updateMarkPrice("COIN", 0.9);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    if (!Expect(PositionFor(engine, "COIN") > 9.0, "Stop-loss fired above its trigger price")) {
+        engine.stop();
+        return false;
+    }
+
+    engine.updateMarkPrice("COIN", 0.75);
+    const bool exited = WaitForCondition(
+        [&engine]() { return std::abs(PositionFor(engine, "COIN")) < 1e-9; },
+        std::chrono::milliseconds(500));
+
+    // The take-profit is still armed but must not sell a position that is gone.
+    engine.updateMarkPrice("COIN", 2.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    const double finalPosition = PositionFor(engine, "COIN");
+    engine.stop();
+
+    return Expect(exited, "Stop-loss did not flatten the position") &&
+           Expect(std::abs(finalPosition) < 1e-9, "Take-profit sold beyond the open position");
+}
+
+bool TestStopLossLeavesRoomForRestingSells() {
+    trading::RiskManagedEngine engine;
+    engine.start();
+    engine.updateMarkPrice("COIN", 1.0);
+
+    trading::OrderRequest entry;
+    entry.symbol = "COIN";
+    entry.quantity = 10.0;
+    engine.buy(entry);
+    if (!WaitForCondition([&engine]() { return PositionFor(engine, "COIN") > 9.0; },
+                          std::chrono::milliseconds(500))) {
+        engine.stop();
+        return Expect(false, "Entry order never filled");
+    }
+
+    trading::OrderRequest target;
+    target.symbol = "COIN";
+    target.quantity = 6.0;
+    target.limitPrice = 1.5;
+    target.timeInForce = trading::TimeInForce::GoodTillCancel;
+    const auto targetReceipt = engine.sell(target);
+
+    trading::ExitTriggerRequest stop;
+    stop.symbol = "COIN";
+    stop.type = trading::ExitTriggerType::StopLoss;
+    stop.quantity = 10.0;
+    stop.triggerPrice = 0.8;
+    const auto stopReceipt = engine.attachExitTrigger(stop);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (!Expect(targetReceipt.success && stopReceipt.success, "Engine refused the exit orders")) {
+        engine.stop();
+        return false;
+    }
+
+    // The stop sells only what the resting limit sell leaves over.
+    engine.updateMarkPrice("COIN", 0.75);
+    const bool stopped = WaitForCondition(
+        [&engine]() { return std::abs(PositionFor(engine, "COIN") - 6.0) < 1e-9; },
+        std::chrono::milliseconds(500));
+
+    engine.updateMarkPrice("COIN", 2.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    const double finalPosition = PositionFor(engine, "COIN");
+    engine.stop();
+
+    return Expect(stopped, "Stop-loss did not leave the resting sell's quantity") &&
+           Expect(finalPosition > -1e-9, "Stop-loss and resting sell flipped the position short");
+}
+
+bool TestTrailingStopRatchets() {
+    trading::ExitTriggerBook book;
+
+    trading::ExitTriggerBook::Trigger early;
+    early.triggerId = "TRG-1";
+    early.symbol = "COIN";
+    early.type = trading::ExitTriggerType::TrailingStop;
+    early.quantity = 1.0;
+    early.trailingOffset = 2.0;
+    book.add(early, 10.0);
+
+    if (!Expect(book.onMarkPrice("COIN", 12.0).empty(), "Trailing stop fired on a rising mark")) {
+        return false;
+    }
+
+    auto late = early;
+    late.triggerId = "TRG-2";
+    late.trailingOffset = 5.0;
+    book.add(late, 12.0);
+
+    book.onMarkPrice("COIN", 15.0);
+    // High-water is now 15: TRG-1 stops at 13, TRG-2 at 10.
+    auto fired = book.onMarkPrice("COIN", 12.5);
+    if (!Expect(fired.size() == 1 && fired.front().trigger.triggerId == "TRG-1",
+                "Trailing stop did not ratchet with the high-water mark")) {
+        return false;
+    }
+    if (!Expect(std::abs(fired.front().stopLevel - 13.0) < 1e-9, "Unexpected trailing stop level")) {
+        return false;
+    }
+
+    if (!Expect(book.remove("TRG-2") && book.size() == 0, "Failed to cancel trailing stop")) {
+        return false;
+    }
+    return Expect(book.onMarkPrice("COIN", 1.0).empty(), "Cancelled trailing stop still fired");
+}
+
+bool TestTrailingStopsAcrossBuckets() {
+    trading::ExitTriggerBook book;
+
+    trading::ExitTriggerBook::Trigger base;
+    base.symbol = "COIN";
+    base.type = trading::ExitTriggerType::TrailingStop;
+    base.quantity = 1.0;
+
+    const auto addTrailing = [&](const std::string& id, double offset, double highWater) {
+        auto trigger = base;
+        trigger.triggerId = id;
+        trigger.trailingOffset = offset;
+        book.add(trigger, highWater);
+    };
+    // Separate high-water buckets whose stops are not ordered by high-water.
+    addTrailing("TRG-A", 1.0, 20.0);  // stop 19
+    addTrailing("TRG-B", 2.0, 25.0);  // stop 23
+    addTrailing("TRG-C", 6.0, 25.0);  // stop 19
+    addTrailing("TRG-D", 15.0, 30.0);  // stop 15
+
+    // TRG-A ratchets to 22 (stop 21); only TRG-B is reached.
+    auto fired = book.onMarkPrice("COIN", 22.0);
+    if (!Expect(fired.size() == 1 && fired.front().trigger.triggerId == "TRG-B" &&
+                    std::abs(fired.front().stopLevel - 23.0) < 1e-9,
+                "Trailing stops fired out of stop-level order")) {
+        return false;
+    }
+
+    if (!Expect(book.remove("TRG-D") && book.size("COIN") == 2, "Failed to cancel trailing stop")) {
+        return false;
+    }
+
+    fired = book.onMarkPrice("COIN", 20.5);
+    if (!Expect(fired.size() == 1 && fired.front().trigger.triggerId == "TRG-A" &&
+                    std::abs(fired.front().stopLevel - 21.0) < 1e-9,
+                "Ratcheted trailing stop did not fire at its new level")) {
+        return false;
+    }
+
+    fired = book.onMarkPrice("COIN", 19.0);
+    if (!Expect(fired.size() == 1 && fired.front().trigger.triggerId == "TRG-C",
+                "Remaining offset in a partly fired bucket did not fire")) {
+        return false;
+    }
+    return Expect(book.size() == 0, "Trailing stops left behind after firing");
+}
+
+bool TestTimeInForceAgainstMark() {
+    trading::RiskLimits limits;
+    limits.maxPosition = 5.0;
+    trading::RiskManagedEngine engine(limits);
+    engine.start();
+    engine.updateMarkPrice("COIN", 1.0);
+
+    trading::OrderRequest ioc;
+    ioc.symbol = "COIN";
+    ioc.quantity = 3.0;
+    ioc.limitPrice = 0.5;
+    ioc.timeInForce = trading::TimeInForce::ImmediateOrCancel;
+    const auto iocReceipt = engine.buy(ioc);
+
+    trading::OrderRequest gtc = ioc;
+    gtc.quantity = 2.0;
+    gtc.timeInForce = trading::TimeInForce::GoodTillCancel;
+    const auto gtcReceipt = engine.buy(gtc);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    if (!Expect(iocReceipt.success && gtcReceipt.success, "Engine refused limit orders") ||
+        !Expect(std::abs(PositionFor(engine, "COIN")) < 1e-9,
+                "Non-marketable limit order executed at a stale price") ||
+        !Expect(!engine.cancelOrder(iocReceipt.orderId).success,
+                "IOC order stayed open after missing the market")) {
+        engine.stop();
+        return false;
+    }
+
+    // The resting GTC order fills once the mark crosses its limit.
+    engine.updateMarkPrice("COIN", 0.45);
+    if (!WaitForCondition([&engine]() { return PositionFor(engine, "COIN") > 1.9; },
+                          std::chrono::milliseconds(500))) {
+        engine.stop();
+        return Expect(false, "Resting GTC order did not fill when the mark crossed");
+    }
+
+    // IOC fills up to the position limit; FOK refuses the same partial.
+    trading::OrderRequest fok;
+    fok.symbol = "COIN";
+    fok.quantity = 4.0;
+    fok.timeInForce = trading::TimeInForce::FillOrKill;
+    const auto fokReceipt = engine.buy(fok);
+
+    trading::OrderRequest partial = fok;
+    partial.timeInForce = trading::TimeInForce::ImmediateOrCancel;
+    const auto partialReceipt = engine.buy(partial);
+
+    const bool filledToLimit = WaitForCondition(
+        [&engine]() { return std::abs(PositionFor(engine, "COIN") - 5.0) < 1e-9; },
+        std::chrono::milliseconds(500));
+    engine.stop();
+
+    return Expect(!fokReceipt.success, "FOK order accepted beyond the position limit") &&
+           Expect(partialReceipt.success, "IOC order rejected despite position headroom") &&
+           Expect(filledToLimit, "IOC order did not fill up to the position limit");
+}
+
+bool TestGoodTillTimeExpiryCancelAndReplace() {
+    trading::RiskManagedEngine engine;
+    engine.start();
+    engine.updateMarkPrice("COIN", 1.0);
+
+    std::mutex updatesMutex;
+    std::vector<trading::TradeUpdate> updates;
+    engine.subscribeToTradeUpdates([&](const trading::TradeUpdate& update) {
+        std::lock_guard<std::mutex> lock(updatesMutex);
+        updates.push_back(update);
+    });
+    const auto sawUpdate = [&](const std::string& orderId, const std::string& text) {
+        std::lock_guard<std::mutex> lock(updatesMutex);
+        for (const auto& update : updates) {
+            if (update.orderId == orderId && update.message.find(text) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    trading::OrderRequest gtt;
+    gtt.symbol = "COIN";
+    gtt.quantity = 1.0;
+    gtt.limitPrice = 0.5;
+    gtt.timeInForce = trading::TimeInForce::GoodTillTime;
+    if (!Expect(!engine.buy(gtt).success, "GTT order accepted without an expiry")) {
+        engine.stop();
+        return false;
+    }
+    gtt.goodTill = std::chrono::system_clock::now() + std::chrono::milliseconds(50);
+    const auto gttReceipt = engine.buy(gtt);
+
+    if (!Expect(gttReceipt.success, "Engine refused a GTT order") ||
+        !Expect(WaitForCondition([&]() { return sawUpdate(gttReceipt.orderId, "expired"); },
+                                 std::chrono::milliseconds(500)),
+                "GTT order did not expire")) {
+        engine.stop();
+        return false;
+    }
+
+    trading::OrderRequest cancelled;
+    cancelled.symbol = "COIN";
+    cancelled.quantity = 1.0;
+    cancelled.limitPrice = 0.3;
+    const auto cancelledReceipt = engine.buy(cancelled);
+
+    trading::OrderRequest replaced = cancelled;
+    replaced.limitPrice = 0.5;
+    const auto replacedReceipt = engine.buy(replaced);
+
+    if (!WaitForCondition([&]() { return sawUpdate(replacedReceipt.orderId, "resting"); },
+                          std::chrono::milliseconds(500))) {
+        engine.stop();
+        return Expect(false, "Non-marketable GTC order did not rest");
+    }
+
+    const bool cancelledOnce = engine.cancelOrder(cancelledReceipt.orderId).success;
+    const bool cancelledTwice = engine.cancelOrder(cancelledReceipt.orderId).success;
+
+    // Lifting the limit through the mark makes the resting order marketable.
+    replaced.limitPrice = 1.2;
+    const auto replaceReceipt = engine.replaceOrder(replacedReceipt.orderId, replaced);
+    const bool filled = WaitForCondition(
+        [&engine]() { return std::abs(PositionFor(engine, "COIN") - 1.0) < 1e-9; },
+        std::chrono::milliseconds(500));
+
+    // Neither the expired nor the cancelled order may fill on a later drop.
+    engine.updateMarkPrice("COIN", 0.1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    const double finalPosition = PositionFor(engine, "COIN");
+    engine.stop();
+
+    return Expect(cancelledOnce && !cancelledTwice, "Cancel did not remove the open order once") &&
+           Expect(replaceReceipt.success, "Replace of a resting order failed") &&
+           Expect(filled, "Replaced order did not execute") &&
+           Expect(std::abs(finalPosition - 1.0) < 1e-9, "Expired or cancelled order executed");
+}
+
+bool TestClientOrderIdFilterIsBounded() {
+    using Clock = trading::ClientOrderIdFilter::Clock;
+    trading::ClientOrderIdFilter filter(std::chrono::seconds(10), 3);
+    const auto start = Clock::now();
+
+    if (!Expect(filter.insert("a", start) && !filter.insert("a", start),
+                "Filter did not reject a repeated id")) {
+        return false;
+    }
+    if (!Expect(filter.insert("a", start + std::chrono::seconds(11)),
+                "Filter kept an id beyond its window")) {
+        return false;
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        filter.insert("id-" + std::to_string(i), start + std::chrono::seconds(12));
+    }
+    return Expect(filter.size() == 3, "Filter grew beyond its capacity") &&
+           Expect(!filter.insert("id-99", start + std::chrono::seconds(12)),
+                  "Filter forgot the most recent id first");
+}
+
+bool TestDuplicateClientOrderIdRejected() {
+    trading::RiskLimits limits;
+    limits.maxPosition = 5.0;
+    trading::RiskManagedEngine engine(limits);
+    engine.start();
+
+    trading::OrderRequest request;
+    request.symbol = "COIN";
+    request.quantity = 2.0;
+    request.clientOrderId = "tg-42-7";
+    const auto first = engine.buy(request);
+    const auto retry = engine.buy(request);
+
+    // A risk-rejected order must not burn its client id.
+    trading::OrderRequest oversized = request;
+    oversized.quantity = 10.0;
+    oversized.clientOrderId = "tg-42-8";
+    const auto rejected = engine.buy(oversized);
+    oversized.quantity = 1.0;
+    const auto resubmitted = engine.buy(oversized);
+
+    const bool filled = WaitForCondition(
+        [&engine]() { return std::abs(PositionFor(engine, "COIN") - 3.0) < 1e-9; },
+        std::chrono::milliseconds(500));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const double finalPosition = PositionFor(engine, "COIN");
+    engine.stop();
+
+    return Expect(first.success, "Engine refused an order with a client id") &&
+           Expect(!retry.success, "Engine accepted a duplicate client order id") &&
+           Expect(!rejected.success && resubmitted.success,
+                  "Risk rejection consumed the client order id") &&
+           Expect(filled && std::abs(finalPosition - 3.0) < 1e-9,
+                  "Duplicate order was routed");
+}
+
+bool TestTwapSlicesParentOrder() {
+    trading::RiskManagedEngine engine;
+    engine.start();
+    engine.updateMarkPrice("COIN", 1.0);
+
+    trading::ExecutionAlgoEngine algos(engine);
+    algos.start();
+
+    trading::ParentOrderRequest request;
+    request.symbol = "COIN";
+    request.quantity = 8.0;
+    request.algo = trading::ExecutionAlgoType::Twap;
+    request.duration = std::chrono::milliseconds(200);
+    request.sliceInterval = std::chrono::milliseconds(50);
+    const auto accepted = algos.submit(request);
+    if (!Expect(accepted.state == trading::ParentOrderState::Working, "TWAP parent was not accepted")) {
+        algos.stop();
+        engine.stop();
+        return false;
+    }
+
+    const bool completed = WaitForCondition(
+        [&]() {
+            const auto status = algos.parentStatus(accepted.parentId);
+            return status && status->state == trading::ParentOrderState::Completed;
+        },
+        std::chrono::milliseconds(1500));
+    const auto status = algos.parentStatus(accepted.parentId);
+    const double position = PositionFor(engine, "COIN");
+
+    algos.stop();
+    engine.stop();
+
+    return Expect(completed, "TWAP parent did not complete") &&
+           Expect(status && status->childOrders == 4, "TWAP did not slice into four children") &&
+           Expect(std::abs(position - 8.0) < 1e-9, "TWAP children did not build the full position");
+}
+
+bool TestParticipationFollowsVolume() {
+    trading::RiskManagedEngine engine;
+    engine.start();
+    engine.updateMarkPrice("COIN", 2.0);
+
+    trading::ExecutionAlgoEngine algos(engine);
+    algos.start();
+    algos.updateMarketData("COIN", 2.0, 1000.0);
+
+    trading::ParentOrderRequest request;
+    request.symbol = "COIN";
+    request.quantity = 100.0;
+    request.algo = trading::ExecutionAlgoType::Participation;
+    request.participationRate = 0.5;
+    request.duration = std::chrono::milliseconds(120);
+    request.sliceInterval = std::chrono::milliseconds(40);
+    const auto accepted = algos.submit(request);
+
+    // 40 quote units trade at 2.0 between samples: a 50% participation slice is 10.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    algos.updateMarketData("COIN", 2.0, 1040.0);
+
+    const bool expired = WaitForCondition(
+        [&]() {
+            const auto status = algos.parentStatus(accepted.parentId);
+            return status && status->state == trading::ParentOrderState::Expired;
+        },
+        std::chrono::milliseconds(1000));
+    WaitForCondition([&engine]() { return PositionFor(engine, "COIN") > 0.0; },
+                     std::chrono::milliseconds(500));
+    const auto status = algos.parentStatus(accepted.parentId);
+
+    algos.stop();
+    engine.stop();
+
+    return Expect(expired, "Participation parent did not expire at the end of its window") &&
+           Expect(status && std::abs(status->submittedQuantity - 10.0) < 1e-9,
+                  "Participation slice did not track observed volume");
+}
+
 bool TestPumpFunBridgePropagatesMarkPrice() {
     std::atomic<int> fetch_count{0};
 
@@ -155,6 +630,36 @@ int main() {
     if (!TestExposureLimitUsesMarkPrice()) {
         return 1;
     }
+    if (!TestStopLossTriggerExitsPosition()) {
+        return 1;
+    }
+    if (!TestStopLossLeavesRoomForRestingSells()) {
+        return 1;
+    }
+    if (!TestTrailingStopRatchets()) {
+        return 1;
+    }
+    if (!TestTrailingStopsAcrossBuckets()) {
+        return 1;
+    }
+    if (!TestTimeInForceAgainstMark()) {
+        return 1;
+    }
+    if (!TestGoodTillTimeExpiryCancelAndReplace()) {
+        return 1;
+    }
+    if (!TestClientOrderIdFilterIsBounded()) {
+        return 1;
+    }
+    if (!TestDuplicateClientOrderIdRejected()) {
+        return 1;
+    }
+    if (!TestTwapSlicesParentOrder()) {
+        return 1;
+    }
+    if (!TestParticipationFollowsVolume()) {
+        return 1;
+    }
     if (!TestPumpFunBridgePropagatesMarkPrice()) {
         return 1;
     }